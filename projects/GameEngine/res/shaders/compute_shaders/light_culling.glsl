@@ -0,0 +1,107 @@
+#version 440
+
+// Bins our lights into screen space tiles, so that light accumulation only has to
+// consider the lights that can actually affect each pixel. One work group handles one
+// tile, first finding the depth range of the tile, then testing each light against
+// the view space box that the tile covers
+
+#include "../fragments/tiled_lights.glsl"
+
+layout(local_size_x = TILE_SIZE, local_size_y = TILE_SIZE, local_size_z = 1) in;
+
+uniform layout(binding=0) sampler2D s_Depth;
+
+// The number of lights in b_Lights
+uniform uint  u_LightCount;
+// The bottom left corner of the viewport in the G-Buffer, in pixels
+uniform ivec2 u_ViewportOffset;
+// The size of the viewport in pixels
+uniform ivec2 u_ViewportSize;
+// The index of the first tile for this viewport in b_TileLights
+uniform uint  u_TileOffset;
+// Inverse of the camera's projection, for going from NDC back to view space
+uniform mat4  u_InverseProjection;
+
+shared uint s_MinDepth;
+shared uint s_MaxDepth;
+shared uint s_TileLightCount;
+shared vec3 s_TileMin;
+shared vec3 s_TileMax;
+
+// Converts a point in NDC (with depth in [0, 1]) to view space
+vec3 Unproject(vec2 ndc, float depth) {
+	vec4 pos = u_InverseProjection * vec4(ndc, depth * 2.0 - 1.0, 1.0);
+	return pos.xyz / pos.w;
+}
+
+void main() {
+	ivec2 pixel = ivec2(gl_GlobalInvocationID.xy);
+
+	if (gl_LocalInvocationIndex == 0) {
+		s_MinDepth = 0xFFFFFFFFu;
+		s_MaxDepth = 0;
+		s_TileLightCount = 0;
+	}
+	barrier();
+
+	// Find the depth range of the tile, ignoring the background. Depth is always positive,
+	// so the bit patterns compare the same as the floats do
+	if (all(lessThan(pixel, u_ViewportSize))) {
+		float depth = texelFetch(s_Depth, u_ViewportOffset + pixel, 0).r;
+		if (depth < 1.0) {
+			uint depthBits = floatBitsToUint(depth);
+			atomicMin(s_MinDepth, depthBits);
+			atomicMax(s_MaxDepth, depthBits);
+		}
+	}
+	barrier();
+
+	// Tiles that are all background don't need any lights
+	bool isEmpty = s_MinDepth > s_MaxDepth;
+
+	// Build the view space bounding box of the tile from its 8 corners, this works
+	// for both perspective and orthographic cameras
+	if (gl_LocalInvocationIndex == 0 && !isEmpty) {
+		vec2 ndcMin = vec2(gl_WorkGroupID.xy * TILE_SIZE) / vec2(u_ViewportSize) * 2.0 - 1.0;
+		vec2 ndcMax = min(vec2((gl_WorkGroupID.xy + 1) * TILE_SIZE) / vec2(u_ViewportSize), vec2(1.0)) * 2.0 - 1.0;
+		float minDepth = uintBitsToFloat(s_MinDepth);
+		float maxDepth = uintBitsToFloat(s_MaxDepth);
+
+		vec3 boxMin = vec3( 3.402823e38);
+		vec3 boxMax = vec3(-3.402823e38);
+		for (int ix = 0; ix < 8; ix++) {
+			vec2  ndc   = vec2((ix & 1) != 0 ? ndcMax.x : ndcMin.x, (ix & 2) != 0 ? ndcMax.y : ndcMin.y);
+			vec3  corner = Unproject(ndc, (ix & 4) != 0 ? maxDepth : minDepth);
+			boxMin = min(boxMin, corner);
+			boxMax = max(boxMax, corner);
+		}
+		s_TileMin = boxMin;
+		s_TileMax = boxMax;
+	}
+	barrier();
+
+	uint tileIndex = u_TileOffset + gl_WorkGroupID.y * gl_NumWorkGroups.x + gl_WorkGroupID.x;
+	uint tileStart = tileIndex * MAX_LIGHTS_PER_TILE;
+
+	// Every thread in the group tests a different subset of the lights
+	if (!isEmpty) {
+		for (uint ix = gl_LocalInvocationIndex; ix < u_LightCount; ix += TILE_SIZE * TILE_SIZE) {
+			vec3  center = Lights[ix].PositionRange.xyz;
+			float range  = Lights[ix].PositionRange.w;
+
+			// Sphere vs box, using the closest point in the box to the light
+			vec3 delta = clamp(center, s_TileMin, s_TileMax) - center;
+			if (dot(delta, delta) <= range * range) {
+				uint slot = atomicAdd(s_TileLightCount, 1);
+				if (slot < MAX_LIGHTS_PER_TILE - 1) {
+					TileLights[tileStart + 1 + slot] = ix;
+				}
+			}
+		}
+	}
+	barrier();
+
+	if (gl_LocalInvocationIndex == 0) {
+		TileLights[tileStart] = min(s_TileLightCount, uint(MAX_LIGHTS_PER_TILE - 1));
+	}
+}
@@ -5,9 +5,10 @@
 
 // We output a single color to the color buffer
 layout(location = 0) out vec4 albedo_specPower;
+// Octahedral normal in rg, metallic in b, emissive strength in a
 layout(location = 1) out vec4 normal_metallic;
-layout(location = 2) out vec4 emissive;
-layout(location = 3) out vec3 view_pos;
+
+#include "../fragments/normal_encoding.glsl"
 
 // Represents a collection of attributes that would define a material
 // For instance, you can think of this like material settings in 
@@ -53,12 +54,11 @@ void main() {
     // Here we apply the TBN matrix to transform the normal from tangent space to view space
     normal = normalize(inTBN * normal);
 	
-	// Map [-1, 1] to [0, 1]
-	normal = clamp((normal + 1) / 2.0, 0, 1);
-	normal_metallic = vec4(normal, lightingParams.y);
+	// Extract emissive from the material, we only have room for its strength, the
+	// composite pass tints it by albedo
+	vec4 emissive = texture(u_Material.EmissiveMap, inUV);
+	float emissiveStrength = dot(emissive.rgb, vec3(0.2126, 0.7152, 0.0722)) * emissive.a;
 
-	// Extract emissive from the material
-	emissive = texture(u_Material.EmissiveMap, inUV);
-	
-	view_pos = inViewPos;
+	// Pack our normal into 2 channels, view position gets reconstructed from depth
+	normal_metallic = vec4(EncodeNormal(normal), lightingParams.y, emissiveStrength);
 }
\ No newline at end of file
@@ -7,7 +7,7 @@ uniform layout(binding = 0) sampler2D s_Albedo;
 uniform layout(binding = 1) sampler2D s_NormalsMetallic;
 uniform layout(binding = 2) sampler2D s_DiffuseAccumulation;
 uniform layout(binding = 3) sampler2D s_SpecularAccumulation;
-uniform layout(binding = 4) sampler2D s_Emissive;
+uniform layout(binding = 4) sampler2D s_Depth;
 
 #include "../fragments/frame_uniforms.glsl"
 #include "../fragments/color_correction.glsl"
@@ -17,11 +17,11 @@ void main() {
     vec3 albedo = texture(s_Albedo, inUV).rgb;
     vec3 diffuse = texture(s_DiffuseAccumulation, inUV).rgb;
     vec3 specular = texture(s_SpecularAccumulation, inUV).rgb;
-    vec4 emissive = texture(s_Emissive, inUV);
+    // Emissive strength is packed into the alpha of the normal buffer, and tinted by albedo
+    float emissive = texture(s_NormalsMetallic, inUV).a;
 
-    vec3 normal = texture(s_NormalsMetallic, inUV).rgb;
-
-    if (distance(normal, vec3(0.5)) < 0.1){
+    // Anything at the far plane is background, and doesn't get lit
+    if (texture(s_Depth, inUV).r >= 1.0){
          
          if (!IsFlagSet(FLAG_DISABLE_TEXTURES)) outColor = vec4(albedo, 1.0);
 
@@ -37,9 +37,9 @@ void main() {
 
         else if (IsFlagSet(FLAG_DISABLE_TEXTURES))
         {
-            outColor = vec4(diffuse + specular + (emissive.rgb * emissive.a), 1.0);
+            outColor = vec4(diffuse + specular + emissive, 1.0);
         }
 
-	    else outColor = vec4(albedo * (diffuse + specular + (emissive.rgb * emissive.a)), 1.0);
+	    else outColor = vec4(albedo * (diffuse + specular + emissive), 1.0);
     }
 }
\ No newline at end of file
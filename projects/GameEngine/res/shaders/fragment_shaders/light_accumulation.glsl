@@ -6,35 +6,20 @@ layout(location = 1) out vec4 outSpecular;
 
 uniform int u_ViewportID;
 
-// The maximum number of lights the shader supports, increasing this will lower performance!
-#define MAX_LIGHTS 8
-
-// Represents a single light source
-struct Light {
-	vec4  PositionIntensity;
-	// Stores color in RBG and attenuation in w
-	vec4  ColorAttenuation;
-};
-
-// Our uniform buffer that will store all our lighting data
-// so that it can be shared between shaders
-layout (std140, binding = 2) uniform b_LightBlock {
-    // Stores ambient light color in rgb, and number
-	// of lights in w, allowing for easier struct packing
-	// on the C++ side
-    vec4  AmbientColAndNumLights;
-
-    // Our array of all lights
-    Light Lights[MAX_LIGHTS];
-
-    // The rotation of the skybox/environment map
-	mat3  EnvironmentRotation;
-};
+// The lights and per tile light lists, filled in by compute_shaders/light_culling.glsl
+#include "../fragments/tiled_lights.glsl"
 
-#include "../fragments/deferred_post_common.glsl"
+// The bottom left corner of the viewport we're drawing, in pixels
+uniform ivec2 u_ViewportOffset;
+// The index of the viewport's first tile in b_TileLights
+uniform uint  u_TileOffset;
+// The number of tiles across the viewport
+uniform int   u_TileCountX;
 
 #include "../fragments/frame_uniforms.glsl"
 
+#include "../fragments/deferred_post_common.glsl"
+
 // Calculates the contribution the given point light has 
 // for the current fragment
 // @param viewPos   The fragment's position in view space
@@ -43,7 +28,7 @@ layout (std140, binding = 2) uniform b_LightBlock {
 // @param shininess The specular power for the fragment, between 0 and 1
 void CalcPointLightContribution(vec3 viewPos, vec3 normal, Light light, float shininess, inout vec3 diffuse, inout vec3 specular) {
 
-        vec3 lightViewPos = light.PositionIntensity.xyz;
+        vec3 lightViewPos = light.PositionRange.xyz;
         vec3 lightVec = lightViewPos - viewPos;
         float dist = length(lightVec);
         vec3 lightDir = lightVec / dist;
@@ -54,12 +39,12 @@ void CalcPointLightContribution(vec3 viewPos, vec3 normal, Light light, float sh
 
         // Dot product between normal and light
         float NdotL = max(dot(normal, lightDir), 0.0);
-        diffuse += NdotL * attenuation * light.PositionIntensity.w * light.ColorAttenuation.rgb;
+        diffuse += NdotL * attenuation * light.ColorAttenuation.rgb;
         
         vec3 reflectDir = reflect(lightDir, normal);
         float VdotR = pow(max(dot(normalize(-viewPos), reflectDir), 0.0), pow(2, shininess * 8));
         
-        specular += VdotR * light.ColorAttenuation.rgb * shininess * attenuation * light.PositionIntensity.w;
+        specular += VdotR * light.ColorAttenuation.rgb * shininess * attenuation;
 }
 
 void main() {
@@ -73,23 +58,26 @@ void main() {
         uv.y += 0.5;
     }
 
-    vec3 normal = GetNormal(uv);
-    
-    if (length(normal) < 0.1) {
+    // Nothing to light if there's no surface here
+    if (IsBackground(uv)) {
         discard;
     }
 
-    normal = normalize(normal);
-
+    vec3 normal = GetNormal(uv);
     vec3 albedo = GetAlbedo(uv);
-    vec3 viewPos = GetViewPosition(uv);
+    vec3 viewPos = GetViewPosition(uv, inUV);
     
     float specularPow = texture(s_AlbedoSpec, uv).a;
 
     vec3 diffuse = vec3(0);
     vec3 specular = vec3(0);
-    for (int ix = 0; ix < AmbientColAndNumLights.w && ix < MAX_LIGHTS; ix++) {
-        CalcPointLightContribution(viewPos, normal, Lights[ix], specularPow, diffuse, specular);
+
+    // Only shade against the lights that were binned into this pixel's tile
+    ivec2 tile = (ivec2(gl_FragCoord.xy) - u_ViewportOffset) / TILE_SIZE;
+    uint tileStart = (u_TileOffset + uint(tile.y * u_TileCountX + tile.x)) * MAX_LIGHTS_PER_TILE;
+    uint lightCount = TileLights[tileStart];
+    for (uint ix = 0; ix < lightCount; ix++) {
+        CalcPointLightContribution(viewPos, normal, Lights[TileLights[tileStart + 1 + ix]], specularPow, diffuse, specular);
     }
 
     outDiffuse = vec4(diffuse, 1);
@@ -51,21 +51,8 @@ struct Light {
 	vec4  ColorAttenuation;
 };
 
-#include "../fragments/deferred_post_common.glsl"
 #include "../fragments/frame_uniforms.glsl"
-
-// Showing off another way to extract view pos from depth
-vec4 GetViewPos(vec2 uv) {
-	// Get the depth buffer value at this pixel, map from [0,1] to [-1,1]    
-	float zOverW = texture(s_Depth, uv).r * 2 - 1;
-	// We convert the range [0,1] to [-1,1], create a point to inverse project    
-	vec4 currentPos = vec4(uv.xy * 2 - 1, zOverW, 1);
-	// Transform by the view-projection inverse    
-	vec4 D = inverse(u_Projection) * currentPos;
-	// Divide by w for perspective divide    
-	vec4 viewPos = D / D.w;
-	return viewPos;
-}
+#include "../fragments/deferred_post_common.glsl"
 
 // Calculates the contribution the given point light has 
 // for the current fragment
@@ -179,21 +166,17 @@ void main() {
         uv.y += 0.5;
     }
 
-    vec3 normal = GetNormal(uv);
-    
     // Ignore things we can't calculate light for
-    if (length(normal) < 0.1) {
+    if (IsBackground(uv)) {
         discard;
     }
 
-    // Make sure the normal is in fact, a normal
-    normal = normalize(normal);
-
     // Get values from the g-buffer
+    vec3 normal = GetNormal(uv);
     vec3 albedo = GetAlbedo(uv);
 
-    // Get viewspace from depth re-construction method (just to show how it works!)
-    vec3 viewPos = GetViewPosition(uv);
+    // View space position is reconstructed from depth
+    vec3 viewPos = GetViewPosition(uv, inUV);
 
     // Determine the position in light clip space
 	vec4 shadowPos = u_ViewToShadow * vec4(viewPos, 1.0);  
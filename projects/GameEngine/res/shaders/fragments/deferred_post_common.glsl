@@ -1,19 +1,48 @@
+/*
+ * Helpers for reading the G-Buffer, the layout is:
+ *    0: Depth
+ *    1: Albedo in rgb, specular power in a
+ *    2: Octahedral normal in rg (see normal_encoding.glsl), metallic in b, emissive strength in a
+ *
+ * View space position is reconstructed from depth, so frame_uniforms.glsl must be
+ * included before this file
+*/
 
 uniform layout(binding=0) sampler2D s_Depth;
 uniform layout(binding=1) sampler2D s_AlbedoSpec;
 uniform layout(binding=2) sampler2D s_NormalsMetallic;
-uniform layout(binding=3) sampler2D s_Emissive;
-uniform layout(binding=4) sampler2D s_Position;
 
+#include "normal_encoding.glsl"
 
 vec3 GetNormal(vec2 uv) {
-    return ((texture(s_NormalsMetallic, uv).xyz) * 2) - 1;
+    return DecodeNormal(texture(s_NormalsMetallic, uv).rg);
 }
 
 vec3 GetAlbedo(vec2 uv) {
     return texture(s_AlbedoSpec, uv).rgb;
 }
 
-vec3 GetViewPosition(vec2 uv) {
-    return texture(s_Position, uv).rgb;
-}
\ No newline at end of file
+float GetEmissive(vec2 uv) {
+    return texture(s_NormalsMetallic, uv).a;
+}
+
+// Nothing was drawn to pixels that are still at the far plane (or the skybox was), so
+// there's no surface to light
+bool IsBackground(vec2 uv) {
+    return texture(s_Depth, uv).r >= 1.0;
+}
+
+// Reconstructs the view space position of the G-Buffer sample at uv
+// @param uv         The coordinates to sample the G-Buffer at
+// @param viewportUV The coordinates of the sample within the camera's viewport, in [0, 1]
+vec3 GetViewPosition(vec2 uv, vec2 viewportUV) {
+    vec3 ndc = vec3(viewportUV, texture(s_Depth, uv).r) * 2.0 - 1.0;
+
+    // Rather than inverting the whole projection per pixel, we solve for view space directly,
+    // this works for both our perspective and orthographic projections
+    float viewZ = (u_Projection[3][2] - ndc.z * u_Projection[3][3]) / (ndc.z * u_Projection[2][3] - u_Projection[2][2]);
+    float w = u_Projection[2][3] * viewZ + u_Projection[3][3];
+    float viewX = (ndc.x * w - u_Projection[2][0] * viewZ - u_Projection[3][0]) / u_Projection[0][0];
+    float viewY = (ndc.y * w - u_Projection[2][1] * viewZ - u_Projection[3][1]) / u_Projection[1][1];
+    return vec3(viewX, viewY, viewZ);
+}
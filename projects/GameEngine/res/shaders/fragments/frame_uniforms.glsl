@@ -21,6 +21,8 @@ layout (std140, binding = 0) uniform b_FrameLevelUniforms {
 };
 
 // Stores uniforms that change every object/instance
+// When INSTANCED is defined, these come from vertex attributes instead (see vs_common.glsl)
+#ifndef INSTANCED
 layout (std140, binding = 1) uniform b_InstanceLevelUniforms {
     // Complete MVP
     uniform mat4 u_ModelViewProjection;
@@ -31,6 +33,7 @@ layout (std140, binding = 1) uniform b_InstanceLevelUniforms {
     // Normal Matrix for transforming normals
     uniform mat4 u_NormalMatrix;
 };
+#endif
 
 #define FLAG_ENABLE_COLOR_CORRECTION (1 << 0)
 #define FLAG_DISABLE_LIGHTING (1 << 1)
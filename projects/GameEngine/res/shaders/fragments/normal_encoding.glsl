@@ -0,0 +1,28 @@
+/*
+ * Octahedral normal encoding for the G-Buffer, lets us store a unit normal in 2
+ * channels instead of 3 while keeping the error spread evenly over the sphere
+ *
+ * See "A Survey of Efficient Representations for Independent Unit Vectors", Cigolle et al. 2014
+*/
+
+// Folds the lower hemisphere over the upper one
+vec2 OctWrap(vec2 v) {
+    return (1.0 - abs(v.yx)) * vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+}
+
+// Encodes a unit normal into the range [0, 1] for storage in a UNORM texture
+vec2 EncodeNormal(vec3 n) {
+    n /= (abs(n.x) + abs(n.y) + abs(n.z));
+    n.xy = n.z >= 0.0 ? n.xy : OctWrap(n.xy);
+    return n.xy * 0.5 + 0.5;
+}
+
+// Decodes a normal encoded by EncodeNormal
+vec3 DecodeNormal(vec2 encoded) {
+    vec2 f = encoded * 2.0 - 1.0;
+    vec3 n = vec3(f.x, f.y, 1.0 - abs(f.x) - abs(f.y));
+    float t = clamp(-n.z, 0.0, 1.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
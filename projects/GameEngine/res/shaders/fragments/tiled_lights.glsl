@@ -0,0 +1,30 @@
+/*
+ * Shared definitions for tiled light culling, used by the light culling compute
+ * shader and light accumulation. Lights are binned into TILE_SIZE x TILE_SIZE pixel
+ * tiles, and each tile stores a count followed by the indices of the lights that touch it
+ *
+ * These must match the constants in RenderLayer.h
+*/
+
+// The size of a single tile in pixels, also the work group size for culling
+#define TILE_SIZE 16
+// The number of uints each tile takes in b_TileLights, the first is the light count
+#define MAX_LIGHTS_PER_TILE 128
+
+// Represents a single light source
+struct Light {
+	// Stores the view space position in xyz and the culling range in w
+	vec4  PositionRange;
+	// Stores color pre-multiplied by intensity in RBG and attenuation in w
+	vec4  ColorAttenuation;
+};
+
+// All the lights in the scene, there's no fixed cap on how many we can have
+layout (std430, binding = 0) buffer b_Lights {
+	Light Lights[];
+};
+
+// The per tile light lists, filled in by the culling pass
+layout (std430, binding = 1) buffer b_TileLights {
+	uint TileLights[];
+};
@@ -18,3 +18,18 @@ layout(location = 7) out vec3 outLight;
 
 // Include the matrices and frame level parameters
 #include "frame_uniforms.glsl"
+
+// The renderer defines INSTANCED when drawing groups of objects that share a mesh and material,
+// in which case the instance level uniforms are streamed in as per-instance attributes
+// Attributes 0-5 are used by our common inputs, so we skip to 8 to leave some space
+#ifdef INSTANCED
+// This will consume 4 slots, since it's essentially 4 vec4s in memory
+layout(location = 8) in mat4 inModelTransform;
+// This will consume 3 slots in memory
+layout(location = 12) in mat3 inNormalMatrix;
+
+#define u_Model               inModelTransform
+#define u_ModelView           (u_View * inModelTransform)
+#define u_ModelViewProjection (u_ViewProjection * inModelTransform)
+#define u_NormalMatrix        mat4(inNormalMatrix)
+#endif
@@ -0,0 +1,34 @@
+#version 440
+
+// A minimal vertex shader for depth only passes, such as rendering shadow casters
+// Only positions are read, so this works for any of our vertex layouts
+// MORPH is defined for meshes driven by a MorphAnimator, INSTANCED for instanced draws
+
+layout(location = 0) in vec3 inPosition;
+
+#ifdef MORPH
+// The next frame's positions, see vs_uncommon.glsl
+layout(location = 4) in vec3 inPosition2;
+
+// The blend factor between the two frames
+uniform float t;
+#endif
+
+// Include the matrices and frame level parameters
+#include "../fragments/frame_uniforms.glsl"
+
+#ifdef INSTANCED
+// Must match the instance attributes in vs_common.glsl
+layout(location = 8) in mat4 inModelTransform;
+#define u_ModelViewProjection (u_ViewProjection * inModelTransform)
+#endif
+
+void main() {
+#ifdef MORPH
+	vec3 position = mix(inPosition, inPosition2, t);
+#else
+	vec3 position = inPosition;
+#endif
+
+	gl_Position = u_ModelViewProjection * vec4(position, 1.0);
+}
@@ -8,10 +8,14 @@
 #include "Gameplay/InputEngine.h"
 #include "Application/Timing.h"
 #include <filesystem>
+#include <cmath>
 #include "Layers/GLAppLayer.h"
 #include "Utils/FileHelpers.h"
 #include "Utils/ResourceManager/ResourceManager.h"
 #include "Utils/ImGuiHelper.h"
+#include "Utils/JobSystem.h"
+#include "Utils/AsyncLoader.h"
+#include "Utils/AssetPipeline.h"
 
 // Graphics
 #include "Graphics/Buffers/IndexBuffer.h"
@@ -26,6 +30,7 @@
 #include "Graphics/Font.h"
 #include "Graphics/GuiBatcher.h"
 #include "Graphics/Framebuffer.h"
+#include "Graphics/GlStateCache.h"
 
 // Gameplay
 #include "Gameplay/Material.h"
@@ -68,6 +73,7 @@
 #include "Layers/LogicUpdateLayer.h"
 #include "Layers/ImGuiDebugLayer.h"
 #include "Utils/ImGuiHelper.h"
+#include "Utils/JobSystem.h"
 #include "Layers/ParticleLayer.h"
 #include "Layers/Menu.h"
 #include "Layers/SecondMap.h"
@@ -81,6 +87,10 @@ std::string Application::_applicationName = "Boomerangers";
 
 #define DEFAULT_WINDOW_WIDTH 1600
 #define DEFAULT_WINDOW_HEIGHT 900
+#define DEFAULT_FIXED_TICK_RATE 60.0f
+#define DEFAULT_MAX_FIXED_STEPS 5
+#define DEFAULT_SCENE_LOAD_BUDGET_MS 8.0f
+#define DEFAULT_USE_PIXEL_BUFFERS true
 
 using namespace Gameplay;
 
@@ -202,6 +212,13 @@ void Application::_Run()
 	_windowSize.x = JsonGet(_appSettings, "window_width", DEFAULT_WINDOW_WIDTH);
 	_windowSize.y = JsonGet(_appSettings, "window_height", DEFAULT_WINDOW_HEIGHT);
 
+	// Configure the fixed simulation step, a tick rate of 0 steps physics once per frame instead
+	Timing::SetFixedTickRate(JsonGet(_appSettings, "fixed_tick_rate", DEFAULT_FIXED_TICK_RATE));
+	Timing::SetMaxFixedSteps(JsonGet(_appSettings, "max_fixed_steps", DEFAULT_MAX_FIXED_STEPS));
+
+	// How much of each frame background scene loads may use, in milliseconds
+	const float sceneLoadBudget = JsonGet(_appSettings, "scene_load_budget_ms", DEFAULT_SCENE_LOAD_BUDGET_MS) / 1000.0f;
+
 	// By default, we want our viewport to be the whole screen
 	_primaryViewport = { 0, 0, _windowSize.x, _windowSize.y };
 
@@ -357,6 +374,24 @@ void Application::_Run()
 		timing._timeSinceSceneLoad += scaledDt;
 		timing._unscaledTimeSinceSceneLoad += dt;
 
+		// Work out how many fixed steps fit into the time that has built up
+		timing._fixedStepsThisFrame = 0;
+		timing._interpolationAlpha = 1.0f;
+		if (timing._fixedDeltaTime > 0.0f) {
+			timing._fixedAccumulator += scaledDt;
+			while (timing._fixedAccumulator >= timing._fixedDeltaTime && timing._fixedStepsThisFrame < timing._maxFixedSteps) {
+				timing._fixedAccumulator -= timing._fixedDeltaTime;
+				timing._fixedStepsThisFrame++;
+			}
+			// We've fallen too far behind to catch up, drop the extra time instead of spiralling
+			if (timing._fixedAccumulator >= timing._fixedDeltaTime) {
+				timing._fixedAccumulator = std::fmod(timing._fixedAccumulator, timing._fixedDeltaTime);
+			}
+			timing._interpolationAlpha = timing._fixedAccumulator / timing._fixedDeltaTime;
+		} else {
+			timing._fixedAccumulator = 0.0f;
+		}
+
 
 		if (InputEngine::GetKeyState(GLFW_KEY_1) == ButtonState::Pressed)
 		{
@@ -429,6 +464,9 @@ void Application::_Run()
 		//Update the durations of all sounds (to be used to see if a sound has fully been played)
 		soundManaging.UpdateSounds(dt);
 
+		// ImGui drew with raw GL calls last frame, so the state cache needs to start fresh
+		GlStateCache::BeginFrame();
+
 		ImGuiHelper::StartFrame();
 
 		//If we are on the first frame, then get some references to menu elements
@@ -499,36 +537,50 @@ void Application::_Run()
 
 			if (loading)
 			{
-
-				GetLayer<Menu>()->SetActive(false);
-				GetLayer<EndScreen>()->SetActive(false);
-
-				if (desert)
+				// Build the match scene a slice at a time, the menu keeps running the loading screen in the meantime
+				if (!AsyncLoader::IsLoading())
 				{
-					GetLayer<DefaultSceneLayer>()->BeginLayer();
+					const bool loadDesert = desert;
+					AsyncLoader::Begin([this, loadDesert]() {
+						// Files get decoded on the workers while the scene is built, and uploaded before the load finishes
+						AssetPipeline::BeginBatch();
+						if (loadDesert)
+						{
+							GetLayer<DefaultSceneLayer>()->BeginLayer();
+						}
+						else
+						{
+							//Begin the second map (create the scene)
+							GetLayer<SecondMap>()->BeginLayer();
+						}
+						AssetPipeline::EndBatch();
+					}, [this, loadDesert, &soundManaging, &started, &loading]() {
+						GetLayer<Menu>()->SetActive(false);
+						GetLayer<EndScreen>()->SetActive(false);
 
-					LoadScene(GetLayer<DefaultSceneLayer>()->GetScene());
+						if (loadDesert)
+						{
+							LoadScene(GetLayer<DefaultSceneLayer>()->GetScene());
 
-					GetLayer<DefaultSceneLayer>()->SetActive(true);
+							GetLayer<DefaultSceneLayer>()->SetActive(true);
 
-					GetLayer<DefaultSceneLayer>()->GetScene()->IsPlaying = true;
-				}
-				else
-				{
-					GetLayer<Menu>()->SetActive(false);
-					//Begin the second map (create the scene)
-					GetLayer<SecondMap>()->BeginLayer();
-					//Load the scene
-					LoadScene(GetLayer<SecondMap>()->GetScene());
-					//Set the current layer to active
-					GetLayer<SecondMap>()->SetActive(true);
-					//Start playing
-					GetLayer<SecondMap>()->GetScene()->IsPlaying = true;
-				}
-				soundManaging.StopSounds();
+							GetLayer<DefaultSceneLayer>()->GetScene()->IsPlaying = true;
+						}
+						else
+						{
+							//Load the scene
+							LoadScene(GetLayer<SecondMap>()->GetScene());
+							//Set the current layer to active
+							GetLayer<SecondMap>()->SetActive(true);
+							//Start playing
+							GetLayer<SecondMap>()->GetScene()->IsPlaying = true;
+						}
+						soundManaging.StopSounds();
 
-				started = true;
-				loading = false;
+						started = true;
+						loading = false;
+					});
+				}
 			}
 
 			else if (options)
@@ -1535,10 +1587,14 @@ void Application::_Run()
 			/////////////////////////////////////////
 		}
 		
+		// Give any background scene load its slice of the frame
+		AsyncLoader::Update(sceneLoadBudget);
+
 		//////////////////////////////////////////////////////////
 		// Core update loop
 		if (_currentScene != nullptr) {
 			_Update();
+			_FixedUpdate();
 			_LateUpdate();
 			_PreRender();
 			_RenderScene();
@@ -1614,6 +1670,10 @@ void Application::_Load() {
 		}
 	}
 
+	// Start up the worker threads
+	JobSystem::Init();
+	AssetPipeline::SetUsePixelBuffers(JsonGet(_appSettings, "use_pixel_buffers", DEFAULT_USE_PIXEL_BUFFERS));
+
 	// Pass the window to the input engine and let it initialize itself
 	InputEngine::Init(_window);
 	
@@ -1631,6 +1691,17 @@ void Application::_Update() {
 	}
 }
 
+void Application::_FixedUpdate() {
+	const int steps = Timing::Current().FixedStepsThisFrame();
+	for (int ix = 0; ix < steps; ix++) {
+		for (const auto& layer : _layers) {
+			if (layer->Enabled && *(layer->Overrides & AppLayerFunctions::OnFixedUpdate)) {
+				layer->OnFixedUpdate();
+			}
+		}
+	}
+}
+
 void Application::_LateUpdate() {
 	for (const auto& layer : _layers) {
 		if (layer->Enabled && *(layer->Overrides & AppLayerFunctions::OnLateUpdate)) {
@@ -1687,6 +1758,13 @@ void Application::_Unload() {
 
 	// Clean up ImGui
 	ImGuiHelper::Cleanup();
+
+	// Stop the worker threads
+	JobSystem::Cleanup();
+
+	// Drop any scene load that didn't get to finish
+	AsyncLoader::Cleanup();
+	AssetPipeline::Cleanup();
 }
 
 void Application::_HandleSceneChange() {
@@ -1791,6 +1869,10 @@ nlohmann::json Application::_GetDefaultAppSettings()
 
 	result["window_width"]  = DEFAULT_WINDOW_WIDTH;
 	result["window_height"] = DEFAULT_WINDOW_HEIGHT;
+	result["fixed_tick_rate"] = DEFAULT_FIXED_TICK_RATE;
+	result["max_fixed_steps"] = DEFAULT_MAX_FIXED_STEPS;
+	result["scene_load_budget_ms"] = DEFAULT_SCENE_LOAD_BUDGET_MS;
+	result["use_pixel_buffers"] = DEFAULT_USE_PIXEL_BUFFERS;
 	return result;
 }
 
@@ -164,6 +164,7 @@ protected:
 	void _RegisterClasses();
 	void _Load();
 	void _Update();
+	void _FixedUpdate();
 	void _LateUpdate();
 	void _PreRender();
 	void _RenderScene();
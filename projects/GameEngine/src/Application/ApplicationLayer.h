@@ -24,6 +24,7 @@ ENUM_FLAGS(AppLayerFunctions, uint32_t,
 	OnRender       = 1 << 7,
     OnPostRender   = 1 << 8,
 	OnWindowResize = 1 << 9,
+	OnFixedUpdate  = 1 << 10,
 
 	All = 0xFFFFFFFF
 )
@@ -78,6 +79,11 @@ public:
 	 * Invoked when the application updates, at varying time steps (see Timing class)
 	 */
 	virtual void OnUpdate() {};
+	/**
+	 * Invoked zero or more times per frame after OnUpdate, at a fixed time step (see
+	 * Timing::FixedDeltaTime). Only invoked when the application has a fixed tick rate
+	 */
+	virtual void OnFixedUpdate() {};
 	/**
 	 * Invoked after all layers in an application have been updated
 	 */
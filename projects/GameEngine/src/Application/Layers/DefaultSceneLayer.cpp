@@ -129,7 +129,6 @@ void DefaultSceneLayer::_CreateScene() {
 
 	Application& app = Application::Get();
 
-	app.SetPrimaryViewport(glm::uvec4( 0, 0, app.GetWindowSize().x / 2, app.GetWindowSize().y / 2 ));
 	//app.SetSecondaryViewport(glm::uvec4(app.GetWindowSize().x / 2, app.GetWindowSize().y / 2, app.GetWindowSize().x, app.GetWindowSize().y));
 	
 	bool loadScene = false;
@@ -190,17 +189,18 @@ void DefaultSceneLayer::_CreateScene() {
 		MeshResource::Sptr monkeyMesh = ResourceManager::CreateAsset<MeshResource>("Monkey.obj");
 		MeshResource::Sptr cubeMesh = ResourceManager::CreateAsset<MeshResource>("cube.obj");
 		MeshResource::Sptr boiMesh = ResourceManager::CreateAsset<MeshResource>("boi-tpose.obj");
-		MeshResource::Sptr catcusMesh = ResourceManager::CreateAsset<MeshResource>("CatcusAnims/Catcus_Idle_001.obj");
-		MeshResource::Sptr mainCharMesh = ResourceManager::CreateAsset<MeshResource>("mainChar.obj");
-		MeshResource::Sptr mainCharMesh2 = ResourceManager::CreateAsset<MeshResource>("mainChar.obj");
-		MeshResource::Sptr boomerangMesh = ResourceManager::CreateAsset<MeshResource>("BoomerangAnims/Boomerang_Active_000.obj");
-		MeshResource::Sptr boomerangMesh2 = ResourceManager::CreateAsset<MeshResource>("BoomerangAnims/Boomerang_Active_000.obj");
+		// Morph animated meshes need their own copy, the animator swaps the frames into the mesh's VAO
+		MeshResource::Sptr catcusMesh = ResourceManager::CreateUniqueAsset<MeshResource>("CatcusAnims/Catcus_Idle_001.obj");
+		MeshResource::Sptr mainCharMesh = ResourceManager::CreateUniqueAsset<MeshResource>("mainChar.obj");
+		MeshResource::Sptr mainCharMesh2 = ResourceManager::CreateUniqueAsset<MeshResource>("mainChar.obj");
+		MeshResource::Sptr boomerangMesh = ResourceManager::CreateUniqueAsset<MeshResource>("BoomerangAnims/Boomerang_Active_000.obj");
+		MeshResource::Sptr boomerangMesh2 = ResourceManager::CreateUniqueAsset<MeshResource>("BoomerangAnims/Boomerang_Active_000.obj");
 
 		MeshResource::Sptr displayBoomerangMesh = ResourceManager::CreateAsset<MeshResource>("BoomerangAnims/Boomerang_Active_000.obj");
 
 		MeshResource::Sptr movingPlatMesh = ResourceManager::CreateAsset<MeshResource>("floating_rock.obj");
-		MeshResource::Sptr healthPackMesh = ResourceManager::CreateAsset<MeshResource>("HealthPackAnims/healthPack_idle_000.obj");
-		MeshResource::Sptr torchMesh = ResourceManager::CreateAsset<MeshResource>("TorchAnims/Torch_Idle_000.obj");
+		MeshResource::Sptr healthPackMesh = ResourceManager::CreateUniqueAsset<MeshResource>("HealthPackAnims/healthPack_idle_000.obj");
+		MeshResource::Sptr torchMesh = ResourceManager::CreateUniqueAsset<MeshResource>("TorchAnims/Torch_Idle_000.obj");
 
 		//Stage Meshes
 			//Floors
@@ -3098,6 +3098,9 @@ void DefaultSceneLayer::_CreateScene() {
 		_scene.push_back(scene);
 		currentSceneNum++;
 	}
+
+	// Only switch to split screen once the scene is done, the menu is still drawing while we load
+	app.SetPrimaryViewport(glm::uvec4( 0, 0, app.GetWindowSize().x / 2, app.GetWindowSize().y / 2 ));
 }
 
 void DefaultSceneLayer::SetActive(bool active)
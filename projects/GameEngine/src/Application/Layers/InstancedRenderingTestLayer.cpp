@@ -49,9 +49,12 @@ void InstancedRenderingTestLayer::OnSceneLoad() {
 
 
 	// Due to how scene stuff is handled in editor, we'll remove all existing instances and re-add them
+	std::vector<Gameplay::GameObject::Sptr> oldInstances;
+	oldInstances.reserve(_instances.size());
 	for (auto& instance : _instances) {
-		scene->RemoveGameObject(scene->FindObjectByGUID(instance));
+		oldInstances.push_back(scene->FindObjectByGUID(instance));
 	}
+	scene->RemoveGameObjects(oldInstances);
 
 	// Create a bunch of instances in a cube
 	_instances.clear();
@@ -6,7 +6,7 @@ LogicUpdateLayer::LogicUpdateLayer() :
 	ApplicationLayer()
 {
 	Name = "Logic";
-	Overrides = AppLayerFunctions::OnUpdate;
+	Overrides = AppLayerFunctions::OnUpdate | AppLayerFunctions::OnFixedUpdate;
 }
 
 LogicUpdateLayer::~LogicUpdateLayer() = default;
@@ -18,6 +18,20 @@ void LogicUpdateLayer::OnUpdate()
 	// Perform updates for all components
 	app.CurrentScene()->Update(Timing::Current().DeltaTime());
 
-	// Update our worlds physics!
-	app.CurrentScene()->DoPhysics(Timing::Current().DeltaTime());
+	// With a fixed tick rate, physics is stepped from OnFixedUpdate instead
+	if (!Timing::Current().IsFixedStep()) {
+		// Update our worlds physics!
+		app.CurrentScene()->DoPhysics(Timing::Current().DeltaTime());
+	}
+
+	// Propagate everything that moved this frame before anything gets rendered
+	app.CurrentScene()->UpdateTransforms();
+}
+
+void LogicUpdateLayer::OnFixedUpdate()
+{
+	Application& app = Application::Get();
+
+	// Step the physics world by exactly one tick
+	app.CurrentScene()->DoPhysics(Timing::Current().FixedDeltaTime(), true);
 }
@@ -36,7 +36,7 @@ void ParticleLayer::OnUpdate()
 	glm::uvec4 viewport = app.GetPrimaryViewport();
 	glViewport(viewport.x, viewport.w / 2.0f, viewport.z, viewport.w / 2.0f);
 	if (app.CurrentScene()->IsPlaying) {
-		app.CurrentScene()->Components().Each<ParticleSystem>([](const ParticleSystem::Sptr& system) {
+		app.CurrentScene()->Components().Each<ParticleSystem>([](ParticleSystem* system) {
 			if (system->IsEnabled && system->GetFlag() == 1) {
 				system->Update();
 			}
@@ -56,7 +56,7 @@ void ParticleLayer::OnUpdate()
 	
 	glViewport(viewport.x, viewport.y, viewport.z, viewport.w / 2.0f);
 	if (app.CurrentScene()->IsPlaying) {
-		app.CurrentScene()->Components().Each<ParticleSystem>([](const ParticleSystem::Sptr& system) {
+		app.CurrentScene()->Components().Each<ParticleSystem>([](ParticleSystem* system) {
 			if (system->IsEnabled && system->GetFlag() == 2) {
 				system->Update();
 			}
@@ -90,7 +90,7 @@ void ParticleLayer::OnPostRender()
 	frameUn->Update();
 
 	glViewport(viewport.x, viewport.w / 2.0f, viewport.z, viewport.w / 2.0f);
-	Application::Get().CurrentScene()->Components().Each<ParticleSystem>([](const ParticleSystem::Sptr& system) {
+	Application::Get().CurrentScene()->Components().Each<ParticleSystem>([](ParticleSystem* system) {
 		if (system->IsEnabled && system->GetFlag() == 1) {
 			system->Render(); 
 		}
@@ -108,7 +108,7 @@ void ParticleLayer::OnPostRender()
 	frameUn->Update();
 
 	glViewport(viewport.x, viewport.y, viewport.z, viewport.w / 2.0f);
-	Application::Get().CurrentScene()->Components().Each<ParticleSystem>([](const ParticleSystem::Sptr& system) {
+	Application::Get().CurrentScene()->Components().Each<ParticleSystem>([](ParticleSystem* system) {
 		if (system->IsEnabled && system->GetFlag() == 2) {
 			system->Render();
 		}
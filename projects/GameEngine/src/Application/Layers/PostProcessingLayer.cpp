@@ -2,6 +2,7 @@
 
 #include "Application/Application.h"
 #include "RenderLayer.h"
+#include "Graphics/GlStateCache.h"
 
 #include "PostProcessing/ColorCorrectionEffect.h"
 #include "PostProcessing/BoxFilter3x3.h"
@@ -119,7 +120,7 @@ void PostProcessingLayer::OnPostRender()
 
 	// Bind the output of our post processing as the source for the blit
 	current->Bind(FramebufferBinding::Read);
-	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+	GlStateCache::BindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
 
 	// Blit the color buffer to our game window
 	current->Blit(
@@ -9,6 +9,8 @@
 #include "Gameplay/Components/RenderComponent.h"
 #include "Gameplay/Components/Light.h"
 #include "Graphics/Buffers/UniformBuffer.h"
+#include "Graphics/Frustum.h"
+#include "Graphics/GlStateCache.h"
 // GLM math library
 #include <GLM/glm.hpp>
 #include <GLM/gtc/matrix_transform.hpp>
@@ -16,6 +18,7 @@
 #define GLM_ENABLE_EXPERIMENTAL
 #include <GLM/gtx/common.hpp> // for fmod (floating modulus)
 #include "Gameplay/Components/ShadowCamera.h"
+#include "Gameplay/Components/MorphAnimator.h"
 
 
 RenderLayer::RenderLayer() :
@@ -42,17 +45,16 @@ void RenderLayer::OnPreRender()
 
 	Application& app = Application::Get();
 
-	// Clear the color and depth buffers
-	const glm::vec4 colors[4] = {
-		glm::vec4(0.0f),
-		glm::vec4(0.5f, 0.5f, 0.5f, 0.0f),
-		glm::vec4(0.0f),
-		glm::vec4(0.0f)
-	};
+	// Draw dynamic bodies between their last two physics states, so they move smoothly no matter
+	// how the frame rate lines up with the tick rate. This has to happen before we grab the camera,
+	// since cameras are usually attached to something physics driven
+	if (Timing::Current().IsFixedStep()) {
+		app.CurrentScene()->InterpolateTransforms(Timing::Current().InterpolationAlpha());
+		app.CurrentScene()->UpdateTransforms();
+	}
 
-	_primaryFBO->Bind();
-	// Clear the framebuffer. Note that this also binds and sets the viewport
-	_ClearFramebuffer(_primaryFBO, colors, 4);
+	// Start the G-Buffer pass. Note that this also binds and sets the viewport
+	_BeginPass(_primaryFBO, _gBufferLoadPolicy);
 
 	
 	// Grab shorthands to the camera and shader from the scene
@@ -80,6 +82,10 @@ void RenderLayer::OnPreRender()
 		colorLUT->Bind(14);
 	}
 
+	// Move to the next segment of our instance data ring, this will only block if the GPU
+	// is more than a few frames behind us
+	_instanceRing->BeginFrame();
+
 	// Here we'll bind all the UBOs to their corresponding slots
 	_frameUniforms->Bind(FRAME_UBO_BINDING);
 	_instanceUniforms->Bind(INSTANCE_UBO_BINDING);
@@ -163,6 +169,14 @@ void RenderLayer::OnPostRender() {
 	);
 
 	_outputBuffer->Unbind();
+
+	// Fence off all the instance data we used this frame so we don't overwrite it while it's in use
+	_instanceRing->EndFrame();
+}
+
+// Gets the number of light culling tiles needed to cover a viewport
+static glm::ivec2 GetTileCount(const glm::ivec4& viewport) {
+	return (glm::ivec2(viewport.z, viewport.w) + (RenderLayer::LIGHT_TILE_SIZE - 1)) / RenderLayer::LIGHT_TILE_SIZE;
 }
 
 void RenderLayer::_AccumulateLighting()
@@ -177,20 +191,31 @@ void RenderLayer::_AccumulateLighting()
 
 	Camera::Sptr camera2 = app.CurrentScene()->MainCamera2;
 
-	const glm::vec3& ambient = scene->GetAmbientLight();
-	const glm::vec4 colors[2] = {
-		{ ambient, 1.0f },         // diffuse (multiplicative)
-		{ 0.0f, 0.0f, 0.0f, 1.0f } // specular (additive)
-	};
-	_lightingFBO->Bind();
-	_ClearFramebuffer(_lightingFBO, colors, 2);
+	// Render our shadow maps once for the frame, before any of the viewports need them
+	_RenderShadowMaps();
+
+	// Diffuse starts at the ambient light, since light contributions are added on top
+	_lightingLoadPolicy[0].ClearValue = glm::vec4(scene->GetAmbientLight(), 1.0f);
+	_BeginPass(_lightingFBO, _lightingLoadPolicy);
 
 	glEnable(GL_BLEND);
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE); 
 	
-	_AccumulateLightingViewport(camera, glm::ivec4(viewport.x, viewport.w / 2.0f, viewport.z, viewport.w / 2.0f), 1);
+	glm::ivec4 topViewport = glm::ivec4(viewport.x, viewport.w / 2.0f, viewport.z, viewport.w / 2.0f);
+	glm::ivec4 bottomViewport = glm::ivec4(viewport.x, viewport.y, viewport.z, viewport.w / 2.0f);
+
+	// Each viewport gets its own run of tiles, so culling the second viewport can't overwrite
+	// light lists that the first is still reading
+	glm::ivec2 topTiles = GetTileCount(topViewport);
+	glm::ivec2 bottomTiles = GetTileCount(bottomViewport);
+	uint32_t tileEntries = (topTiles.x * topTiles.y + bottomTiles.x * bottomTiles.y) * MAX_LIGHTS_PER_TILE;
+	if (_tileLightBuffer->GetElementCount() < tileEntries) {
+		_tileLightBuffer->LoadData(nullptr, sizeof(uint32_t), tileEntries);
+	}
+
+	_AccumulateLightingViewport(camera, topViewport, 1, 0);
 
-	_AccumulateLightingViewport(camera2, glm::ivec4(viewport.x, viewport.y, viewport.z, viewport.w / 2.0f), 0);
+	_AccumulateLightingViewport(camera2, bottomViewport, 0, topTiles.x * topTiles.y);
 
 	// Unbind the lighting FBO so we can read its textures
 	_lightingFBO->Unbind();
@@ -212,21 +237,19 @@ void RenderLayer::_Composite()
 	// We want to switch to our compositing shader
 	_compositingShader->Bind();
 
-	// Switch rendering to output
-	_outputBuffer->Bind();
-	glViewport(0, 0, _outputBuffer->GetWidth(), _outputBuffer->GetHeight());
+	// Switch rendering to output. The quad and depth blit overwrite the whole buffer, so there's
+	// nothing to clear
+	_BeginPass(_outputBuffer, _outputLoadPolicy);
 
-	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-	// Disable blending, we want to override any existing colors
-	glDisable(GL_BLEND);
+	// The quad covers every pixel, so there's no need to test it against the old depth
+	glDisable(GL_DEPTH_TEST);
 
 	// Bind our albedo and lighting buffers so we can composite a final scene
 	_primaryFBO->GetTextureAttachment(RenderTargetAttachment::Color0)->Bind(0);
 	_primaryFBO->GetTextureAttachment(RenderTargetAttachment::Color1)->Bind(1);
 	_lightingFBO->GetTextureAttachment(RenderTargetAttachment::Color0)->Bind(2); 
 	_lightingFBO->GetTextureAttachment(RenderTargetAttachment::Color1)->Bind(3);
-	_primaryFBO->GetTextureAttachment(RenderTargetAttachment::Color2)->Bind(4);  
+	_primaryFBO->GetTextureAttachment(RenderTargetAttachment::Depth)->Bind(4);
 	_fullscreenQuad->Draw(); 
 
 	// Re-enable depth testing
@@ -247,31 +270,23 @@ void RenderLayer::_Composite()
 	_outputBuffer->Unbind();
 }
 
-void RenderLayer::_ClearFramebuffer(Framebuffer::Sptr& buffer, const glm::vec4* colors, int layers) {
+void RenderLayer::_BeginPass(const Framebuffer::Sptr& buffer, const FramebufferLoadPolicy& policy) {
+	// Bind the buffer so we're writing to it
+	buffer->Bind();
 	// Make the entire buffer visible
 	glViewport(0, 0, buffer->GetWidth(), buffer->GetHeight());
-	// Disable depth testing
-	glEnable(GL_DEPTH_TEST); 
-	// Enable depth writing
+	// Enable depth testing
+	glEnable(GL_DEPTH_TEST);
+	// Clears respect the write masks, so make sure depth writing is on
 	glDepthMask(true);
-	// Disable blending, we want to override the colors
+	// Disable blending, passes enable it as they need
 	glDisable(GL_BLEND);
-	// Ignore existing depth
-	glDepthFunc(GL_ALWAYS);
-
-	// Bind the buffer so we're writing to it
-	buffer->Bind();
 
-	// Bind our clear shader, and draw a fullscreen quad with all the clear colors
-	_clearShader->Bind();
-	_clearShader->SetUniform<glm::vec4>("ClearColors", colors, layers);
-	_fullscreenQuad->Draw();
-
-	// Reset depth test function to default
-	glDepthFunc(GL_LESS);
+	// Clear or discard the attachments as the pass requests
+	buffer->ApplyLoadPolicy(policy);
 }
 
-void RenderLayer::_AccumulateLightingViewport(Gameplay::Camera::Sptr cam, glm::ivec4 viewport, int ID)
+void RenderLayer::_AccumulateLightingViewport(Gameplay::Camera::Sptr cam, glm::ivec4 viewport, int ID, uint32_t tileOffset)
 {
 	using namespace Gameplay;
 
@@ -289,17 +304,10 @@ void RenderLayer::_AccumulateLightingViewport(Gameplay::Camera::Sptr cam, glm::i
 	frameData.u_CameraPos = view * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
 	_frameUniforms->Update();
 
-	// Bind our shader for processing lighting 
-	_lightAccumulationShader->Bind();
-
-	_lightAccumulationShader->SetUniform("u_ViewportID", ID);
-
 	// Bind our G-Buffer textures so that they're readable
 	_primaryFBO->GetTextureAttachment(RenderTargetAttachment::Depth)->Bind(0);  // depth
 	_primaryFBO->GetTextureAttachment(RenderTargetAttachment::Color0)->Bind(1); // albedo + spec
-	_primaryFBO->GetTextureAttachment(RenderTargetAttachment::Color1)->Bind(2); // normals + metallic
-	_primaryFBO->GetTextureAttachment(RenderTargetAttachment::Color2)->Bind(3); // emissive
-	_primaryFBO->GetTextureAttachment(RenderTargetAttachment::Color3)->Bind(4); // view pos
+	_primaryFBO->GetTextureAttachment(RenderTargetAttachment::Color1)->Bind(2); // packed normals + metallic + emissive
 
 	// Update our lighting UBO for any shaders that need it
 	LightingUboStruct& data = _lightingUbo->GetData();
@@ -309,81 +317,77 @@ void RenderLayer::_AccumulateLightingViewport(Gameplay::Camera::Sptr cam, glm::i
 	// Send in how many active lights we have and the global lighting settings
 	data.AmbientCol = glm::vec3(0.1f);
 	int ix = 0;
-	app.CurrentScene()->Components().Each<Light>([&](const Light::Sptr& light) {
+	_tiledLights.clear();
+	app.CurrentScene()->Components().Each<Light>([&](Light* light) {
 		// Get the light's position in view space, since we're doing view space lighting
 		glm::vec4 pos = glm::vec4(light->GetGameObject()->GetWorldPosition(), 1.0f);
 		pos = view * pos;
 
-		// Copy to the ubo data
-		data.Lights[ix].Position = (glm::vec3)(pos) / pos.w;
-		data.Lights[ix].Intensity = light->GetIntensity();
-		data.Lights[ix].Color = light->GetColor();
-		data.Lights[ix].Attenuation = 1.0f / (1.0f + light->GetRadius());
-
-		ix++;
-
-		// If we've reached the max # of lights the shader supports, draw to the screen and start the next batch
-		if (ix == MAX_LIGHTS) {
-			data.NumLights = MAX_LIGHTS;
-
-			// Send updated data to OpenGL
-			_lightingUbo->Update();
-
-			// Draw the fullscreen quad to accumulate the lights
-			_fullscreenQuad->Draw();
-
-			ix = 0;
+		glm::vec3 viewPos = (glm::vec3)(pos) / pos.w;
+		glm::vec3 color = light->GetColor() * light->GetIntensity();
+		float attenuation = 1.0f / (1.0f + light->GetRadius());
+
+		// Forward shaders still read the first few lights from the UBO
+		if (ix < MAX_LIGHTS) {
+			data.Lights[ix].Position = viewPos;
+			data.Lights[ix].Intensity = light->GetIntensity();
+			data.Lights[ix].Color = light->GetColor();
+			data.Lights[ix].Attenuation = attenuation;
+			ix++;
 		}
-		});
 
-	// If we have lights left over that haven't been drawn, draw them now
-	if (ix > 0) {
-		data.NumLights = ix;
+		// Our attenuation never quite reaches zero, so we cull lights past the distance where
+		// their brightest channel drops below what the lighting buffer can store
+		float brightest = glm::max(color.r, glm::max(color.g, color.b));
+		if (brightest <= LIGHT_CULL_THRESHOLD) {
+			return;
+		}
+		float range = glm::sqrt((brightest / LIGHT_CULL_THRESHOLD - 1.0f) / attenuation);
 
-		// Send updated data to OpenGL
-		_lightingUbo->Update();
+		_tiledLights.push_back({ glm::vec4(viewPos, range), glm::vec4(color, attenuation) });
+	});
 
-		// Draw the fullscreen quad to accumulate the lights
+	data.NumLights = static_cast<float>(ix);
+	_lightingUbo->Update();
+
+	if (!_tiledLights.empty()) {
+		// This re-allocates the buffer's storage, so the other viewport's lights are left
+		// intact until the GPU is done with them
+		_lightBuffer->LoadData(_tiledLights.data(), static_cast<uint32_t>(_tiledLights.size()));
+		_lightBuffer->Bind(LIGHT_SSBO_BINDING);
+		_tileLightBuffer->Bind(TILE_LIGHTS_SSBO_BINDING);
+
+		glm::ivec2 tiles = GetTileCount(viewport);
+
+		// Bin the lights into screen tiles, using the G-Buffer depth to bound each tile
+		_lightCullingShader->Bind();
+		_lightCullingShader->SetUniform("u_LightCount", static_cast<uint32_t>(_tiledLights.size()));
+		_lightCullingShader->SetUniform("u_ViewportOffset", glm::ivec2(viewport.x, viewport.y));
+		_lightCullingShader->SetUniform("u_ViewportSize", glm::ivec2(viewport.z, viewport.w));
+		_lightCullingShader->SetUniform("u_TileOffset", tileOffset);
+		_lightCullingShader->SetUniformMatrix("u_InverseProjection", glm::inverse(cam->GetProjection()));
+		glDispatchCompute(tiles.x, tiles.y, 1);
+
+		// The tile lists need to be written before light accumulation reads them
+		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+		// Shade every pixel once, against only the lights in its tile
+		_lightAccumulationShader->Bind();
+		_lightAccumulationShader->SetUniform("u_ViewportID", ID);
+		_lightAccumulationShader->SetUniform("u_ViewportOffset", glm::ivec2(viewport.x, viewport.y));
+		_lightAccumulationShader->SetUniform("u_TileOffset", tileOffset);
+		_lightAccumulationShader->SetUniform("u_TileCountX", tiles.x);
 		_fullscreenQuad->Draw();
 	}
 
-	// Re-render the scene for shadows
-	app.CurrentScene()->Components().Each<ShadowCamera>([&](const ShadowCamera::Sptr& shadowCam) {
-		// Bind the shadow camera's depth buffer and clear it
-		shadowCam->GetDepthBuffer()->Bind();
-		glClear(GL_DEPTH_BUFFER_BIT);
-		//glViewport(0, 0, shadowCam->GetBufferResolution().x, shadowCam->GetBufferResolution().y);
-
-		_RenderScene(shadowCam->GetGameObject()->GetInverseTransform(), shadowCam->GetProjection(), 1);
-
-		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
-	});
-
-	// Restore frame level uniforms
-	//_InitFrameUniforms();
-
-	auto& frameData2 = _frameUniforms->GetData();
-	frameData2.u_Projection = cam->GetProjection();
-	frameData2.u_View = view;
-	frameData2.u_ViewProjection = cam->GetViewProjection();
-	frameData2.u_CameraPos = view * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
-	_frameUniforms->Update();
-
-	_lightingFBO->Bind();
-	//glViewport(0, 0, _lightingFBO->GetWidth(), _lightingFBO->GetHeight());
-
-	// Bind our G-Buffer textures so that they're readable
-	_primaryFBO->GetTextureAttachment(RenderTargetAttachment::Depth)->Bind(0);  // depth
-	_primaryFBO->GetTextureAttachment(RenderTargetAttachment::Color0)->Bind(1); // albedo + spec
-	_primaryFBO->GetTextureAttachment(RenderTargetAttachment::Color1)->Bind(2); // normals + metallic
-	_primaryFBO->GetTextureAttachment(RenderTargetAttachment::Color2)->Bind(3); // emissive
-	_primaryFBO->GetTextureAttachment(RenderTargetAttachment::Color3)->Bind(4); // view pos
+	// Shadow maps have already been rendered for this frame by _RenderShadowMaps, and are
+	// shared between all viewports
 
 	// Bind shadow composite shader
 	_shadowShader->Bind();
 
 	// Add each shadow casting light to the lighting buffers
-	app.CurrentScene()->Components().Each<ShadowCamera>([&](const ShadowCamera::Sptr& shadowCam) {
+	app.CurrentScene()->Components().Each<ShadowCamera>([&](ShadowCamera* shadowCam) {
 		// This gets us the light -> view space matrix, which we'll inverse to go from view space to light space
 		glm::mat4 lightSpaceMatrix = view * shadowCam->GetGameObject()->GetTransform();
 
@@ -465,12 +469,9 @@ void RenderLayer::OnAppLoad(const nlohmann::json& config)
 	fboDescriptor.RenderTargets[RenderTargetAttachment::Depth] = RenderTargetDescriptor(RenderTargetType::Depth32);
 	// Color layer 0 (albedo, specular)
 	fboDescriptor.RenderTargets[RenderTargetAttachment::Color0] = RenderTargetDescriptor(RenderTargetType::ColorRgba8);
-	// Color layer 1 (normals, metallic)
+	// Color layer 1 (octahedral normals, metallic, emissive strength)
+	// View space position is reconstructed from depth, see fragments/deferred_post_common.glsl
 	fboDescriptor.RenderTargets[RenderTargetAttachment::Color1] = RenderTargetDescriptor(RenderTargetType::ColorRgba8);
-	// Color layer 2 (emissive)  
-	fboDescriptor.RenderTargets[RenderTargetAttachment::Color2] = RenderTargetDescriptor(RenderTargetType::ColorRgba8);
-	// Color layer 3 (view space position)  
-	fboDescriptor.RenderTargets[RenderTargetAttachment::Color3] = RenderTargetDescriptor(RenderTargetType::ColorRgba16F);
 	 
 	// Create the primary FBO
 	_primaryFBO = std::make_shared<Framebuffer>(fboDescriptor);
@@ -499,16 +500,38 @@ void RenderLayer::OnAppLoad(const nlohmann::json& config)
 	_compositingShader->LoadShaderPartFromFile("shaders/fragment_shaders/deferred_composite.glsl", ShaderPartType::Fragment);
 	_compositingShader->Link();
 
-	_clearShader = ShaderProgram::Create();
-	_clearShader->LoadShaderPartFromFile("shaders/vertex_shaders/fullscreen_quad.glsl", ShaderPartType::Vertex);
-	_clearShader->LoadShaderPartFromFile("shaders/fragment_shaders/clear.glsl", ShaderPartType::Fragment);
-	_clearShader->Link();
+	// The G-Buffer starts out empty, with everything at the far plane
+	_gBufferLoadPolicy = {
+		AttachmentLoadAction(RenderTargetAttachment::Depth,  LoadOp::Clear, glm::vec4(1.0f)),
+		AttachmentLoadAction(RenderTargetAttachment::Color0, LoadOp::Clear, glm::vec4(0.0f)),
+		AttachmentLoadAction(RenderTargetAttachment::Color1, LoadOp::Clear, glm::vec4(0.0f))
+	};
+	// Diffuse clears to the ambient light (filled in each frame), specular to black
+	_lightingLoadPolicy = {
+		AttachmentLoadAction(RenderTargetAttachment::Color0, LoadOp::Clear, glm::vec4(0.0f, 0.0f, 0.0f, 1.0f)),
+		AttachmentLoadAction(RenderTargetAttachment::Color1, LoadOp::Clear, glm::vec4(0.0f, 0.0f, 0.0f, 1.0f))
+	};
+	// Compositing writes every pixel and the depth gets blitted over, so the old contents are never read
+	_outputLoadPolicy = {
+		AttachmentLoadAction(RenderTargetAttachment::Color0, LoadOp::DontCare),
+		AttachmentLoadAction(RenderTargetAttachment::Depth,  LoadOp::DontCare)
+	};
 
 	_shadowShader = ShaderProgram::Create();
 	_shadowShader->LoadShaderPartFromFile("shaders/vertex_shaders/fullscreen_quad.glsl", ShaderPartType::Vertex);
 	_shadowShader->LoadShaderPartFromFile("shaders/fragment_shaders/shadow_composite.glsl", ShaderPartType::Fragment);
 	_shadowShader->Link();
 
+	// Shadow casters only need to write depth, so opaque casters skip their material entirely
+	_shadowCasterShader = ShaderProgram::Create();
+	_shadowCasterShader->LoadShaderPartFromFile("shaders/vertex_shaders/depth_only.glsl", ShaderPartType::Vertex);
+	_shadowCasterShader->LoadShaderPartFromFile("shaders/fragment_shaders/depth_only.glsl", ShaderPartType::Fragment);
+	_shadowCasterShader->Link();
+	_shadowCasterShader->SetDebugName("Shadow Caster");
+
+	_shadowCasterMorphShader = _shadowCasterShader->CreateVariant({ "MORPH" }, { ShaderPartType::Vertex });
+	_shadowCasterMorphShader->SetDebugName("Shadow Caster - morph");
+
 	// We need a mesh for drawing fullscreen quads
 
 	glm::vec2 positions[6] = {
@@ -527,7 +550,25 @@ void RenderLayer::OnAppLoad(const nlohmann::json& config)
 	// Create our common uniform buffers
 	_frameUniforms = std::make_shared<UniformBuffer<FrameLevelUniforms>>(BufferUsage::DynamicDraw);
 	_instanceUniforms = std::make_shared<UniformBuffer<InstanceLevelUniforms>>(BufferUsage::DynamicDraw);
+	_instanceRing = std::make_shared<UniformRingBuffer>(static_cast<uint32_t>(sizeof(InstanceLevelUniforms)), MAX_INSTANCE_BLOCKS_PER_FRAME);
+	_instanceRing->SetDebugName("Instance Ring");
+
+	// Create the buffer that will store the per-instance data for instanced draws
+	_instanceVbo = VertexBuffer::Create(BufferUsage::StreamDraw);
+	_instanceVbo->SetDebugName("Instance Transforms");
 	_lightingUbo = std::make_shared<UniformBuffer<LightingUboStruct>>(BufferUsage::DynamicDraw);
+
+	// Tiled lighting, lights get binned into screen tiles by a compute shader, then light
+	// accumulation only shades against the lights in each pixel's tile
+	_lightCullingShader = ShaderProgram::Create();
+	_lightCullingShader->LoadShaderPartFromFile("shaders/compute_shaders/light_culling.glsl", ShaderPartType::Compute);
+	_lightCullingShader->Link();
+	_lightCullingShader->SetDebugName("Light Culling");
+
+	_lightBuffer = ShaderStorageBuffer::Create(BufferUsage::StreamDraw);
+	_lightBuffer->SetDebugName("Lights");
+	_tileLightBuffer = ShaderStorageBuffer::Create(BufferUsage::DynamicCopy);
+	_tileLightBuffer->SetDebugName("Tile Light Lists");
 }
 
 const Framebuffer::Sptr& RenderLayer::GetPrimaryFBO() const {
@@ -603,18 +644,87 @@ void RenderLayer::_InitFrameUniforms()
 }
 
 void RenderLayer::_RenderScene(const glm::mat4& view, const glm::mat4& projection, int renderFlag)
+{
+	_CollectRenderables(view, projection * view, renderFlag);
+	_DrawRenderQueue(view, projection);
+}
+
+void RenderLayer::_CollectRenderables(const glm::mat4& view, const glm::mat4& viewProj, int renderFlag, bool shadowCasters)
 {
 	using namespace Gameplay;
 
 	Application& app = Application::Get();
 
-	glm::mat4 viewProj = projection * view;
+	Material::Sptr defaultMat = app.CurrentScene()->DefaultMaterial;
 
-	// The current material that is bound for rendering
-	Material::Sptr currentMat = nullptr;
-	ShaderProgram::Sptr shader = nullptr;
+	// Anything outside of this frustum can't be seen, so we don't need to draw it
+	Frustum frustum = Frustum(viewProj);
 
-	Material::Sptr defaultMat = app.CurrentScene()->DefaultMaterial;
+	// Collect all the objects we want to draw into the render queue
+	_renderQueue.Clear();
+	app.CurrentScene()->Components().Each<RenderComponent>([&](RenderComponent* renderable) {
+		GameObject* object = renderable->GetGameObject();
+		if (object->GetRenderFlag() != 0 && object->GetRenderFlag() != renderFlag) {
+			return;
+		}
+
+		if (shadowCasters && !renderable->GetCastsShadows()) {
+			return;
+		}
+
+		// Early bail if mesh not set
+		const VertexArrayObject::Sptr& mesh = renderable->GetMesh();
+		if (mesh == nullptr) {
+			return;
+		}
+
+		// If we don't have a material, try getting the scene's fallback material
+		// If none exists, do not draw anything
+		if (renderable->GetMaterial() == nullptr) {
+			if (defaultMat != nullptr) {
+				renderable->SetMaterial(defaultMat);
+			}
+			else {
+				return;
+			}
+		}
+
+		const Material::Sptr& material = renderable->GetMaterial();
+		if (material->GetShader() == nullptr) {
+			return;
+		}
+
+		// Skip anything that is fully outside the view
+		if (!frustum.TestBounds(mesh->GetBounds(), object->GetTransform())) {
+			return;
+		}
+
+		// We sort front to back within a bucket, so we need the view space depth of the object
+		float depth = -(view * glm::vec4(object->GetWorldPosition(), 1.0f)).z;
+
+		ShaderProgram* shader = material->GetShader().get();
+		Material* drawMaterial = material.get();
+
+		// Opaque shadow casters only need their positions, so they can share a depth only program
+		// and skip binding their material. Alpha tested materials still need to run their fragment shader
+		if (shadowCasters && !material->IsAlphaTested()) {
+			shader = object->Has<MorphAnimator>() ? _shadowCasterMorphShader.get() : _shadowCasterShader.get();
+			drawMaterial = nullptr;
+		}
+
+		uint64_t key = RenderQueue::MakeKey(shader->GetHandle(), drawMaterial != nullptr ? drawMaterial->GetSortId() : 0, mesh->GetHandle(), depth);
+		_renderQueue.Push(key, { shader, drawMaterial, mesh.get(), object });
+	});
+
+	// Sort so that draws sharing a shader, material and mesh are next to each other
+	_renderQueue.Sort();
+}
+
+void RenderLayer::_DrawRenderQueue(const glm::mat4& view, const glm::mat4& projection)
+{
+	using namespace Gameplay;
+
+	glm::mat4 viewProj = projection * view;
 
 	auto& frameData = _frameUniforms->GetData();
 	frameData.u_Projection = projection;
@@ -623,53 +733,214 @@ void RenderLayer::_RenderScene(const glm::mat4& view, const glm::mat4& projectio
 	frameData.u_CameraPos = view * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
 	_frameUniforms->Update();
 
-	// Render all our objects
-	app.CurrentScene()->Components().Each<RenderComponent>([&](const RenderComponent::Sptr& renderable) {
-		if (renderable->GetGameObject()->GetRenderFlag() == 0 ||
-			renderable->GetGameObject()->GetRenderFlag() == renderFlag)
-		{
-			// Early bail if mesh not set
-			if (renderable->GetMesh() == nullptr) {
-				return;
-			}
+	// Split the sorted queue into batches, where runs of draws sharing a mesh and material become
+	// a single instanced draw, and write all the per-instance data up front so that we aren't
+	// updating buffers between draws
+	_BuildDrawBatches(view, viewProj);
 
-			// If we don't have a material, try getting the scene's fallback material
-			// If none exists, do not draw anything
-			if (renderable->GetMaterial() == nullptr) {
-				if (defaultMat != nullptr) {
-					renderable->SetMaterial(defaultMat);
-				}
-				else {
-					return;
-				}
-			}
-
-			// If the material has changed, we need to bind the new shader and set up our material and frame data
-			// Note: This is a good reason why we should be sorting the render components in ComponentManager
-			if (renderable->GetMaterial() != currentMat) {
-				currentMat = renderable->GetMaterial();
-				shader = currentMat->GetShader();
+	// The current state that is bound for rendering
+	Material*      currentMat = nullptr;
+	ShaderProgram* shader = nullptr;
 
-				shader->Bind();
+	// Render all our objects
+	for (const DrawBatch& batch : _drawBatches) {
+		const RenderQueue::DrawItem& item = _renderQueue[batch.Start];
+
+		// Only re-bind the shader and material when they actually change
+		if (batch.Shader != shader) {
+			shader = batch.Shader;
+			shader->Bind();
+			currentMat = nullptr;
+		}
+		if (item.Material != currentMat) {
+			currentMat = item.Material;
+			if (currentMat == nullptr) {
+				// Depth only draw, no material state needed
+			} else if (batch.Instanced) {
+				currentMat->ApplyToVariant(batch.Shader);
+			} else {
 				currentMat->Apply();
 			}
+		}
 
-			// Grab the game object so we can do some stuff with it
-			GameObject* object = renderable->GetGameObject();
+		if (batch.Instanced) {
+			// The instance buffer gets attached to a mesh the first time it is drawn instanced
+			if (!item.Mesh->HasVertexBuffer(_instanceVbo)) {
+				item.Mesh->AddVertexBuffer(_instanceVbo, INSTANCE_ATTRIBUTES, true);
+			}
+			item.Mesh->DrawInstanced(batch.Count, batch.Offset);
+			continue;
+		}
 
-			// Use our uniform buffer for our instance level uniforms
+		// Point the instance UBO binding at this draw's block
+		if (batch.Offset != NO_INSTANCE_BLOCK) {
+			_instanceRing->BindRange(INSTANCE_UBO_BINDING, batch.Offset);
+		}
+		// We ran out of space in the ring this frame, fall back to updating our single UBO
+		else {
+			const glm::mat4& transform = item.Object->GetTransform();
 			auto& instanceData = _instanceUniforms->GetData();
-			instanceData.u_Model = object->GetTransform();
-			instanceData.u_ModelViewProjection = viewProj * object->GetTransform();
-			instanceData.u_ModelView = view * object->GetTransform();
-			instanceData.u_NormalMatrix = glm::mat3(glm::transpose(glm::inverse(object->GetTransform())));
+			instanceData.u_Model = transform;
+			instanceData.u_ModelViewProjection = viewProj * transform;
+			instanceData.u_ModelView = view * transform;
+			instanceData.u_NormalMatrix = glm::mat3(glm::transpose(glm::inverse(transform)));
 			_instanceUniforms->Update();
+			_instanceUniforms->Bind(INSTANCE_UBO_BINDING);
+		}
+
+		// The depth only morph program can't get the blend factor from the material
+		if (shader == _shadowCasterMorphShader.get()) {
+			shader->SetUniform("t", item.Object->Get<MorphAnimator>()->GetBlend());
+		}
+
+		// Draw the object
+		item.Mesh->Draw();
+	}
+
+	// Other systems (such as particles) expect our regular instance UBO to be bound
+	_instanceUniforms->Bind(INSTANCE_UBO_BINDING);
+}
+
+// Folds the given bytes into an FNV-1a hash
+static uint64_t HashBytes(uint64_t hash, const void* data, size_t size) {
+	const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+	for (size_t ix = 0; ix < size; ix++) {
+		hash ^= bytes[ix];
+		hash *= 0x100000001B3ull;
+	}
+	return hash;
+}
+
+void RenderLayer::_RenderShadowMaps()
+{
+	using namespace Gameplay;
 
-			// Draw the object
-			renderable->GetMesh()->Draw();
+	Application& app = Application::Get();
+
+	app.CurrentScene()->Components().Each<ShadowCamera>([&](ShadowCamera* shadowCam) {
+		const Framebuffer::Sptr& depthBuffer = shadowCam->GetDepthBuffer();
+		if (depthBuffer == nullptr) {
+			return;
+		}
+
+		const glm::mat4& view = shadowCam->GetGameObject()->GetInverseTransform();
+		const glm::mat4& projection = shadowCam->GetProjection();
+		glm::mat4 viewProj = projection * view;
+
+		// Gather the casters that are inside the light's frustum
+		_CollectRenderables(view, viewProj, 1, true);
+
+		// If neither the light nor anything it can see has changed, the old shadow map is still good
+		if (!shadowCam->NeedsShadowMapUpdate(viewProj, _ComputeCasterSignature())) {
+			return;
 		}
 
+		// Bind the shadow camera's depth buffer and clear it
+		depthBuffer->Bind();
+		glViewport(0, 0, depthBuffer->GetWidth(), depthBuffer->GetHeight());
+		depthBuffer->ClearAttachment(RenderTargetAttachment::Depth, glm::vec4(1.0f));
+
+		_DrawRenderQueue(view, projection);
 	});
 
+	GlStateCache::BindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+}
+
+uint64_t RenderLayer::_ComputeCasterSignature() const
+{
+	using namespace Gameplay;
+
+	// Start with the FNV offset basis, and mix in the number of casters so that
+	// objects entering or leaving the frustum are always detected
+	uint64_t hash = 0xCBF29CE484222325ull;
+	size_t count = _renderQueue.Size();
+	hash = HashBytes(hash, &count, sizeof(size_t));
+
+	for (size_t ix = 0; ix < count; ix++) {
+		const RenderQueue::DrawItem& item = _renderQueue[ix];
+
+		// Morph animated meshes change every frame without their transform changing,
+		// so we can't cache any shadow map they are in
+		if (item.Object->Has<MorphAnimator>()) {
+			return ++_dynamicSignature;
+		}
+
+		hash = HashBytes(hash, &item.Object, sizeof(GameObject*));
+		hash = HashBytes(hash, &item.Mesh, sizeof(VertexArrayObject*));
+		hash = HashBytes(hash, &item.Material, sizeof(Material*));
+		hash = HashBytes(hash, &item.Object->GetTransform(), sizeof(glm::mat4));
+	}
+
+	return hash;
+}
+
+void RenderLayer::_BuildDrawBatches(const glm::mat4& view, const glm::mat4& viewProj)
+{
+	_drawBatches.clear();
+	_instanceTransforms.clear();
+
+	const size_t count = _renderQueue.Size();
+	for (size_t start = 0; start < count; ) {
+		const RenderQueue::DrawItem& first = _renderQueue[start];
+
+		// Find the end of the run of draws that share this mesh, material and program
+		size_t end = start + 1;
+		while (end < count && _renderQueue[end].Mesh == first.Mesh && _renderQueue[end].Material == first.Material && _renderQueue[end].Shader == first.Shader) {
+			end++;
+		}
+
+		// Only bother instancing if the run is long enough and the shader supports it
+		// Morph animated casters each have their own blend factor, so they can't be instanced
+		ShaderProgram* shader = first.Shader;
+		ShaderProgram* instancedShader = nullptr;
+		if ((end - start) >= MIN_INSTANCED_BATCH && shader != _shadowCasterMorphShader.get()) {
+			instancedShader = shader->GetInstancedVariant().get();
+		}
+
+		if (instancedShader != nullptr) {
+			DrawBatch batch;
+			batch.Start = static_cast<uint32_t>(start);
+			batch.Count = static_cast<uint32_t>(end - start);
+			batch.Offset = static_cast<uint32_t>(_instanceTransforms.size());
+			batch.Shader = instancedShader;
+			batch.Instanced = true;
+			_drawBatches.push_back(batch);
+
+			for (size_t ix = start; ix < end; ix++) {
+				const glm::mat4& transform = _renderQueue[ix].Object->GetTransform();
+				_instanceTransforms.push_back({ transform, glm::mat3(glm::transpose(glm::inverse(transform))) });
+			}
+		}
+		else {
+			for (size_t ix = start; ix < end; ix++) {
+				DrawBatch batch;
+				batch.Start = static_cast<uint32_t>(ix);
+				batch.Count = 1;
+				batch.Shader = shader;
+				batch.Instanced = false;
+
+				// Grab a block in our instance ring and fill it in
+				InstanceLevelUniforms* instanceData = _instanceRing->Allocate<InstanceLevelUniforms>(batch.Offset);
+				if (instanceData != nullptr) {
+					const glm::mat4& transform = _renderQueue[ix].Object->GetTransform();
+					instanceData->u_Model = transform;
+					instanceData->u_ModelViewProjection = viewProj * transform;
+					instanceData->u_ModelView = view * transform;
+					instanceData->u_NormalMatrix = glm::mat3(glm::transpose(glm::inverse(transform)));
+				} else {
+					batch.Offset = NO_INSTANCE_BLOCK;
+				}
+				_drawBatches.push_back(batch);
+			}
+		}
+
+		start = end;
+	}
+
+	// Upload all the instance transforms in one go, this re-allocates the buffer's storage so
+	// the driver doesn't need to wait for any previous draws that are still using it
+	if (!_instanceTransforms.empty()) {
+		_instanceVbo->LoadData(_instanceTransforms.data(), static_cast<uint32_t>(_instanceTransforms.size()));
+	}
 }
 
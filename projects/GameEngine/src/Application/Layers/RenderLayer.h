@@ -2,8 +2,11 @@
 #include "../ApplicationLayer.h"
 #include "Graphics/Framebuffer.h"
 #include "Graphics/Buffers/UniformBuffer.h"
+#include "Graphics/Buffers/UniformRingBuffer.h"
+#include "Graphics/Buffers/ShaderStorageBuffer.h"
 #include "Graphics/ShaderProgram.h"
 #include "Graphics/VertexArrayObject.h"
+#include "Graphics/RenderQueue.h"
 #include "Gameplay/Components/Camera.h"
 
 #define MAX_LIGHTS 8
@@ -58,6 +61,17 @@ public:
 		glm::mat4 u_NormalMatrix;
 	};
 
+	/// <summary>
+	/// The per-instance data for instanced draws, matches the layout of the
+	/// INSTANCED attributes in fragments/vs_common.glsl
+	/// </summary>
+	struct InstanceTransform {
+		// Model to world transform, fed into locations 8-11
+		glm::mat4 Model;
+		// Normal matrix, fed into locations 12-14
+		glm::mat3 NormalMatrix;
+	};
+
 	/// <summary>
 	/// Represents a c++ struct layout that matches that of
 	/// our multiple light uniform buffer
@@ -84,6 +98,23 @@ public:
 		glm::mat4 EnvironmentRotation;
 	};
 
+	/// <summary>
+	/// A single light for tiled lighting, matches the Light struct in
+	/// fragments/tiled_lights.glsl
+	/// </summary>
+	struct TiledLight {
+		// View space position in xyz, culling range in w
+		glm::vec4 PositionRange;
+		// Color multiplied by intensity in rgb, attenuation in w
+		glm::vec4 ColorAttenuation;
+	};
+
+	// The size of a light culling tile in pixels, must match TILE_SIZE in fragments/tiled_lights.glsl
+	static const int LIGHT_TILE_SIZE = 16;
+	// The number of entries per tile in the tile light lists (a count, then the light indices),
+	// must match MAX_LIGHTS_PER_TILE in fragments/tiled_lights.glsl
+	static const uint32_t MAX_LIGHTS_PER_TILE = 128;
+
 	RenderLayer();
 	virtual ~RenderLayer();
 
@@ -123,13 +154,21 @@ protected:
 	Framebuffer::Sptr   _lightingFBO;
 	Framebuffer::Sptr   _outputBuffer;
 
-	ShaderProgram::Sptr _clearShader;
 	ShaderProgram::Sptr _lightAccumulationShader;
 	ShaderProgram::Sptr _compositingShader;
 	ShaderProgram::Sptr _shadowShader;
 
+	// Position only programs for drawing opaque shadow casters, see depth_only.glsl
+	ShaderProgram::Sptr _shadowCasterShader;
+	ShaderProgram::Sptr _shadowCasterMorphShader;
+
 	VertexArrayObject::Sptr _fullscreenQuad;
 
+	// How each pass prepares its framebuffer, see _BeginPass
+	FramebufferLoadPolicy _gBufferLoadPolicy;
+	FramebufferLoadPolicy _lightingLoadPolicy;
+	FramebufferLoadPolicy _outputLoadPolicy;
+
 	bool              _blitFbo;
 	glm::vec4         _clearColor;
 	RenderFlags       _renderFlags;
@@ -140,15 +179,78 @@ protected:
 	const int INSTANCE_UBO_BINDING = 1;
 	UniformBuffer<InstanceLevelUniforms>::Sptr _instanceUniforms;
 
+	// The maximum number of instance blocks we can stream in a single frame, across all
+	// passes. Draws past this will fall back to updating _instanceUniforms
+	const uint32_t MAX_INSTANCE_BLOCKS_PER_FRAME = 4096;
+	UniformRingBuffer::Sptr _instanceRing;
+
+	// Runs of at least this many draws with the same mesh and material will be instanced
+	const uint32_t MIN_INSTANCED_BATCH = 2;
+	// Marks a non-instanced batch that did not get a block in _instanceRing
+	static const uint32_t NO_INSTANCE_BLOCK = UINT32_MAX;
+	// The attributes that _instanceVbo provides, see InstanceTransform
+	const std::vector<BufferAttribute> INSTANCE_ATTRIBUTES = {
+		BufferAttribute(8,  4, AttributeType::Float, sizeof(InstanceTransform), 0,                        AttribUsage::User0),
+		BufferAttribute(9,  4, AttributeType::Float, sizeof(InstanceTransform), sizeof(glm::vec4),        AttribUsage::User0),
+		BufferAttribute(10, 4, AttributeType::Float, sizeof(InstanceTransform), sizeof(glm::vec4) * 2,    AttribUsage::User0),
+		BufferAttribute(11, 4, AttributeType::Float, sizeof(InstanceTransform), sizeof(glm::vec4) * 3,    AttribUsage::User0),
+		BufferAttribute(12, 3, AttributeType::Float, sizeof(InstanceTransform), sizeof(glm::mat4),        AttribUsage::User0),
+		BufferAttribute(13, 3, AttributeType::Float, sizeof(InstanceTransform), sizeof(glm::mat4) + 12,   AttribUsage::User0),
+		BufferAttribute(14, 3, AttributeType::Float, sizeof(InstanceTransform), sizeof(glm::mat4) + 24,   AttribUsage::User0),
+	};
+
+	/// <summary>
+	/// A single draw call, built from one or more consecutive draws in the render queue
+	/// </summary>
+	struct DrawBatch {
+		// Index of the first draw in the render queue
+		uint32_t Start;
+		// The number of draws in the batch, only more than 1 for instanced batches
+		uint32_t Count;
+		// For instanced batches, the first instance in _instanceVbo, otherwise the offset of
+		// the draw's block in _instanceRing (or NO_INSTANCE_BLOCK)
+		uint32_t Offset;
+		// The program to draw with, the instanced variant for instanced batches
+		ShaderProgram* Shader;
+		bool     Instanced;
+	};
+	std::vector<DrawBatch>         _drawBatches;
+	std::vector<InstanceTransform> _instanceTransforms;
+	VertexBuffer::Sptr             _instanceVbo;
+
 	const int LIGHTING_UBO_BINDING = 2;
 	UniformBuffer<LightingUboStruct>::Sptr _lightingUbo;
 
+	// SSBO bindings for tiled lighting, see fragments/tiled_lights.glsl
+	const int LIGHT_SSBO_BINDING = 0;
+	const int TILE_LIGHTS_SSBO_BINDING = 1;
+	// Lights are culled once their contribution drops below this, about one step of an 8 bit channel
+	const float LIGHT_CULL_THRESHOLD = 1.0f / 256.0f;
+	ShaderProgram::Sptr         _lightCullingShader;
+	ShaderStorageBuffer::Sptr   _lightBuffer;
+	ShaderStorageBuffer::Sptr   _tileLightBuffer;
+	std::vector<TiledLight>     _tiledLights;
+
+	// Re-used between calls to _RenderScene so we don't re-allocate every frame
+	RenderQueue _renderQueue;
+	// Handed out as the caster signature for shadow maps that can't be cached
+	mutable uint64_t _dynamicSignature = 0;
+
 	void _InitFrameUniforms();
 	void _RenderScene(const glm::mat4& view, const glm::mat4&Projection, int renderFlag);
+	void _CollectRenderables(const glm::mat4& view, const glm::mat4& viewProj, int renderFlag, bool shadowCasters = false);
+	void _DrawRenderQueue(const glm::mat4& view, const glm::mat4& projection);
+	void _RenderShadowMaps();
+	uint64_t _ComputeCasterSignature() const;
+	void _BuildDrawBatches(const glm::mat4& view, const glm::mat4& viewProj);
 
 	void _AccumulateLighting();
 	void _Composite();
-	void _ClearFramebuffer(Framebuffer::Sptr& buffer, const glm::vec4* colors, int layers);
+	/// <summary>
+	/// Binds a framebuffer for a full-screen pass and prepares its attachments according
+	/// to the pass' load policy
+	/// </summary>
+	void _BeginPass(const Framebuffer::Sptr& buffer, const FramebufferLoadPolicy& policy);
 
-	void _AccumulateLightingViewport(Gameplay::Camera::Sptr cam, glm::ivec4 viewport, int ID);
+	void _AccumulateLightingViewport(Gameplay::Camera::Sptr cam, glm::ivec4 viewport, int ID, uint32_t tileOffset);
 };
\ No newline at end of file
@@ -165,11 +165,12 @@ void SecondMap::_CreateScene() {
 
 #pragma endregion
 #pragma region CharacterMeshes
-		MeshResource::Sptr mainCharMesh = ResourceManager::CreateAsset<MeshResource>("mainChar.obj");
-		MeshResource::Sptr mainCharMesh2 = ResourceManager::CreateAsset<MeshResource>("mainChar.obj");
+		// Morph animated meshes need their own copy, the animator swaps the frames into the mesh's VAO
+		MeshResource::Sptr mainCharMesh = ResourceManager::CreateUniqueAsset<MeshResource>("mainChar.obj");
+		MeshResource::Sptr mainCharMesh2 = ResourceManager::CreateUniqueAsset<MeshResource>("mainChar.obj");
 		MeshResource::Sptr boomerangMesh = ResourceManager::CreateAsset<MeshResource>("BoomerangAnims/Boomerang_Active_000.obj");
 		MeshResource::Sptr displayBoomerangMesh = ResourceManager::CreateAsset<MeshResource>("BoomerangAnims/Boomerang_Active_000.obj");
-		MeshResource::Sptr healthPackMesh = ResourceManager::CreateAsset<MeshResource>("HealthPackAnims/healthPack_idle_000.obj");
+		MeshResource::Sptr healthPackMesh = ResourceManager::CreateUniqueAsset<MeshResource>("HealthPackAnims/healthPack_idle_000.obj");
 
 		std::vector<MeshResource::Sptr> mainIdle = LoadTargets2(3, "MainCharacterAnims/Idle/Char_Idle_00");
 
@@ -16,11 +16,45 @@ public:
 	inline float TimeSinceAppLoad() { return _timeSinceSceneLoad; }
 	inline float UnscaledTimeSinceAppLoad() { return _unscaledTimeSinceSceneLoad; }
 
+	/**
+	 * Returns true if the simulation is running on a fixed tick rate, in which case
+	 * physics is stepped from OnFixedUpdate instead of OnUpdate
+	 */
+	inline bool IsFixedStep() { return _fixedDeltaTime > 0.0f; }
+	/**
+	 * The length of a single fixed step in seconds, or 0 if fixed stepping is disabled. Fixed steps
+	 * are driven by scaled time, so a lower time scale runs fewer steps rather than shorter ones
+	 */
+	inline float FixedDeltaTime() { return _fixedDeltaTime; }
+	/**
+	 * The number of fixed steps that are being run during this frame
+	 */
+	inline int FixedStepsThisFrame() { return _fixedStepsThisFrame; }
+	/**
+	 * How far between the last two fixed steps the current frame is, in the range [0, 1]. Used
+	 * to blend between the last two physics states when rendering. Always 1 when fixed stepping
+	 * is disabled
+	 */
+	inline float InterpolationAlpha() { return _interpolationAlpha; }
+
 	static inline Timing& Current() { return _singleton; }
 
 	static inline float TimeScale() { return _timeScale; }
 	static inline void SetTimeScale(float value) { _timeScale = value < 0.0f ? 0.0f : value; }
 
+	/**
+	 * Sets the number of fixed steps per second, or 0 to step the simulation once per frame
+	 */
+	static inline void SetFixedTickRate(float ticksPerSecond) { _fixedDeltaTime = ticksPerSecond > 0.0f ? 1.0f / ticksPerSecond : 0.0f; }
+	static inline float FixedTickRate() { return _fixedDeltaTime > 0.0f ? 1.0f / _fixedDeltaTime : 0.0f; }
+	/**
+	 * Sets the maximum number of fixed steps that may run in a single frame. If a frame takes
+	 * longer than this many steps the leftover time is dropped, so that a slow frame can't cause
+	 * even slower frames after it
+	 */
+	static inline void SetMaxFixedSteps(int value) { _maxFixedSteps = value < 1 ? 1 : value; }
+	static inline int MaxFixedSteps() { return _maxFixedSteps; }
+
 protected:
 	friend class Application;
 
@@ -33,7 +67,15 @@ protected:
 	float _timeSinceAppLoad = 0;
 	float _unscaledTimeSinceAppLoad = 0;
 
+	// Scaled time that has not been consumed by a fixed step yet
+	float _fixedAccumulator = 0;
+	int   _fixedStepsThisFrame = 0;
+	float _interpolationAlpha = 1.0f;
+
 	static inline float _timeScale = 1.0f;
+	// Length of a fixed step, 0 when disabled
+	static inline float _fixedDeltaTime = 0.0f;
+	static inline int   _maxFixedSteps = 5;
 };
 
 inline Timing Timing::_singleton = Timing();
\ No newline at end of file
@@ -2,6 +2,8 @@
 #include "Application/Application.h"
 #include "Application/ApplicationLayer.h"
 #include "Application/Layers/RenderLayer.h"
+#include "Graphics/GlStateCache.h"
+#include "Utils/ObjParserBenchmark.h"
 
 DebugWindow::DebugWindow() :
 	IEditorWindow()
@@ -37,4 +39,25 @@ void DebugWindow::RenderMenuBar()
 	if (changed) {
 		renderLayer->SetRenderFlags(flags);
 	}
+
+	ImGui::Separator();
+
+	// Bind calls from the last frame, and how many were skipped as redundant
+	GlStateCounters binds = GlStateCache::GetFrameTotals();
+	ImGui::Text("GL binds: %u issued, %u filtered", binds.Issued, binds.Filtered);
+	if (ImGui::IsItemHovered()) {
+		ImGui::BeginTooltip();
+		for (GlStateType type : { GlStateType::Program, GlStateType::VertexArray, GlStateType::Texture, GlStateType::Buffer, GlStateType::Framebuffer }) {
+			const GlStateCounters& counters = GlStateCache::GetFrameCounters(type);
+			ImGui::Text("%s: %u issued, %u filtered", (~type).c_str(), counters.Issued, counters.Filtered);
+		}
+		ImGui::EndTooltip();
+	}
+
+	ImGui::Separator();
+
+	// Results go to the log, the meshes are loaded relative to the working directory
+	if (ImGui::Button("Benchmark OBJ Parsing")) {
+		ObjParserBenchmark::Run();
+	}
 }
@@ -26,8 +26,6 @@ void GBufferPreviews::Render()
 	Texture2D::Sptr& depth = framebuffer->GetTextureAttachment(RenderTargetAttachment::Depth);
 	Texture2D::Sptr& color = framebuffer->GetTextureAttachment(RenderTargetAttachment::Color0);
 	Texture2D::Sptr& normals = framebuffer->GetTextureAttachment(RenderTargetAttachment::Color1);
-	Texture2D::Sptr& emissive = framebuffer->GetTextureAttachment(RenderTargetAttachment::Color2);
-	Texture2D::Sptr& viewspace = framebuffer->GetTextureAttachment(RenderTargetAttachment::Color3);
 
 	Texture2D::Sptr& diffuse = lightBuffer->GetTextureAttachment(RenderTargetAttachment::Color0);
 	Texture2D::Sptr& specular = lightBuffer->GetTextureAttachment(RenderTargetAttachment::Color1);
@@ -49,13 +47,8 @@ void GBufferPreviews::Render()
 	_RenderTexture2D(color, size, "color");
 	ImGui::NextColumn();
 
-	_RenderTexture2D(normals, size, "normals");
-	ImGui::NextColumn();
-
-	_RenderTexture2D(emissive, size, "emissive"); 
-	ImGui::NextColumn();  
-
-	_RenderTexture2D(viewspace, size, "position (viewspace)");
+	// Normals are octahedral encoded in rg, with metallic in b and emissive strength in a
+	_RenderTexture2D(normals, size, "normals (packed)");
 	ImGui::NextColumn();
 
 	_RenderTexture2D(diffuse, size, "Diffuse Lighting");
@@ -1,8 +1,11 @@
 #pragma once
 #include <functional>
 #include "IComponent.h"
+#include "ComponentPool.h"
+#include "ComponentTypeId.h"
 #include <typeindex>
 #include <optional>
+#include <type_traits>
 #include <Logging.h>
 
 namespace Gameplay {
@@ -10,14 +13,41 @@ namespace Gameplay {
 	/// Helper class for component types, this class is what lets us load component types
 	/// from scene files, as well as providing a way to iterate over all active components
 	/// of a given type (and sort them in the future!)
+	/// 
+	/// Components of each type are tracked in a dense ComponentPool, and each component
+	/// stores a handle to its entry so that it can be removed in constant time
 	/// </summary>
 	class ComponentManager {
 	public:
 		typedef std::function<IComponent::Sptr(const nlohmann::json&)> LoadComponentFunc;
 		typedef std::function<IComponent::Sptr()> CreateComponentFunc;
+		typedef IComponent::Sptr(*CloneComponentFunc)(const IComponent&);
+		typedef std::unique_ptr<IComponentPool>(*CreatePoolFunc)();
 
+		ComponentManager() = default;
+		~ComponentManager() {
+			Clear();
+		}
+
+		// The components hold handles into our pools, so we can't be copied or moved
+		ComponentManager(const ComponentManager& other) = delete;
+		ComponentManager& operator =(const ComponentManager& other) = delete;
+
+		/// <summary>
+		/// Removes all components from the pools, the components themselves stay alive for as
+		/// long as they are referenced elsewhere
+		/// </summary>
 		inline void Clear() {
-			_Components.clear();
+			std::vector<IComponent*> components;
+			for (auto& [type, pool] : _pools) {
+				pool->GetAll(components);
+			}
+			// Make sure none of the components try to remove themselves from us later
+			for (IComponent* component : components) {
+				component->_manager = nullptr;
+				component->_handle = ComponentHandle();
+			}
+			_pools.clear();
 		}
 
 		/// <summary>
@@ -29,6 +59,23 @@ namespace Gameplay {
 		/// <param name="blob">The JSON blob to decode</param>
 		/// <returns>The component as decoded from the JSON data, or nullptr</returns>
 		inline IComponent::Sptr Load(const std::string& typeName, const nlohmann::json& blob) {
+			IComponent::Sptr result = LoadUnregistered(typeName, blob);
+			if (result != nullptr) {
+				// Add the component to the global pools
+				_Register(result.get());
+			}
+			return result;
+		}
+
+		/// <summary>
+		/// Loads a component with the given type name from a JSON blob, without adding it to any
+		/// component pools. The component won't be updated or found by any scene, which makes it
+		/// useful as a template to Clone from
+		/// </summary>
+		/// <param name="typeName">The name of the type to load (taken from GetComponentTypeName of component)</param>
+		/// <param name="blob">The JSON blob to decode</param>
+		/// <returns>The component as decoded from the JSON data, or nullptr</returns>
+		static IComponent::Sptr LoadUnregistered(const std::string& typeName, const nlohmann::json& blob) {
 			// Try and get the type index from the name
 			std::optional<std::type_index> typeIndex = _TypeNameMap[typeName];
 
@@ -44,15 +91,40 @@ namespace Gameplay {
 					// Make sure the component knows it's own type
 					result->_realType = typeIndex.value();
 					result->_weakSelfPtr = result;
-
-					// Add the component to the global pools
-					_Components[result->_realType].push_back(result);
 					return result;
 				}
 			}
 			return nullptr;
 		}
 
+		/// <summary>
+		/// Creates a copy of a component with its type's copy constructor, and adds the copy to the
+		/// global pools. The copy gets a new GUID and is not attached to any game object.
+		/// 
+		/// This is meant for components that have not been woken up (like a prefab's templates),
+		/// anything created in OnLoad or Awake would otherwise be shared with the copy
+		/// </summary>
+		/// <param name="source">The component to copy</param>
+		/// <returns>The new component, or nullptr if the source's type was never registered</returns>
+		inline IComponent::Sptr Clone(const IComponent& source) {
+			auto it = _TypeCloneRegistry.find(source._realType);
+			if (it == _TypeCloneRegistry.end()) {
+				return nullptr;
+			}
+
+			IComponent::Sptr result = it->second(source);
+			// The copy constructor brought over the source's identity and pool entry, replace them with our own
+			result->_realType = source._realType;
+			result->_weakSelfPtr = result;
+			result->_context = nullptr;
+			result->_manager = nullptr;
+			result->_handle = ComponentHandle();
+			result->OverrideGUID(Guid::New());
+
+			_Register(result.get());
+			return result;
+		}
+
 		/// <summary>
 		/// Creates a component with the given type name
 		/// If the type name does not correspond to a registered type, will
@@ -75,7 +147,7 @@ namespace Gameplay {
 					result->_realType = typeIndex.value();
 					result->_weakSelfPtr = result;
 					// Add the component to the global pools
-					_Components[result->_realType].push_back(result);
+					_Register(result.get());
 					return result;
 				}
 			}
@@ -102,7 +174,7 @@ namespace Gameplay {
 				result->_realType = type;
 				result->_weakSelfPtr = result;
 				// Add the component to the global pools
-				_Components[result->_realType].push_back(result);
+				_Register(result.get());
 				return result;
 			}
 			return nullptr;
@@ -135,16 +207,17 @@ namespace Gameplay {
 			std::type_index type = std::type_index(typeid(ComponentType));
 			LOG_ASSERT(_TypeLoadRegistry[type] != nullptr, "You must register component types before creating them!");
 
-			// Create component, forwarding arguments
-			std::shared_ptr<ComponentType> component = std::make_shared<ComponentType>(std::forward<TArgs>(args)...);
+			// Create component, forwarding arguments. Components of the same type are allocated
+			// from the same slab, so they sit close together in memory
+			std::shared_ptr<ComponentType> component = std::allocate_shared<ComponentType>(ComponentAllocator<ComponentType>(), std::forward<TArgs>(args)...);
 
 			// Make sure the component knows it's concrete type
 			component->_realType = type;
 			// Give the component a weak pointer to itself that it can upcast to a shared pointer when needed
 			component->_weakSelfPtr = component;
 
-			// Add to global component list for that type
-			_Components[type].push_back(component);
+			// Add to global component pool for that type
+			_Register(component.get());
 
 			// Return the result
 			return component;
@@ -165,52 +238,91 @@ namespace Gameplay {
 			std::type_index type = std::type_index(typeid(ComponentType));
 			LOG_ASSERT(_TypeLoadRegistry[type] != nullptr, "You must register component types before creating them!");
 
-			// Clear any dead weak pointers
-			auto removeIt = std::remove_if(_Components[type].begin(), _Components[type].end(), [](const std::weak_ptr<IComponent>& ptr) {
-				return ptr.expired();
-			});
-			_Components[type].erase(removeIt, _Components[type].end());
+			ComponentPool<ComponentType>* pool = _GetPool<ComponentType>();
+			if (pool == nullptr) {
+				return nullptr;
+			}
 
 			// Search the component store for a component that matches that ID
-			auto& it = std::find_if(_Components[type].begin(), _Components[type].end(), [&](const std::weak_ptr<IComponent>& ptr) {
-				return (ptr.lock())->GetGUID() == id;
-			});
+			ComponentType* result = nullptr;
+			pool->Each([&](ComponentType* component) {
+				if (result == nullptr && component->GetGUID() == id) {
+					result = component;
+				}
+			}, true);
 
 			// If the component was found, return it. Otherwise return nullptr
-			if (it != _Components[type].end()) {
-				// We need to lock the weak pointer to convert it to a shared ptr
-				return std::dynamic_pointer_cast<ComponentType>((*it).lock());
-			} else {
-				return nullptr;
-			}
+			return result != nullptr ? std::static_pointer_cast<ComponentType>(result->SelfRef().lock()) : nullptr;
+		}
+
+		/// <summary>
+		/// Gets the component that the given handle refers to, or nullptr if the component has
+		/// since been removed
+		/// </summary>
+		/// <typeparam name="ComponentType">The type of component to get</typeparam>
+		/// <param name="handle">The handle to resolve, see IComponent::GetHandle</param>
+		template <
+			typename ComponentType,
+			typename = typename std::enable_if<std::is_base_of<IComponent, ComponentType>::value>::type>
+		std::shared_ptr<ComponentType> Get(ComponentHandle handle) {
+			ComponentPool<ComponentType>* pool = _GetPool<ComponentType>();
+			ComponentType* result = pool != nullptr ? pool->GetTyped(handle) : nullptr;
+			return result != nullptr ? std::static_pointer_cast<ComponentType>(result->SelfRef().lock()) : nullptr;
 		}
 
 		/// <summary>
 		/// Iterates over all components of the given type and invokes a method with them
+		/// 
+		/// The callback may either take a ComponentType*, which is passed straight out of the pool,
+		/// or a const std::shared_ptr<ComponentType>&, which needs to lock the component's self
+		/// reference for every call. Prefer the former in anything that runs every frame
 		/// </summary>
 		/// <typeparam name="ComponentType">The type of component to iterate on</typeparam>
 		/// <param name="callback">The callback to invoke with the components</param>
 		/// <param name="includeDisabled">True to include disabled components, false if otherwise</param>
 		template <
 			typename ComponentType,
+			typename Func,
 			typename = typename std::enable_if<std::is_base_of<IComponent, ComponentType>::value>::type>
-		void Each(std::function<void(const std::shared_ptr<ComponentType>&)> callback, bool includeDisabled = false) {
-			// We can use typeid and type_index to get a unique ID for our types
-			std::type_index type = std::type_index(typeid(ComponentType));
-			LOG_ASSERT(_TypeLoadRegistry[type] != nullptr, "You must register component types before creating them!");
+		void Each(Func&& callback, bool includeDisabled = false) {
+			LOG_ASSERT(_TypeLoadRegistry.find(std::type_index(typeid(ComponentType))) != _TypeLoadRegistry.end(), "You must register component types before creating them!");
 
-			// Iterate over all the components in the store
-			for (auto& wptr : _Components[type]) {
-				// Lock the weak pointer to get a shared pointer (maybe)
-				std::shared_ptr<IComponent> sptr = wptr.lock();
-				// If the pointer is alive and matches our enabled criteria, invoke the callback
-				if (sptr && sptr->IsEnabled | includeDisabled) {
-					// Upcast to component type and invoke the callback
-					callback(std::dynamic_pointer_cast<ComponentType>(sptr));
+			ComponentPool<ComponentType>* pool = _GetPool<ComponentType>();
+			if (pool == nullptr) {
+				return;
+			}
+
+			if constexpr (std::is_invocable_v<Func, ComponentType*>) {
+				pool->Each(callback, includeDisabled);
+			} else {
+				pool->Each([&](ComponentType* component) {
+					callback(std::static_pointer_cast<ComponentType>(component->SelfRef().lock()));
+				}, includeDisabled);
+			}
+		}
+
+		/// <summary>
+		/// Calls Update on every enabled component whose type declared its Update as thread safe
+		/// (see IComponent::IsUpdateThreadSafe), one type at a time, with each type's components
+		/// spread across the job system
+		/// </summary>
+		/// <param name="deltaTime">The time since the last frame, in seconds</param>
+		inline void UpdateParallel(float deltaTime) {
+			_isUpdatingInParallel = true;
+			for (auto& [type, pool] : _pools) {
+				if (_TypeUpdateModeRegistry[type] == ComponentUpdateMode::Parallel) {
+					pool->ParallelUpdate(deltaTime);
 				}
 			}
+			_isUpdatingInParallel = false;
 		}
 
+		/// <summary>
+		/// Returns true while UpdateParallel is running, during which components must not be
+		/// created or destroyed
+		/// </summary>
+		bool IsUpdatingInParallel() const { return _isUpdatingInParallel; }
+
 		/// <summary>
 		/// Attempts to register a given type as a component, should be called for each component type 
 		/// at the start of you application
@@ -220,6 +332,7 @@ namespace Gameplay {
 		static void RegisterType() {
 			// Make sure the component type is valid (see bottom of IComponent.h)
 			static_assert(is_valid_component<T>(), "Type is not a valid component type!");
+			static_assert(std::is_copy_constructible<T>::value, "Component types must be copy constructible so that prefabs can clone them!");
 
 			// We use the type ID to map types to the underlying helpers
 			std::type_index type(typeid(T));
@@ -230,6 +343,11 @@ namespace Gameplay {
 				// name to type index mapping
 				_TypeLoadRegistry[type] = &ComponentManager::ParseTypeFromBlob<T>;
 				_TypeCreateRegistry[type] = &ComponentManager::_InternalCreate<T>;
+				_TypeCloneRegistry[type] = &ComponentManager::_InternalClone<T>;
+				_TypePoolRegistry[type] = &ComponentManager::_CreatePool<T>;
+				_TypeUpdateModeRegistry[type] = _GetUpdateMode<T>();
+				// Make sure the type has an ID, so game objects can look it up from its type_index
+				ComponentTypeIds::Get<T>();
 				_TypeNameMap[StringTools::SanitizeClassName(typeid(T).name())] = type;
 			}
 		}
@@ -238,7 +356,7 @@ namespace Gameplay {
 		/// Removes all components of all types from the registry, whether they are referenced elsewhere or not
 		/// </summary>
 		inline void FlushAll() {
-			_Components = std::unordered_map<std::type_index, std::vector<std::weak_ptr<IComponent>>>();
+			Clear();
 		}
 
 	private:
@@ -253,11 +371,61 @@ namespace Gameplay {
 		inline static std::unordered_map<std::type_index, LoadComponentFunc> _TypeLoadRegistry;
 		// Stores functions to load components from JSON, indexed on the type that they load
 		inline static std::unordered_map<std::type_index, CreateComponentFunc> _TypeCreateRegistry;
+		// Stores functions to copy construct components, indexed on the type that they copy
+		inline static std::unordered_map<std::type_index, CloneComponentFunc> _TypeCloneRegistry;
+		// Stores functions to create the typed component pool, indexed on the type stored in the pool
+		inline static std::unordered_map<std::type_index, CreatePoolFunc> _TypePoolRegistry;
+		// Stores how each type's Update should be invoked
+		inline static std::unordered_map<std::type_index, ComponentUpdateMode> _TypeUpdateModeRegistry;
+
+		// The pools only store raw pointers, components are owned by their game objects. Components
+		// remove themselves from their pool in their destructor (see Remove)
+		std::unordered_map<std::type_index, std::unique_ptr<IComponentPool>> _pools;
+		bool _isUpdatingInParallel = false;
+
+		/// <summary>
+		/// Works out how a component type's Update should be invoked. Types that don't override
+		/// Update still have IComponent's version, so we can skip them entirely
+		/// </summary>
+		template <typename T>
+		static constexpr ComponentUpdateMode _GetUpdateMode() {
+			if constexpr (!overrides_update<T>()) {
+				return ComponentUpdateMode::None;
+			} else if constexpr (T::IsUpdateThreadSafe) {
+				return ComponentUpdateMode::Parallel;
+			} else {
+				return ComponentUpdateMode::Serial;
+			}
+		}
 
-		// Weak pointers let us store a reference to an object stored by a shared pointer, without
-		// actually increasing the reference count. Thus components will be destroyed at the correct
-		// time (when the only reference is the one stored here).
-		std::unordered_map<std::type_index, std::vector<std::weak_ptr<IComponent>>> _Components;  
+		template <typename T>
+		static std::unique_ptr<IComponentPool> _CreatePool() {
+			return std::make_unique<ComponentPool<T>>();
+		}
+
+		/// <summary>
+		/// Gets the pool for the given component type, or nullptr if no components of that type
+		/// have been created yet
+		/// </summary>
+		template <typename ComponentType>
+		ComponentPool<ComponentType>* _GetPool() {
+			auto it = _pools.find(std::type_index(typeid(ComponentType)));
+			return it != _pools.end() ? static_cast<ComponentPool<ComponentType>*>(it->second.get()) : nullptr;
+		}
+
+		/// <summary>
+		/// Adds a component to the pool for it's real type, creating the pool if needed
+		/// </summary>
+		inline void _Register(IComponent* component) {
+			LOG_ASSERT(!_isUpdatingInParallel, "Components can't be created during parallel updates, use Scene::Commands instead");
+			std::unique_ptr<IComponentPool>& pool = _pools[component->_realType];
+			if (pool == nullptr) {
+				pool = _TypePoolRegistry[component->_realType]();
+			}
+			component->_handle = pool->Add(component);
+			component->_manager = this;
+			component->_updateMode = _TypeUpdateModeRegistry[component->_realType];
+		}
 
 		template <typename T>
 		static IComponent::Sptr ParseTypeFromBlob(const nlohmann::json& blob) {
@@ -270,8 +438,8 @@ namespace Gameplay {
 			std::type_index type = std::type_index(typeid(ComponentType));
 			LOG_ASSERT(_TypeLoadRegistry[type] != nullptr, "You must register component types before creating them!");
 
-			// Create component, forwarding arguments
-			std::shared_ptr<ComponentType> component = std::make_shared<ComponentType>();
+			// Create component from the type's slab
+			std::shared_ptr<ComponentType> component = std::allocate_shared<ComponentType>(ComponentAllocator<ComponentType>());
 
 			// Make sure the component knows it's concrete type
 			component->_realType = type;
@@ -282,29 +450,23 @@ namespace Gameplay {
 			return component;
 		}
 
+		template <typename ComponentType>
+		static IComponent::Sptr _InternalClone(const IComponent& source) {
+			// Copies come from the same slab as every other component of the type
+			return std::allocate_shared<ComponentType>(ComponentAllocator<ComponentType>(), static_cast<const ComponentType&>(source));
+		}
+
 		/// <summary>
 		/// Removes a given component from the global pools. To be used in the IComponent destructor
 		/// </summary>
-		/// <typeparam name="ComponentType">The type of component to destroy</typeparam>
 		/// <param name="component">A raw pointer to the component to remove (should be called from IComponent destructor)</param>
-		/// <returns>True if the element was removed, false if not</returns>
-		inline void Remove(const IComponent* component) {
-			if (_Components.size() == 0) return;
-
-			// Make sure the component's type was one that was registered
-			LOG_ASSERT(_TypeLoadRegistry[component->_realType] != nullptr, "You must register component types before creating them!");
-
-			
-			// Get a reference to the vector of components for easy access
-			std::vector<std::weak_ptr<IComponent>>& componentStore = _Components[component->_realType];
-
-			// Clear any dead weak pointers
-			auto it = std::remove_if(componentStore.begin(), componentStore.end(), [](const std::weak_ptr<IComponent>& ptr) {
-				return ptr.expired();
-				});
-			if (it != componentStore.end()) {
-				componentStore.erase(it);
+		inline void Remove(IComponent* component) {
+			auto it = _pools.find(component->_realType);
+			if (it != _pools.end()) {
+				it->second->Remove(component->_handle);
 			}
+			component->_handle = ComponentHandle();
+			component->_manager = nullptr;
 		}
 	};
 }
\ No newline at end of file
@@ -0,0 +1,333 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <new>
+#include <vector>
+
+#include "Utils/JobSystem.h"
+
+namespace Gameplay {
+	class IComponent;
+
+	/// <summary>
+	/// A stable reference to a component in a ComponentPool. Unlike the component's position
+	/// in the pool, the handle does not change when other components are removed, and a handle
+	/// to a removed component will never resolve to a component that re-uses its slot
+	/// </summary>
+	struct ComponentHandle {
+		static const uint32_t INVALID_INDEX = UINT32_MAX;
+
+		// The slot in the pool's handle table
+		uint32_t Index = INVALID_INDEX;
+		// Incremented every time the slot is freed, so stale handles can be detected
+		uint32_t Generation = 0;
+
+		bool IsValid() const { return Index != INVALID_INDEX; }
+
+		bool operator ==(const ComponentHandle& other) const { return Index == other.Index && Generation == other.Generation; }
+		bool operator !=(const ComponentHandle& other) const { return !(*this == other); }
+	};
+
+	/// <summary>
+	/// Hands out fixed size blocks for a single type out of large chunks, so that objects
+	/// of the same type end up next to each other in memory instead of scattered across
+	/// the heap. Chunks are never returned to the OS, freed blocks are re-used instead
+	/// </summary>
+	/// <typeparam name="T">The type to allocate blocks for</typeparam>
+	template <typename T>
+	class ComponentSlab {
+	public:
+		static void* Allocate() {
+			if (_freeList == nullptr) {
+				_Grow();
+			}
+			FreeBlock* block = _freeList;
+			_freeList = block->Next;
+			return block;
+		}
+
+		static void Free(void* ptr) {
+			FreeBlock* block = static_cast<FreeBlock*>(ptr);
+			block->Next = _freeList;
+			_freeList = block;
+		}
+
+	private:
+		struct FreeBlock {
+			FreeBlock* Next;
+		};
+
+		static constexpr size_t ALIGN = alignof(T) > alignof(FreeBlock) ? alignof(T) : alignof(FreeBlock);
+		static constexpr size_t SIZE  = sizeof(T) > sizeof(FreeBlock) ? sizeof(T) : sizeof(FreeBlock);
+		static constexpr size_t BLOCK_SIZE = ((SIZE + ALIGN - 1) / ALIGN) * ALIGN;
+		static constexpr size_t BLOCKS_PER_CHUNK = 64;
+
+		// Note that this is deliberately a plain pointer, so that components that outlive static
+		// destruction can still be freed
+		inline static FreeBlock* _freeList = nullptr;
+
+		static void _Grow() {
+			uint8_t* chunk = static_cast<uint8_t*>(::operator new(BLOCK_SIZE * BLOCKS_PER_CHUNK, std::align_val_t(ALIGN)));
+			// Push the blocks in reverse, so that allocations walk forward through the chunk
+			for (size_t ix = BLOCKS_PER_CHUNK; ix > 0; ix--) {
+				Free(chunk + (ix - 1) * BLOCK_SIZE);
+			}
+		}
+	};
+
+	/// <summary>
+	/// Allocator for use with std::allocate_shared, which places the component and its
+	/// control block in a ComponentSlab
+	/// </summary>
+	template <typename T>
+	struct ComponentAllocator {
+		typedef T value_type;
+
+		ComponentAllocator() = default;
+		template <typename U>
+		ComponentAllocator(const ComponentAllocator<U>&) { }
+
+		T* allocate(size_t count) {
+			if (count == 1) {
+				return static_cast<T*>(ComponentSlab<T>::Allocate());
+			}
+			return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(alignof(T))));
+		}
+
+		void deallocate(T* ptr, size_t count) {
+			if (count == 1) {
+				ComponentSlab<T>::Free(ptr);
+			} else {
+				::operator delete(ptr, std::align_val_t(alignof(T)));
+			}
+		}
+
+		template <typename U>
+		bool operator ==(const ComponentAllocator<U>&) const { return true; }
+		template <typename U>
+		bool operator !=(const ComponentAllocator<U>&) const { return false; }
+	};
+
+	/// <summary>
+	/// Type erased interface to a ComponentPool, so that the ComponentManager can add and
+	/// remove components when it only knows their type_index
+	/// </summary>
+	class IComponentPool {
+	public:
+		virtual ~IComponentPool() = default;
+
+		/// <summary>
+		/// Adds a component to the pool, the component's real type must match the pool's type
+		/// </summary>
+		/// <returns>The handle to the component within this pool</returns>
+		virtual ComponentHandle Add(IComponent* component) = 0;
+		/// <summary>
+		/// Removes the component with the given handle, does nothing if the handle is stale
+		/// </summary>
+		virtual void Remove(ComponentHandle handle) = 0;
+		/// <summary>
+		/// Gets the component with the given handle, or nullptr if the handle is stale
+		/// </summary>
+		virtual IComponent* Get(ComponentHandle handle) const = 0;
+		/// <summary>
+		/// Gets all the components currently in the pool
+		/// </summary>
+		virtual void GetAll(std::vector<IComponent*>& result) const = 0;
+		/// <summary>
+		/// Removes all components from the pool
+		/// </summary>
+		virtual void Clear() = 0;
+		/// <summary>
+		/// Calls Update on all enabled components in the pool, spread across the job system
+		/// </summary>
+		virtual void ParallelUpdate(float deltaTime) = 0;
+	};
+
+	/// <summary>
+	/// Stores pointers to all components of a single type in a dense array, so that iterating
+	/// over them doesn't need to lock weak pointers or cast. Removal swaps the last component
+	/// into the removed slot, and a handle table keeps handles valid as components move
+	/// </summary>
+	/// <typeparam name="T">The concrete component type stored in the pool</typeparam>
+	template <typename T>
+	class ComponentPool final : public IComponentPool {
+	public:
+		ComponentPool() = default;
+		virtual ~ComponentPool() = default;
+
+		virtual ComponentHandle Add(IComponent* component) override {
+			// Re-use a free slot if we have one, otherwise add a new one
+			uint32_t slotIx;
+			if (!_freeSlots.empty()) {
+				slotIx = _freeSlots.back();
+				_freeSlots.pop_back();
+			} else {
+				slotIx = static_cast<uint32_t>(_slots.size());
+				_slots.push_back(Slot());
+			}
+
+			Slot& slot = _slots[slotIx];
+			slot.DenseIndex = static_cast<uint32_t>(_dense.size());
+
+			// The component's real type is T, so this is just a pointer adjustment
+			_dense.push_back(static_cast<T*>(component));
+			_denseToSlot.push_back(slotIx);
+
+			ComponentHandle result;
+			result.Index = slotIx;
+			result.Generation = slot.Generation;
+			return result;
+		}
+
+		virtual void Remove(ComponentHandle handle) override {
+			if (!_IsLive(handle)) {
+				return;
+			}
+
+			Slot& slot = _slots[handle.Index];
+			uint32_t denseIx = slot.DenseIndex;
+
+			// Retire the slot so that the handle goes stale
+			slot.Generation++;
+			slot.DenseIndex = INVALID_DENSE;
+			_freeSlots.push_back(handle.Index);
+
+			// We can't move things around while someone is iterating, so we leave a hole that
+			// will be compacted once iteration has finished
+			if (_iterationDepth > 0) {
+				_dense[denseIx] = nullptr;
+				_denseToSlot[denseIx] = INVALID_DENSE;
+				_hasHoles = true;
+			} else {
+				_SwapRemove(denseIx);
+			}
+		}
+
+		virtual IComponent* Get(ComponentHandle handle) const override {
+			return _IsLive(handle) ? _dense[_slots[handle.Index].DenseIndex] : nullptr;
+		}
+
+		/// <summary>
+		/// Gets the typed component with the given handle, or nullptr if the handle is stale
+		/// </summary>
+		T* GetTyped(ComponentHandle handle) const {
+			return _IsLive(handle) ? _dense[_slots[handle.Index].DenseIndex] : nullptr;
+		}
+
+		virtual void GetAll(std::vector<IComponent*>& result) const override {
+			result.reserve(result.size() + _dense.size());
+			for (T* component : _dense) {
+				if (component != nullptr) {
+					result.push_back(component);
+				}
+			}
+		}
+
+		virtual void Clear() override {
+			_dense.clear();
+			_denseToSlot.clear();
+			_slots.clear();
+			_freeSlots.clear();
+			_hasHoles = false;
+		}
+
+		virtual void ParallelUpdate(float deltaTime) override {
+			// Hold the iteration open, so that anything removed while the workers are running leaves
+			// a hole instead of moving components around underneath them
+			_iterationDepth++;
+			T* const* components = _dense.data();
+			JobSystem::ParallelFor(static_cast<uint32_t>(_dense.size()), PARALLEL_BATCH_SIZE, [=](uint32_t start, uint32_t end) {
+				for (uint32_t ix = start; ix < end; ix++) {
+					T* component = components[ix];
+					if (component != nullptr && component->IsEnabled) {
+						// Go through the base, since components are allowed to hide Update with their own overloads
+						static_cast<IComponent*>(component)->Update(deltaTime);
+					}
+				}
+			});
+			_iterationDepth--;
+
+			if (_iterationDepth == 0 && _hasHoles) {
+				_Compact();
+			}
+		}
+
+		/// <summary>
+		/// Gets the number of components in the pool
+		/// </summary>
+		size_t Size() const { return _dense.size(); }
+
+		/// <summary>
+		/// Invokes the callback with a pointer to every component in the pool. Components may be
+		/// removed from inside the callback, components added inside the callback will not be visited
+		/// </summary>
+		/// <param name="callback">The callback to invoke, with the signature void(T*)</param>
+		/// <param name="includeDisabled">True to include disabled components</param>
+		template <typename Func>
+		void Each(Func&& callback, bool includeDisabled) {
+			_iterationDepth++;
+			const size_t count = _dense.size();
+			for (size_t ix = 0; ix < count; ix++) {
+				T* component = _dense[ix];
+				if (component != nullptr && (component->IsEnabled || includeDisabled)) {
+					callback(component);
+				}
+			}
+			_iterationDepth--;
+
+			if (_iterationDepth == 0 && _hasHoles) {
+				_Compact();
+			}
+		}
+
+	private:
+		static const uint32_t INVALID_DENSE = UINT32_MAX;
+		// The number of components that each job in ParallelUpdate handles
+		static const uint32_t PARALLEL_BATCH_SIZE = 64;
+
+		struct Slot {
+			uint32_t DenseIndex = INVALID_DENSE;
+			uint32_t Generation = 0;
+		};
+
+		// The components, packed with no gaps (outside of iteration)
+		std::vector<T*>       _dense;
+		// Maps an index in _dense back to the slot that refers to it
+		std::vector<uint32_t> _denseToSlot;
+		// The handle table, indexed by ComponentHandle::Index
+		std::vector<Slot>     _slots;
+		std::vector<uint32_t> _freeSlots;
+
+		int  _iterationDepth = 0;
+		bool _hasHoles = false;
+
+		bool _IsLive(ComponentHandle handle) const {
+			return handle.Index < _slots.size() &&
+				_slots[handle.Index].Generation == handle.Generation &&
+				_slots[handle.Index].DenseIndex != INVALID_DENSE;
+		}
+
+		void _SwapRemove(uint32_t denseIx) {
+			uint32_t lastIx = static_cast<uint32_t>(_dense.size() - 1);
+			if (denseIx != lastIx) {
+				_dense[denseIx] = _dense[lastIx];
+				_denseToSlot[denseIx] = _denseToSlot[lastIx];
+				if (_denseToSlot[denseIx] != INVALID_DENSE) {
+					_slots[_denseToSlot[denseIx]].DenseIndex = denseIx;
+				}
+			}
+			_dense.pop_back();
+			_denseToSlot.pop_back();
+		}
+
+		void _Compact() {
+			// Walk backwards so that every swap pulls in an element we've already checked
+			for (size_t ix = _dense.size(); ix > 0; ix--) {
+				if (_dense[ix - 1] == nullptr) {
+					_SwapRemove(static_cast<uint32_t>(ix - 1));
+				}
+			}
+			_hasHoles = false;
+		}
+	};
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <cstdint>
+#include <typeindex>
+#include <unordered_map>
+#include <Logging.h>
+
+namespace Gameplay {
+	/// <summary>
+	/// A small, dense integer that identifies a component type, used to index into
+	/// per-object component tables
+	/// </summary>
+	typedef uint32_t ComponentTypeId;
+	/// <summary>
+	/// A bitmask with one bit per ComponentTypeId
+	/// </summary>
+	typedef uint64_t ComponentMask;
+
+	/// <summary>
+	/// Hands out ComponentTypeIds. The templated Get caches the ID in a function static, so
+	/// after the first call for a type it's a single load, the type_index overload is for
+	/// code that only knows the type at runtime (ex: the editor)
+	/// </summary>
+	class ComponentTypeIds {
+	public:
+		// The number of component types we can have, limited by the number of bits in ComponentMask
+		static const uint32_t MAX_COMPONENT_TYPES = 64;
+		static const ComponentTypeId INVALID = UINT32_MAX;
+
+		/// <summary>
+		/// Gets the ID for the given component type, assigning one if it does not have one yet
+		/// </summary>
+		template <typename T>
+		static ComponentTypeId Get() {
+			static const ComponentTypeId id = _Assign(std::type_index(typeid(T)));
+			return id;
+		}
+
+		/// <summary>
+		/// Gets the ID for the given component type, or INVALID if the type has not been assigned one
+		/// </summary>
+		static ComponentTypeId Get(const std::type_index& type) {
+			auto it = _ids.find(type);
+			return it != _ids.end() ? it->second : INVALID;
+		}
+
+		/// <summary>
+		/// Gets the mask bit for the given component type ID
+		/// </summary>
+		static ComponentMask MaskOf(ComponentTypeId id) {
+			return id < MAX_COMPONENT_TYPES ? (ComponentMask(1) << id) : 0;
+		}
+
+	private:
+		inline static std::unordered_map<std::type_index, ComponentTypeId> _ids;
+
+		static ComponentTypeId _Assign(const std::type_index& type) {
+			auto it = _ids.find(type);
+			if (it != _ids.end()) {
+				return it->second;
+			}
+			ComponentTypeId result = static_cast<ComponentTypeId>(_ids.size());
+			LOG_ASSERT(result < MAX_COMPONENT_TYPES, "Too many component types, increase the size of ComponentMask");
+			_ids[type] = result;
+			return result;
+		}
+	};
+}
@@ -28,10 +28,16 @@ namespace Gameplay {
 		IResource(),
 		IsEnabled(true),
 		_realType(typeid(IComponent)),
-		_context(nullptr)
+		_context(nullptr),
+		_handle(ComponentHandle()),
+		_manager(nullptr),
+		_updateMode(ComponentUpdateMode::Serial)
 	{ }
 
 	IComponent::~IComponent() {
-		_context->GetScene()->Components().Remove(this);
+		// The manager may have been cleared before we were destroyed, in which case it has already forgotten us
+		if (_manager != nullptr) {
+			_manager->Remove(this);
+		}
 	}
 }
@@ -8,16 +8,32 @@
 #include "Utils/ResourceManager/ResourceManager.h"
 #include "Utils/ResourceManager/IResource.h"
 #include "Utils/TypeHelpers.h"
+#include "Gameplay/Components/ComponentPool.h"
 
 namespace Gameplay {
 	// We pre-declare GameObject to avoid circular dependencies in the headers
 	class GameObject;
+	class ComponentManager;
+	class Prefab;
 
 	namespace Physics {
 		class TriggerVolume;
 		class RigidBody;
 	}
 
+	/// <summary>
+	/// Describes how the scene invokes Update for a component type, this is worked out when
+	/// the type is registered with the ComponentManager
+	/// </summary>
+	enum class ComponentUpdateMode : uint8_t {
+		// The type does not override Update, so it is never called
+		None     = 0,
+		// Update is called on the main thread, object by object
+		Serial   = 1,
+		// Update is called in parallel batches with every other component of the same type
+		Parallel = 2
+	};
+
 	/// <summary>
 	/// Base class for components that can be attached to game objects
 	/// 
@@ -93,6 +109,26 @@ namespace Gameplay {
 		/// <param name="context">The game object that the component belongs to</param>
 		virtual void Awake() { };
 
+		/// <summary>
+		/// Invoked when the game object is deactivated, for instance when it is returned to an
+		/// object pool. Components should withdraw anything other systems can see, like physics bodies
+		/// </summary>
+		virtual void OnDeactivated() { };
+		/// <summary>
+		/// Invoked when a deactivated game object is activated again, the object will already be
+		/// at its new position
+		/// </summary>
+		virtual void OnActivated() { };
+
+		/// <summary>
+		/// Components can set this to true in their own class to declare that their Update is thread
+		/// safe, in which case the scene will update all components of that type in parallel. A thread
+		/// safe Update may only modify the component itself and the local transform of its own game object,
+		/// structural changes (creating or removing objects, adding components) must go through
+		/// Scene::Commands
+		/// </summary>
+		static constexpr bool IsUpdateThreadSafe = false;
+
 		/// <summary>
 		/// Invoked during the update loop
 		/// </summary>
@@ -153,16 +189,29 @@ namespace Gameplay {
 		/// </summary>
 		std::weak_ptr<IComponent>& SelfRef();
 
+		/// <summary>
+		/// Gets the handle to this component in the scene's component pools, which can be
+		/// resolved with ComponentManager::Get
+		/// </summary>
+		ComponentHandle GetHandle() const { return _handle; }
+
 	protected:
 		IComponent();
 
 	private:
 		friend class ComponentManager;
 		friend class GameObject;
+		friend class Prefab;
 
 		std::type_index _realType;
 		GameObject* _context;
 
+		// Our entry in the component pools, and the manager that owns those pools
+		ComponentHandle   _handle;
+		ComponentManager* _manager;
+		// How the scene should invoke our Update, copied from our type's registration
+		ComponentUpdateMode _updateMode;
+
 		// By storing a weak pointer to ourselves, we can pass a pointer to this
 		// for things like bullet user pointers
 		std::weak_ptr<IComponent> _weakSelfPtr;
@@ -179,6 +228,31 @@ namespace Gameplay {
 	constexpr bool is_valid_component() {
 		return std::is_base_of<IComponent, T>::value && test_json<T, const nlohmann::json&>::value;
 	}
+
+	namespace detail {
+		// Gets the class that declares a void(float) member function pointer, or void for anything else
+		template <typename F>
+		struct update_owner { typedef void type; };
+		template <typename C>
+		struct update_owner<void (C::*)(float)> { typedef C type; };
+
+		template <typename T, typename = void>
+		struct overrides_update : std::true_type {};
+		template <typename T>
+		struct overrides_update<T, std::void_t<decltype(&T::Update)>> : std::bool_constant<
+			!std::is_void<typename update_owner<decltype(&T::Update)>::type>::value &&
+			!std::is_same<typename update_owner<decltype(&T::Update)>::type, IComponent>::value> {};
+	}
+
+	/// <summary>
+	/// Returns true if the given component type overrides IComponent::Update. Types with more
+	/// than one Update overload are assumed to override it
+	/// </summary>
+	/// <typeparam name="T">The type to check</typeparam>
+	template <typename T>
+	constexpr bool overrides_update() {
+		return detail::overrides_update<T>::value;
+	}
 }
 
 // Defines the ComponentTypeName interface to match those used elsewhere by other systems
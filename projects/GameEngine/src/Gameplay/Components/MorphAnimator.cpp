@@ -9,7 +9,8 @@ MorphAnimator::MorphAnimator()
 	: IComponent(),
 	switchClip(false),
 	reachedEnd(false),
-	timer(0.0f)
+	timer(0.0f),
+	blend(0.0f)
 { }
 
 MorphAnimator::~MorphAnimator() = default;
@@ -17,6 +18,18 @@ MorphAnimator::~MorphAnimator() = default;
 void MorphAnimator::Awake()
 {
 	thisObject = this->GetComponent<RenderComponent>()->GetMesh();
+
+	// The vertices get blended between frames, so grow the mesh bounds to cover
+	// every frame of every clip, otherwise the mesh could get culled mid-animation
+	if (thisObject != nullptr) {
+		Bounds bounds = thisObject->GetBounds();
+		for (const animInfo& clip : animClips) {
+			for (const auto& frame : clip.frames) {
+				bounds.Encapsulate(frame->GetBounds());
+			}
+		}
+		thisObject->SetBounds(bounds);
+	}
 }
 
 void MorphAnimator::Update(float deltaTime)
@@ -76,10 +89,16 @@ void MorphAnimator::Update(float deltaTime)
 	thisObject->AddVertexBuffer(currentClip.frames[currentClip.currentFrame]->Mesh->GetBufferBinding(AttribUsage::Position)->GetBuffer(), pos0);
 	thisObject->AddVertexBuffer(currentClip.frames[currentClip.nextFrame]->Mesh->GetBufferBinding(AttribUsage::Position)->GetBuffer(), pos1);
 
-	//Pass the lerp param as a uniform
+	//Pass the lerp param as a uniform, and keep it around for passes that don't use the material
+	blend = t;
 	this->GetComponent<RenderComponent>()->GetMaterial()->Set("t", t);
 }
 
+float MorphAnimator::GetBlend() const
+{
+	return blend;
+}
+
 void MorphAnimator::AddClip(std::vector<Gameplay::MeshResource::Sptr> inFrames, float dur, std::string inName)
 {
 	animInfo clip;
@@ -23,6 +23,9 @@ public:
 
 	std::string GetActiveAnim();
 
+	//Gets the blend factor between the current and next frame, the same value that is sent to the material as "t"
+	float GetBlend() const;
+
 	//Holds the info for an animation clip
 	struct animInfo
 	{
@@ -53,6 +56,7 @@ protected:
 	animInfo currentClip;
 
 	float timer;
+	float blend;
 
 	bool switchClip;
 	bool reachedEnd = false;
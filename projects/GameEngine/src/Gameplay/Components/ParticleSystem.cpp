@@ -4,6 +4,7 @@
 #include "Application/Application.h"
 #include "Utils/ImGuiHelper.h"
 #include "Graphics/DebugDraw.h"
+#include "Graphics/GlStateCache.h"
 #include "imgui_internal.h"
 
 ParticleSystem::ParticleSystem() :
@@ -53,7 +54,7 @@ void ParticleSystem::Update()
 		size_t dataSize = (_maxParticles + _emitters.size()) * sizeof(ParticleData);
 
 		for (int ix = 0; ix < 2; ix++) {
-			glBindVertexArray(_updateVaos[ix]);
+			GlStateCache::BindVertexArray(_updateVaos[ix]);
 
 			// Set up our first transform feedback buffer to write to the first buffer
 			glBindTransformFeedback(GL_TRANSFORM_FEEDBACK, _feedbackBuffers[ix]);
@@ -81,7 +82,7 @@ void ParticleSystem::Update()
 			glVertexAttribPointer(7, 4, GL_FLOAT, GL_FALSE, sizeof(ParticleData), (const GLvoid*)offsetof(ParticleData, Metadata2)); // metadata 
 
 
-			glBindVertexArray(_renderVaos[ix]);
+			GlStateCache::BindVertexArray(_renderVaos[ix]);
 			glBindBuffer(GL_ARRAY_BUFFER, _particleBuffers[ix]);
 
 			// Enable type, position and color 
@@ -99,7 +100,7 @@ void ParticleSystem::Update()
 			glVertexAttribPointer(7, 4, GL_FLOAT, GL_FALSE, sizeof(ParticleData), (const GLvoid*)offsetof(ParticleData, Metadata2)); // metadata 
 		}
 
-		glBindVertexArray(0);
+		GlStateCache::BindVertexArray(0);
 
 
 		// We create a query object to track the number of particles we're simulating
@@ -115,7 +116,7 @@ void ParticleSystem::Update()
 	}
 
 	if (_needsUpload) {
-		glBindVertexArray(0);
+		GlStateCache::BindVertexArray(0);
 
 		// Allocate some temp space for particles, so we can init the emitters
 		size_t dataSize = (_emitters.size()) * sizeof(ParticleData);
@@ -144,7 +145,7 @@ void ParticleSystem::Update()
 	_updateShader->SetUniform("u_Gravity", _gravity); 
 	_updateShader->SetUniformMatrix("u_ModelMatrix", GetGameObject()->GetTransform()); 
 
-	glBindVertexArray(_updateVaos[_currentVertexBuffer]);
+	GlStateCache::BindVertexArray(_updateVaos[_currentVertexBuffer]);
 
 	// Bind the buffer and transform feedback
 	glBindTransformFeedback(GL_TRANSFORM_FEEDBACK, _feedbackBuffers[_currentFeedbackBuffer]);
@@ -178,7 +179,7 @@ void ParticleSystem::Update()
 	// Clean up our state
 	glBindTransformFeedback(GL_TRANSFORM_FEEDBACK, 0);
 
-	glBindVertexArray(0);
+	GlStateCache::BindVertexArray(0);
 
 	// Re-enable rasterization for later OpenGL calls
 	glDisable(GL_RASTERIZER_DISCARD);
@@ -204,7 +205,7 @@ void ParticleSystem::Render()
 		_renderShader->Bind();
 
 		// Make sure no VAOs are bound
-		glBindVertexArray(_renderVaos[_currentVertexBuffer]);
+		GlStateCache::BindVertexArray(_renderVaos[_currentVertexBuffer]);
 
 		//glDisable(GL_DEPTH_TEST);
 		
@@ -220,7 +221,7 @@ void ParticleSystem::Render()
 		// Draw our particles using whatever data we have in transform feedback buffer
 		glDrawTransformFeedback(GL_POINTS, _feedbackBuffers[_currentVertexBuffer]);
 
-		glBindVertexArray(0);
+		GlStateCache::BindVertexArray(0);
 
 		glEnable(GL_DEPTH_TEST);
 	}
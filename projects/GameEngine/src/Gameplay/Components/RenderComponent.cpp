@@ -2,17 +2,20 @@
 
 #include "Utils/ResourceManager/ResourceManager.h"
 #include "Utils/ImGuiHelper.h"
+#include "Utils/JsonGlmHelpers.h"
 
 
 RenderComponent::RenderComponent(const Gameplay::MeshResource::Sptr& mesh, const Gameplay::Material::Sptr& material) :
 	_mesh(mesh), 
 	_material(material), 
+	_castsShadows(true),
 	_meshBuilderParams(std::vector<MeshBuilderParam>()) 
 { }
 
 RenderComponent::RenderComponent() : 
 	_mesh(nullptr), 
 	_material(nullptr), 
+	_castsShadows(true),
 	_meshBuilderParams(std::vector<MeshBuilderParam>())
 { }
 
@@ -38,10 +41,20 @@ const Gameplay::Material::Sptr& RenderComponent::GetMaterial() const {
 	return _material;
 }
 
+bool RenderComponent::GetCastsShadows() const {
+	return _castsShadows;
+}
+
+RenderComponent* RenderComponent::SetCastsShadows(bool value) {
+	_castsShadows = value;
+	return this;
+}
+
 nlohmann::json RenderComponent::ToJson() const {
 	nlohmann::json result;
 	result["mesh"] = _mesh ? _mesh->GetGUID().str() : "null";
 	result["material"] = _material ? _material->GetGUID().str() : "null";
+	result["casts_shadows"] = _castsShadows;
 	return result;
 }
 
@@ -49,6 +62,7 @@ RenderComponent::Sptr RenderComponent::FromJson(const nlohmann::json& data) {
 	RenderComponent::Sptr result = std::make_shared<RenderComponent>();
 	result->_mesh = ResourceManager::Get<Gameplay::MeshResource>(Guid(data["mesh"].get<std::string>()));
 	result->_material = ResourceManager::Get<Gameplay::Material>(Guid(data["material"].get<std::string>()));
+	result->_castsShadows = JsonGet(data, "casts_shadows", result->_castsShadows);
 
 	return result;
 }
@@ -60,4 +74,5 @@ void RenderComponent::RenderImGui() {
 	ImGui::Separator();
 	ImGui::Text("Material:  %s", _material != nullptr ? _material->Name.c_str() : "NULL");
 	ImGuiHelper::ResourceDragTarget<Gameplay::Material>(_material);
+	ImGui::Checkbox("Casts Shadows", &_castsShadows);
 }
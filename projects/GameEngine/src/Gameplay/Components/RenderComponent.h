@@ -42,6 +42,16 @@ public:
 	/// <param name="mat">The material for this object</param>
 	RenderComponent* SetMaterial(const Gameplay::Material::Sptr& mat);
 
+	/// <summary>
+	/// Gets whether this object should be drawn into shadow maps
+	/// </summary>
+	bool GetCastsShadows() const;
+	/// <summary>
+	/// Sets whether this object should be drawn into shadow maps, defaults to true
+	/// </summary>
+	/// <param name="value">True if the object should cast shadows, false if otherwise</param>
+	RenderComponent* SetCastsShadows(bool value);
+
 	// Inherited from IComponent
 
 	virtual void RenderImGui() override;
@@ -54,6 +64,8 @@ protected:
 	Gameplay::MeshResource::Sptr _mesh;
 	// The object's material
 	Gameplay::Material::Sptr      _material;
+	// True if the object should be drawn by shadow casting lights
+	bool                          _castsShadows;
 
 	// If we want to use MeshFactory, we can populate this list
 	std::vector<MeshBuilderParam> _meshBuilderParams;
@@ -11,6 +11,9 @@ public:
 	RotatingBehaviour() = default;
 	glm::vec3 RotationSpeed;
 
+	// We only ever touch our own object's rotation
+	static constexpr bool IsUpdateThreadSafe = true;
+
 	virtual void Update(float deltaTime) override;
 
 	virtual void RenderImGui() override;
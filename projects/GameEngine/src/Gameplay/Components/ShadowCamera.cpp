@@ -16,7 +16,10 @@ ShadowCamera::ShadowCamera() :
 	_projectionMask(nullptr),
 	_color(glm::vec4(1.0f)),
 	_bufferResolution(glm::ivec2(512)), 
-	_projectionMatrix(glm::perspective(glm::radians(90.0f), 1.0f, 0.1f, 100.0f))
+	_projectionMatrix(glm::perspective(glm::radians(90.0f), 1.0f, 0.1f, 100.0f)),
+	_lastViewProjection(glm::mat4(1.0f)),
+	_lastCasterSignature(0),
+	_isShadowMapDirty(true)
 { }
 
 ShadowCamera::~ShadowCamera() = default;
@@ -35,6 +38,7 @@ void ShadowCamera::SetBufferResolution(const glm::ivec2& value) {
 	if (_depthBuffer != nullptr) {
 		_depthBuffer->Resize(value);
 	}
+	InvalidateShadowMap();
 }
 
 const glm::ivec2& ShadowCamera::GetBufferResolution() const {
@@ -43,6 +47,7 @@ const glm::ivec2& ShadowCamera::GetBufferResolution() const {
 
 void ShadowCamera::SetProjection(const glm::mat4& value) {
 	_projectionMatrix = value;
+	InvalidateShadowMap();
 }
 
 const glm::mat4& ShadowCamera::GetProjection() const {
@@ -75,6 +80,7 @@ void ShadowCamera::OnLoad()
 	desc.RenderTargets[RenderTargetAttachment::Depth] = RenderTargetDescriptor(RenderTargetType::Depth32);
 
 	_depthBuffer = std::make_shared<Framebuffer>(desc);
+	InvalidateShadowMap();
 }
 
 nlohmann::json ShadowCamera::ToJson() const
@@ -113,6 +119,20 @@ const Framebuffer::Sptr& ShadowCamera::GetDepthBuffer() const
 	return _depthBuffer;
 }
 
+void ShadowCamera::InvalidateShadowMap() {
+	_isShadowMapDirty = true;
+}
+
+bool ShadowCamera::NeedsShadowMapUpdate(const glm::mat4& viewProjection, uint64_t casterSignature) {
+	bool result = _isShadowMapDirty || casterSignature != _lastCasterSignature || viewProjection != _lastViewProjection;
+
+	_lastViewProjection = viewProjection;
+	_lastCasterSignature = casterSignature;
+	_isShadowMapDirty = false;
+
+	return result;
+}
+
 void ShadowCamera::RenderImGui()
 {
 	ImGui::PushID(this);
@@ -84,6 +84,19 @@ public:
 	/// </summary>
 	const Framebuffer::Sptr& GetDepthBuffer() const;
 
+	/// <summary>
+	/// Marks the depth buffer as out of date, so that it will be re-rendered next frame
+	/// </summary>
+	void InvalidateShadowMap();
+	/// <summary>
+	/// Checks whether the depth buffer needs to be re-rendered, and remembers the
+	/// given state for the next check
+	/// </summary>
+	/// <param name="viewProjection">The light's current view projection matrix</param>
+	/// <param name="casterSignature">A hash of the shadow casters in the light's frustum, see RenderLayer</param>
+	/// <returns>True if the light or any of the casters have changed since the last render</returns>
+	bool NeedsShadowMapUpdate(const glm::mat4& viewProjection, uint64_t casterSignature);
+
 	// Inherited from IComponent
 
 	virtual void OnLoad();
@@ -103,4 +116,9 @@ protected:
 	glm::ivec2        _bufferResolution;
 	// The projection matrix of the light
 	glm::mat4         _projectionMatrix;
+
+	// The state that _depthBuffer was last rendered with, so we can skip re-rendering it
+	glm::mat4         _lastViewProjection;
+	uint64_t          _lastCasterSignature;
+	bool              _isShadowMapDirty;
 };
\ No newline at end of file
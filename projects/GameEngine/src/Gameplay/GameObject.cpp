@@ -21,60 +21,57 @@ namespace Gameplay {
 		Name("Unknown"),
 		HideInHierarchy(false),
 		_components(std::vector<IComponent::Sptr>()),
+		_componentMask(0),
 		_scene(nullptr),
-		_position(ZERO),
-		_rotation(glm::quat(glm::vec3(0.0f))),
-		_scale(ONE),
-		_localTransform(MAT4_IDENTITY),
-		_inverseLocalTransform(MAT4_IDENTITY),
-		_isLocalTransformDirty(true),
-		_worldTransform(MAT4_IDENTITY),
-		_inverseWorldTransform(MAT4_IDENTITY),
-		_isWorldTransformDirty(true),
+		_creationOrder(0),
+		_sceneIndex(NO_SCENE_INDEX),
+		_isQueuedForDeletion(false),
+		_isActive(true),
+		_enabledBeforeDeactivate(),
+		_isSelfActive(true),
+		_transforms(nullptr),
+		_transformSlot(TransformSystem::INVALID_SLOT),
+		_detached(),
 		_parent(WeakRef()),
 		_children(std::vector<WeakRef>()),
 		_renderFlag(0)
-	{ }
-
-	void GameObject::_RecalcLocalTransform() const
 	{
-		if (_isLocalTransformDirty) {
-			_localTransform = glm::translate(MAT4_IDENTITY, _position) * glm::mat4_cast(_rotation) * glm::scale(MAT4_IDENTITY, _scale);
-			_inverseLocalTransform = glm::inverse(_localTransform);
-			_isLocalTransformDirty = false;
-			_isWorldTransformDirty = true;
-
-			// Dirty all the child objects world transforms
-			for (const auto& childPtr : _children) {
-				GameObject::Sptr childSptr = childPtr;
-				if (childSptr != nullptr) {
-					childSptr->_isWorldTransformDirty = true;
-				}
-			}
-		}
+		memset(_componentTable, NO_COMPONENT, sizeof(_componentTable));
 	}
 
-	void GameObject::_RecalcWorldTransform() const {
-		// Start by determining our local transform if required
-		_RecalcLocalTransform();
-
-		// If our world transform has been marked as dirty, we need to recalculate it!
-		if (_isWorldTransformDirty) {
-			GameObject::Sptr parent = _parent;
+	GameObject::~GameObject() {
+		if (_transforms != nullptr) {
+			_transforms->Free(_transformSlot);
+		}
+	}
 
-			// If out parent exists, we apply our local transformation relative to the parent's world transformation
-			if (parent != nullptr) {
-				_worldTransform = parent->GetTransform() * _localTransform;
-				_inverseWorldTransform = glm::inverse(_worldTransform);
-			}
+	void GameObject::_SetScene(Scene* scene) {
+		_DetachTransform();
+		_scene = scene;
+		_transforms = &scene->_transforms;
+		_transformSlot = _transforms->Allocate();
+		_transforms->SetPosition(_transformSlot, _detached.Position);
+		_transforms->SetRotation(_transformSlot, _detached.Rotation);
+		_transforms->SetScale(_transformSlot, _detached.Scale);
+	}
 
-			// If our parent is null, we can simply use the local transform as the world transform
-			else {
-				_worldTransform = _localTransform;
-				_inverseWorldTransform = _inverseLocalTransform;
-			}
-			_isWorldTransformDirty = false;
+	void GameObject::_DetachTransform() {
+		if (_transforms == nullptr) {
+			return;
 		}
+		_detached.Position = _transforms->GetPosition(_transformSlot);
+		_detached.Rotation = _transforms->GetRotation(_transformSlot);
+		_detached.Scale    = _transforms->GetScale(_transformSlot);
+		_transforms->Free(_transformSlot);
+		_transforms = nullptr;
+		_transformSlot = TransformSystem::INVALID_SLOT;
+		_RecalcDetachedTransform();
+	}
+
+	void GameObject::_RecalcDetachedTransform() {
+		// Without a parent, our local transform is our world transform
+		_detached.Transform = glm::translate(MAT4_IDENTITY, _detached.Position) * glm::mat4_cast(_detached.Rotation) * glm::scale(MAT4_IDENTITY, _detached.Scale);
+		_detached.InverseTransform = glm::inverse(_detached.Transform);
 	}
 
 	void GameObject::_PurgeDeletedChildren() {
@@ -84,8 +81,56 @@ namespace Gameplay {
 		_children.erase(it, _children.end());
 	}
 
+	void GameObject::SetName(const std::string& name) {
+		if (name == Name) {
+			return;
+		}
+		std::string oldName = Name;
+		Name = name;
+		if (_scene != nullptr) {
+			_scene->_OnObjectRenamed(this, oldName);
+		}
+	}
+
+	void GameObject::SetActive(bool active) {
+		_isSelfActive = active;
+		GameObject::Sptr parent = _parent;
+		_SetActiveInHierarchy(active && (parent == nullptr || parent->_isActive));
+	}
+
+	void GameObject::_SetActiveInHierarchy(bool active) {
+		if (active == _isActive) {
+			return;
+		}
+		_isActive = active;
+
+		if (!active) {
+			// Remember what was enabled, so that components that were turned off before stay off
+			_enabledBeforeDeactivate.resize(_components.size());
+			for (size_t ix = 0; ix < _components.size(); ix++) {
+				_enabledBeforeDeactivate[ix] = _components[ix]->IsEnabled;
+				_components[ix]->OnDeactivated();
+				_components[ix]->IsEnabled = false;
+			}
+		} else {
+			for (size_t ix = 0; ix < _components.size(); ix++) {
+				// Components added while we were inactive start out enabled
+				_components[ix]->IsEnabled = ix < _enabledBeforeDeactivate.size() ? _enabledBeforeDeactivate[ix] : true;
+				_components[ix]->OnActivated();
+			}
+			_enabledBeforeDeactivate.clear();
+		}
+
+		for (auto& child : _children) {
+			GameObject::Sptr childPtr = child;
+			if (childPtr != nullptr) {
+				childPtr->_SetActiveInHierarchy(active && childPtr->_isSelfActive);
+			}
+		}
+	}
+
 	void GameObject::LookAt(const glm::vec3& point) {
-		glm::mat4 rot = glm::lookAt(_position, point, glm::vec3(0.0f, 0.0f, 1.0f));
+		glm::mat4 rot = glm::lookAt(GetPosition(), point, glm::vec3(0.0f, 0.0f, 1.0f));
 		// Take the conjugate of the quaternion, as lookAt returns the *inverse* rotation
 		SetRotation(glm::conjugate(glm::quat_cast(rot)));
 	}
@@ -115,12 +160,16 @@ namespace Gameplay {
 	}
 
 	void GameObject::SetPosition(const glm::vec3& position) {
-		_position = position;
-		_isLocalTransformDirty = true;
+		if (_transforms == nullptr) {
+			_detached.Position = position;
+			_RecalcDetachedTransform();
+			return;
+		}
+		_transforms->SetPosition(_transformSlot, position);
 	}
 
 	const glm::vec3& GameObject::GetPosition() const {
-		return _position;
+		return _transforms != nullptr ? _transforms->GetPosition(_transformSlot) : _detached.Position;
 	}
 
 	glm::vec3 GameObject::GetWorldPosition() const {
@@ -128,51 +177,54 @@ namespace Gameplay {
 	}
 
 	void GameObject::SetRotation(const glm::quat& value) {
-		_rotation = value;
-		_isLocalTransformDirty = true;
+		if (_transforms == nullptr) {
+			_detached.Rotation = value;
+			_RecalcDetachedTransform();
+			return;
+		}
+		_transforms->SetRotation(_transformSlot, value);
 	}
 
 	const glm::quat& GameObject::GetRotation() const {
-		return _rotation;
+		return _transforms != nullptr ? _transforms->GetRotation(_transformSlot) : _detached.Rotation;
 	}
 
 	void GameObject::SetRotation(const glm::vec3& eulerAngles) {
-		_rotation = glm::quat(glm::radians(eulerAngles));
-		_isLocalTransformDirty = true;
+		SetRotation(glm::quat(glm::radians(eulerAngles)));
 	}
 
 	glm::vec3 GameObject::GetRotationEuler() const {
-		return glm::degrees(glm::eulerAngles(_rotation));
+		return glm::degrees(glm::eulerAngles(GetRotation()));
 	}
 
 	void GameObject::SetScale(const glm::vec3& value) {
-		_scale = value;
-		_isLocalTransformDirty = true;
+		if (_transforms == nullptr) {
+			_detached.Scale = value;
+			_RecalcDetachedTransform();
+			return;
+		}
+		_transforms->SetScale(_transformSlot, value);
 	}
 
 	const glm::vec3& GameObject::GetScale() const {
-		return _scale;
+		return _transforms != nullptr ? _transforms->GetScale(_transformSlot) : _detached.Scale;
 	}
 
 	const glm::mat4& GameObject::GetTransform() const {
-		_RecalcWorldTransform();
-		return _worldTransform;
+		return _transforms != nullptr ? _transforms->GetWorldTransform(_transformSlot) : _detached.Transform;
 	}
 
 	const glm::mat4& GameObject::GetInverseTransform() const {
-		_RecalcWorldTransform();
-		return _inverseWorldTransform;
+		return _transforms != nullptr ? _transforms->GetInverseWorldTransform(_transformSlot) : _detached.InverseTransform;
 	}
 
 	const glm::mat4& GameObject::GetLocalTransform() const
 	{
-		_RecalcLocalTransform();
-		return _localTransform;
+		return _transforms != nullptr ? _transforms->GetLocalTransform(_transformSlot) : _detached.Transform;
 	}
 
 	const glm::mat4& GameObject::GetInverseLocalTransform() const {
-		_RecalcLocalTransform();
-		return _inverseLocalTransform;
+		return _transforms != nullptr ? _transforms->GetInverseLocalTransform(_transformSlot) : _detached.InverseTransform;
 	}
 
 	void GameObject::RenderGUI(int viewportID) {
@@ -221,38 +273,66 @@ namespace Gameplay {
 	}
 
 	void GameObject::Update(float dt) {
+		// Components with a thread safe Update are run by the scene in parallel, and components
+		// that don't override Update have nothing to do
 		for (auto& component : _components) {
-			if (component->IsEnabled) {
+			if (component->IsEnabled && component->_updateMode == ComponentUpdateMode::Serial) {
 				component->Update(dt);
 			}
 		}
 
-		_RecalcLocalTransform();
-		_RecalcWorldTransform();
 		_PurgeDeletedChildren();
 	}
 
 	bool GameObject::Has(const std::type_index& type) {
-		// Iterate over all the pointers in the components list
-		for (const auto& ptr : _components) {
-			// If the pointer type matches T, we return true
-			if (std::type_index(typeid(*ptr.get())) == type) {
-				return true;
-			}
-		}
-		return false;
+		return (_componentMask & ComponentTypeIds::MaskOf(ComponentTypeIds::Get(type))) != 0;
 	}
 
 	std::shared_ptr<IComponent> GameObject::Get(const std::type_index& type)
 	{
-		// Iterate over all the pointers in the binding list
-		for (const auto& ptr : _components) {
-			// If the pointer type matches T, we return that behaviour, making sure to cast it back to the requested type
-			if (std::type_index(typeid(*ptr.get())) == type) {
-				return ptr;
+		ComponentTypeId id = ComponentTypeIds::Get(type);
+		if (_GetComponentPtr(id) == nullptr) {
+			return nullptr;
+		}
+		return _components[_componentTable[id]];
+	}
+
+	void GameObject::_AttachComponent(const IComponent::Sptr& component) {
+		LOG_ASSERT(_components.size() < NO_COMPONENT, "Too many components on a single game object");
+		ComponentTypeId id = ComponentTypeIds::Get(component->_realType);
+		LOG_ASSERT(id < ComponentTypeIds::MAX_COMPONENT_TYPES, "Component type was never registered");
+
+		_componentTable[id] = static_cast<uint8_t>(_components.size());
+		_componentMask |= ComponentTypeIds::MaskOf(id);
+		_components.push_back(component);
+
+		// Components added to an inactive object stay off until it's activated
+		if (!_isActive) {
+			_enabledBeforeDeactivate.resize(_components.size() - 1);
+			_enabledBeforeDeactivate.push_back(component->IsEnabled);
+			component->IsEnabled = false;
+		}
+	}
+
+	void GameObject::_DetachComponent(size_t index) {
+		_components.erase(_components.begin() + index);
+		if (index < _enabledBeforeDeactivate.size()) {
+			_enabledBeforeDeactivate.erase(_enabledBeforeDeactivate.begin() + index);
+		}
+		// Everything after the component has shifted down, so it's easiest to rebuild
+		_RebuildComponentTable();
+	}
+
+	void GameObject::_RebuildComponentTable() {
+		memset(_componentTable, NO_COMPONENT, sizeof(_componentTable));
+		_componentMask = 0;
+		for (size_t ix = 0; ix < _components.size(); ix++) {
+			ComponentTypeId id = ComponentTypeIds::Get(_components[ix]->_realType);
+			if (id < ComponentTypeIds::MAX_COMPONENT_TYPES) {
+				_componentTable[id] = static_cast<uint8_t>(ix);
+				_componentMask |= ComponentTypeIds::MaskOf(id);
 			}
 		}
-		return nullptr;
 	}
 
 	std::shared_ptr<IComponent> GameObject::Add(const std::type_index& type)
@@ -265,7 +345,7 @@ namespace Gameplay {
 		component->_context = this;
 
 		// Append it to the binding component's storage, and invoke the OnLoad
-		_components.push_back(component);
+		_AttachComponent(component);
 		component->OnLoad();
 
 		if (_scene->GetIsAwake()) {
@@ -290,7 +370,11 @@ namespace Gameplay {
 			// applies to the child
 			_children.push_back(child);
 			child->_parent = _selfRef.lock();
-			child->_isWorldTransformDirty = true;
+			if (_transforms != nullptr && child->_transforms == _transforms) {
+				_transforms->SetParent(child->_transformSlot, _transformSlot);
+			}
+			// The child can only be active while we are
+			child->_SetActiveInHierarchy(_isActive && child->_isSelfActive);
 		} else {
 			LOG_WARN("Attempting to add same child twice, ignoring: {}", child->Name);
 		}
@@ -303,7 +387,11 @@ namespace Gameplay {
 		if (it != _children.end()) { 
 			// Clear the object's parent and remove from our list of children
 			child->_parent.Reset();
+			if (_transforms != nullptr && child->_transforms == _transforms) {
+				_transforms->SetParent(child->_transformSlot, TransformSystem::INVALID_SLOT);
+			}
 			_children.erase(it);
+			child->_SetActiveInHierarchy(child->_isSelfActive);
 			return true;
 		} else {
 			return false;
@@ -335,7 +423,7 @@ namespace Gameplay {
 			memcpy(nameBuff, Name.c_str(), Name.size());
 			nameBuff[Name.size()] = '\0';
 			if (ImGui::InputText("", nameBuff, 256)) {
-				Name = nameBuff;
+				SetName(nameBuff);
 			}
 			ImGui::SameLine();
 			if (ImGuiHelper::WarningButton("Delete")) {
@@ -365,16 +453,19 @@ namespace Gameplay {
 			}
 
 			// Render position label
-			_isLocalTransformDirty |= LABEL_LEFT(ImGui::DragFloat3, "Position", &_position.x, 0.01f);
+			glm::vec3 position = GetPosition();
+			if (LABEL_LEFT(ImGui::DragFloat3, "Position", &position.x, 0.01f)) {
+				SetPosition(position);
+			}
 			
 			// Get the ImGui storage state so we can avoid gimbal locking issues by storing euler angles in the editor
 			glm::vec3 euler = GetRotationEuler();
 			ImGuiStorage* guiStore = ImGui::GetStateStorage();
 
-			// Extract the angles from the storage, note that we're only using the address of the position for unique IDs
-			euler.x = guiStore->GetFloat(ImGui::GetID(&_position.x), euler.x);
-			euler.y = guiStore->GetFloat(ImGui::GetID(&_position.y), euler.y);
-			euler.z = guiStore->GetFloat(ImGui::GetID(&_position.z), euler.z);
+			// Extract the angles from the storage, the IDs are scoped to this object
+			euler.x = guiStore->GetFloat(ImGui::GetID("##euler_x"), euler.x);
+			euler.y = guiStore->GetFloat(ImGui::GetID("##euler_y"), euler.y);
+			euler.z = guiStore->GetFloat(ImGui::GetID("##euler_z"), euler.z);
 
 			//Draw the slider for angles
 			if (LABEL_LEFT(ImGui::DragFloat3, "Rotation", &euler.x, 1.0f)) {
@@ -382,16 +473,19 @@ namespace Gameplay {
 				euler = Wrap(euler, -180.0f, 180.0f);
 
 				// Update the editor state with our new values
-				guiStore->SetFloat(ImGui::GetID(&_position.x), euler.x);
-				guiStore->SetFloat(ImGui::GetID(&_position.y), euler.y);
-				guiStore->SetFloat(ImGui::GetID(&_position.z), euler.z);
+				guiStore->SetFloat(ImGui::GetID("##euler_x"), euler.x);
+				guiStore->SetFloat(ImGui::GetID("##euler_y"), euler.y);
+				guiStore->SetFloat(ImGui::GetID("##euler_z"), euler.z);
 
 				//Send new rotation to the gameobject
 				SetRotation(euler);
 			}
 			
 			// Draw the scale
-			_isLocalTransformDirty |= LABEL_LEFT(ImGui::DragFloat3, "Scale   ", &_scale.x, 0.01f, 0.0f);
+			glm::vec3 scale = GetScale();
+			if (LABEL_LEFT(ImGui::DragFloat3, "Scale   ", &scale.x, 0.01f, 0.0f)) {
+				SetScale(scale);
+			}
 
 			ImGui::Separator();
 			ImGui::TextUnformatted("Components");
@@ -405,7 +499,7 @@ namespace Gameplay {
 					component->RenderImGui();
 					// Render a delete button for the component
 					if (ImGuiHelper::WarningButton("Delete")) {
-						_components.erase(_components.begin() + ix);
+						_DetachComponent(ix);
 						ix--;
 					}
 					ImGui::PopID();
@@ -449,10 +543,6 @@ namespace Gameplay {
 			ImGui::Unindent();
 		}
 		ImGui::PopID(); // Pop the ImGui ID scope for the object
-
-		// For if we're not in play mode
-		_RecalcLocalTransform();
-		_RecalcWorldTransform();
 	}
 
 	std::shared_ptr<GameObject> GameObject::SelfRef() {
@@ -464,45 +554,57 @@ namespace Gameplay {
 		// We need to manually construct since the GameObject constructor is
 		// protected. We can call it here since Scene is a friend class of GameObjects
 		GameObject::Sptr result(new GameObject());
-		result->_scene = scene;
+		result->_SetScene(scene);
 
 		// Load in basic info
 		result->Name = data["name"];
 		result->_guid = Guid(data["guid"]);
 		result->_parent = WeakRef(Guid(data.contains("parent") ? data["parent"] : "null"), nullptr);
-		result->_position = (data["position"]);
-		result->_rotation = (data["rotation"]);
-		result->_scale    = (data["scale"]);
+		result->SetPosition(data["position"].get<glm::vec3>());
+		result->SetRotation(data["rotation"].get<glm::quat>());
+		result->SetScale(data["scale"].get<glm::vec3>());
 		result->HideInHierarchy = JsonGet(data, "hide_in_inspector", false);
-		result->_isLocalTransformDirty = true;
-		result->_isWorldTransformDirty = true;
 
 		// Since our components are stored based on the type name, we iterate
 		// on the keys and values from the components object
 		nlohmann::json components = data["components"];
 		for (auto& [typeName, value] : components.items()) {
-			// We need to reference the component registry to load our components
-			// based on the type name (note that all component types need to be
-			// registered at the start of the application)
-			IComponent::Sptr component = scene->Components().Load(typeName, value);
-			component->_context = result.get();
-
-			// Add component to object and allow it to perform self initialization
-			result->_components.push_back(component);
-			component->OnLoad();
+			result->_LoadComponent(typeName, value);
 		}
 
 		return result;
 	}
 
+	void GameObject::_LoadComponent(const std::string& typeName, const nlohmann::json& blob) {
+		// We need to reference the component registry to load our components
+		// based on the type name (note that all component types need to be
+		// registered at the start of the application)
+		IComponent::Sptr component = _scene->Components().Load(typeName, blob);
+		component->_context = this;
+
+		// Add component to object and allow it to perform self initialization
+		_AttachComponent(component);
+		component->OnLoad();
+	}
+
+	void GameObject::_CloneComponent(const IComponent& source) {
+		IComponent::Sptr component = _scene->Components().Clone(source);
+		LOG_ASSERT(component != nullptr, "Component type was never registered");
+		component->_context = this;
+
+		// Add component to object and allow it to perform self initialization
+		_AttachComponent(component);
+		component->OnLoad();
+	}
+
 	nlohmann::json GameObject::ToJson() const {
 		GameObject::Sptr parent = _parent;
 		nlohmann::json result = {
 			{ "name", Name },
 			{ "guid", _guid.str() },
-			{ "position", _position },
-			{ "rotation", _rotation },
-			{ "scale",    _scale },
+			{ "position", GetPosition() },
+			{ "rotation", GetRotation() },
+			{ "scale",    GetScale() },
 			{ "parent",   parent == nullptr ? "null" : parent->_guid.str() },
 			{ "hide_in_inspector", HideInHierarchy }
 		};
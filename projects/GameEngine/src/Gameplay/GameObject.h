@@ -11,6 +11,8 @@
 // Others
 #include "Gameplay/Components/IComponent.h"
 #include "Gameplay/Components/ComponentManager.h"
+#include "Gameplay/Components/ComponentTypeId.h"
+#include "Gameplay/TransformSystem.h"
 #include "Utils/ResourceManager/IResource.h"
 
 class InspectorWindow;
@@ -25,6 +27,25 @@ namespace Gameplay {
 		class RigidBody;
 	}
 
+	/// <summary>
+	/// A cheap, cacheable reference to a game object in a scene. Resolving a handle is an
+	/// array lookup and a generation check, and a handle to a deleted object will never
+	/// resolve to a different object that re-uses its slot
+	/// </summary>
+	struct GameObjectHandle {
+		static const uint32_t INVALID_INDEX = UINT32_MAX;
+
+		// The slot in the scene's object table
+		uint32_t Index = INVALID_INDEX;
+		// Incremented every time the slot is freed, so stale handles can be detected
+		uint32_t Generation = 0;
+
+		bool IsValid() const { return Index != INVALID_INDEX; }
+
+		bool operator ==(const GameObjectHandle& other) const { return Index == other.Index && Generation == other.Generation; }
+		bool operator !=(const GameObjectHandle& other) const { return !(*this == other); }
+	};
+
 	/// <summary>
 	/// Represents an object in our scene with a transformation and a collection
 	/// of components. Components provide gameobject's with behaviours
@@ -34,6 +55,8 @@ namespace Gameplay {
 		typedef std::shared_ptr<GameObject> Sptr;
 		typedef std::weak_ptr<GameObject> Wptr;
 
+		virtual ~GameObject();
+
 		/// <summary>
 		/// Structure to assist in wrapping weak references to GameObjects
 		/// Can track the object's GUID before and after creation
@@ -133,12 +156,44 @@ namespace Gameplay {
 			void Reset();
 		};
 
-		// Human readable name for the object
+		// Human readable name for the object, change it with SetName so the scene's
+		// name lookup stays up to date
 		std::string             Name;
 
 		// Hack to hide instances from the hierarchy (like when adding lots of instances)
 		bool HideInHierarchy = false;
 
+		/// <summary>
+		/// Renames this object, and updates the name lookup of the scene it is in
+		/// </summary>
+		/// <param name="name">The new name for the object</param>
+		void SetName(const std::string& name);
+
+		/// <summary>
+		/// Gets a handle to this object that can be resolved with Scene::FindObjectByHandle,
+		/// or an invalid handle if the object is not in a scene
+		/// </summary>
+		GameObjectHandle GetHandle() const { return _handle; }
+
+		/// <summary>
+		/// Activates or deactivates this object and all of its children. Deactivated objects keep
+		/// their components, but those components are disabled and taken out of the physics world
+		/// until the object is activated again, which is much cheaper than destroying and
+		/// re-creating the object
+		///
+		/// Children that were deactivated themselves stay inactive when their parent is activated
+		/// </summary>
+		/// <param name="active">True to activate the object, false to deactivate it</param>
+		void SetActive(bool active);
+		/// <summary>
+		/// Returns true if this object and all of its parents are active
+		/// </summary>
+		bool IsActive() const { return _isActive; }
+		/// <summary>
+		/// Returns the value last passed to SetActive for this object, regardless of its parents
+		/// </summary>
+		bool IsSelfActive() const { return _isSelfActive; }
+
 		/// <summary>
 		/// Rotates this object to look at the given point in world coordinates
 		/// </summary>
@@ -242,7 +297,8 @@ namespace Gameplay {
 		void Awake();
 
 		/// <summary>
-		/// Calls update on all enabled components in this object
+		/// Calls update on all enabled components in this object, except for those that
+		/// are updated in parallel by the scene
 		/// </summary>
 		/// <param name="deltaTime">The time since the last frame, in seconds</param>
 		void Update(float dt);
@@ -253,14 +309,8 @@ namespace Gameplay {
 		/// <typeparam name="T">The type of component to search for</typeparam>
 		template <typename T, typename = typename std::enable_if<std::is_base_of<IComponent, T>::value>::type>
 		bool Has() {
-			// Iterate over all the pointers in the components list
-			for (const auto& ptr : _components) {
-				// If the pointer type matches T, we return true
-				if (std::type_index(typeid(*ptr.get())) == std::type_index(typeid(T))) {
-					return true;
-				}
-			}
-			return false;
+			// Each component type has a bit in our mask
+			return (_componentMask & ComponentTypeIds::MaskOf(ComponentTypeIds::Get<T>())) != 0;
 		}
 
 		bool Has(const std::type_index& type);
@@ -271,14 +321,10 @@ namespace Gameplay {
 		/// <typeparam name="T">The type of component to search for</typeparam>
 		template <typename T, typename = typename std::enable_if<std::is_base_of<IComponent, T>::value>::type>
 		std::shared_ptr<T> Get() {
-			// Iterate over all the pointers in the binding list
-			for (const auto& ptr : _components) {
-				// If the pointer type matches T, we return that behaviour, making sure to cast it back to the requested type
-				if (std::type_index(typeid(*ptr.get())) == std::type_index(typeid(T))) {
-					return std::dynamic_pointer_cast<T>(ptr);
-				}
-			}
-			return nullptr;
+			// The table maps the component type directly to where it sits in _components. The
+			// component's real type is exactly T, so we don't need a dynamic cast
+			ComponentTypeId id = ComponentTypeIds::Get<T>();
+			return _GetComponentPtr(id) != nullptr ? std::static_pointer_cast<T>(_components[_componentTable[id]]) : nullptr;
 		}
 
 		std::shared_ptr<IComponent> Get(const std::type_index& type);
@@ -300,7 +346,7 @@ namespace Gameplay {
 			component->_context = this;
 
 			// Append it to the binding component's storage, and invoke the OnLoad
-			_components.push_back(component);
+			_AttachComponent(component);
 			component->OnLoad();
 
 			if (_scene->GetIsAwake()) {
@@ -344,24 +390,24 @@ namespace Gameplay {
 
 	private:
 		friend class Scene;
+		friend class Prefab;
 		friend class InspectorWindow;
 		friend class HierarchyWindow;
 
-		// Rotation of the object as a quaternion
-		glm::quat _rotation;
-		// Position of the object
-		glm::vec3 _position;
-		// The scale of the object
-		glm::vec3 _scale;
-
-		// The object's world transform
-		mutable glm::mat4 _localTransform;
-		mutable glm::mat4 _inverseLocalTransform;
-		mutable bool _isLocalTransformDirty;
-
-		mutable glm::mat4 _worldTransform;
-		mutable glm::mat4 _inverseWorldTransform;
-		mutable bool _isWorldTransformDirty;
+		// Our position, rotation, scale and matrices live in the scene's transform system while we are
+		// in a scene. Once we're removed from it (or it's destroyed before we are), the slot is handed
+		// back and our transform is kept here instead, with no parent
+		TransformSystem* _transforms;
+		TransformSystem::Slot _transformSlot;
+
+		struct DetachedTransform {
+			glm::vec3 Position = glm::vec3(0.0f);
+			glm::quat Rotation = glm::quat(glm::vec3(0.0f));
+			glm::vec3 Scale    = glm::vec3(1.0f);
+			glm::mat4 Transform        = glm::mat4(1.0f);
+			glm::mat4 InverseTransform = glm::mat4(1.0f);
+		};
+		DetachedTransform _detached;
 
 		// For the hierarchy
 		WeakRef _parent;
@@ -369,24 +415,80 @@ namespace Gameplay {
 
 		// The components that this game object has attached to it
 		std::vector<IComponent::Sptr> _components;
+		// Has a bit set for each component type that's attached
+		ComponentMask _componentMask;
+		// Maps a ComponentTypeId to the component's index in _components, or NO_COMPONENT
+		static const uint8_t NO_COMPONENT = 0xFF;
+		uint8_t _componentTable[ComponentTypeIds::MAX_COMPONENT_TYPES];
 		std::weak_ptr<GameObject> _selfRef;
 
 		// Pointer to the scene, we use raw pointers since 
 		// this will always be set by the scene on creation
 		// or load, we don't need to worry about ref counting
 		Scene* _scene;
+		// Our slot in the scene's object table
+		GameObjectHandle _handle;
+		// When the object was added to the scene, relative to the other objects in it
+		uint64_t _creationOrder;
+		// Where the object lives in the scene's object list, so it can be removed without searching
+		static constexpr uint32_t NO_SCENE_INDEX = UINT32_MAX;
+		uint32_t _sceneIndex;
+		// Set while the object is in the scene's deletion queue, so that it only gets queued once
+		bool _isQueuedForDeletion;
+		// False while this object or one of its parents is deactivated, along with which components
+		// were enabled when we were deactivated
+		bool _isActive;
+		std::vector<bool> _enabledBeforeDeactivate;
+		// The value last given to SetActive, children only come back with their parent if this is set
+		bool _isSelfActive;
 
 		/// <summary>
 		/// Only scenes will be allowed to create gameobjects
 		/// </summary>
 		GameObject();
 
-		// Recalculates the transform matrix for the object when required
-		void _RecalcLocalTransform() const;
-		void _RecalcWorldTransform() const;
+		/// <summary>
+		/// Sets the scene that this object belongs to, and allocates its transform
+		/// </summary>
+		void _SetScene(Scene* scene);
+		/// <summary>
+		/// Updates whether we're active in the hierarchy, toggling our components and passing the
+		/// change down to any children that are active themselves
+		/// </summary>
+		/// <param name="active">True if we and all of our parents are active</param>
+		void _SetActiveInHierarchy(bool active);
+		/// <summary>
+		/// Copies our transform out of the scene's transform system and frees our slot, called
+		/// when we are removed from the scene or the scene is destroyed
+		/// </summary>
+		void _DetachTransform();
+		/// <summary>
+		/// Rebuilds the detached transform's matrices after its position, rotation or scale changes
+		/// </summary>
+		void _RecalcDetachedTransform();
 
 		void _PurgeDeletedChildren();
 
+		/// <summary>
+		/// Gets the attached component with the given type ID, or nullptr
+		/// </summary>
+		IComponent* _GetComponentPtr(ComponentTypeId id) const {
+			if (id >= ComponentTypeIds::MAX_COMPONENT_TYPES || _componentTable[id] == NO_COMPONENT) {
+				return nullptr;
+			}
+			return _components[_componentTable[id]].get();
+		}
+		// Creates a component from its serialized form through the component registry and attaches it
+		void _LoadComponent(const std::string& typeName, const nlohmann::json& blob);
+		// Copies a component that isn't attached to anything (see ComponentManager::Clone) and attaches the copy
+		void _CloneComponent(const IComponent& source);
+		// Adds a component to _components, and updates the mask and table
+		void _AttachComponent(const IComponent::Sptr& component);
+		// Removes the component at the given index in _components, and updates the mask and table
+		void _DetachComponent(size_t index);
+		// Rebuilds the mask and table from _components
+		void _RebuildComponentTable();
+
 		int _renderFlag;
 		int _renderOrderFlag;
 	};
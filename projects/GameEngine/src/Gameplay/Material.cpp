@@ -9,10 +9,13 @@
 #include "Graphics/Textures/Texture3D.h"
 
 namespace Gameplay {
+	std::atomic_uint32_t Material::_NextSortId = 0;
+
 	Material::Material(const ShaderProgram::Sptr& shader) :
 		IResource(),
 		_shader(shader),
-		_uniforms(std::unordered_map<std::string, UniformData>())
+		_uniforms(std::unordered_map<std::string, UniformData>()),
+		_sortId(_NextSortId++)
 	{
 		_PopulateUniforms();
 	}
@@ -20,7 +23,8 @@ namespace Gameplay {
 	Material::Material() :
 		IResource(),
 		_shader(nullptr),
-		_uniforms(std::unordered_map<std::string, UniformData>())
+		_uniforms(std::unordered_map<std::string, UniformData>()),
+		_sortId(_NextSortId++)
 	{ }
 
 	void Material::Set(const std::string& name, ShaderDataType type, const void* value, size_t arraySize)
@@ -60,8 +64,33 @@ namespace Gameplay {
 		return _shader;
 	}
 
+	uint32_t Material::GetSortId() const {
+		return _sortId;
+	}
+
 	void Material::Apply() {
-		if (_shader != nullptr) {
+		_ApplyTo(_shader.get(), false);
+	}
+
+	void Material::ApplyToVariant(ShaderProgram* variant) {
+		_ApplyTo(variant, variant != _shader.get());
+	}
+
+	bool Material::IsAlphaTested() const {
+		// The uniforms that our fragment shaders compare alpha against before discarding
+		static const char* thresholdNames[] = { "u_Material.DiscardThreshold", "u_Material.Threshold" };
+
+		for (const char* name : thresholdNames) {
+			auto it = _uniforms.find(name);
+			if (it != _uniforms.end() && it->second.Type == ShaderDataType::Float && it->second.Get<float>() > 0.0f) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void Material::_ApplyTo(ShaderProgram* shader, bool remapLocations) {
+		if (shader != nullptr) {
 			// Skip the reserved # of texture slots
 			int textureSlot = 0;
 			
@@ -71,6 +100,13 @@ namespace Gameplay {
 				// ex: float, matrix, texture, etc...
 				ShaderDataTypecode typeCode = GetShaderDataTypeCode(data.Type);
 
+				// Variants are separate programs, so we need to find where the uniform lives in them
+				int location = data.Location;
+				if (remapLocations) {
+					auto it = shader->GetUniforms().find(name);
+					location = it != shader->GetUniforms().end() ? it->second.Location : -1;
+				}
+
 				// If the uniform is a texture, we try and bind it, then move to the next slot
 				if (typeCode == ShaderDataTypecode::Texture) {
 					if (textureSlot >= MAX_TEXTURE_SLOTS) {
@@ -85,13 +121,13 @@ namespace Gameplay {
 							ITexture::Unbind(textureSlot);
 						}
 						// Send the slot to the shader
-						_shader->SetUniform(data.Location, data.Type, &textureSlot);
+						shader->SetUniform(location, data.Type, &textureSlot);
 						textureSlot++;
 					}
 				}
 				// The uniform is a plain ol' value type, send it in
 				else {
-					_shader->SetUniform(data.Location, data.Type, data.ArraySize > 1 ? data.ArrayBlock : data.Value, data.ArraySize);
+					shader->SetUniform(location, data.Type, data.ArraySize > 1 ? data.ArrayBlock : data.Value, data.ArraySize);
 				}
 			}
 		}
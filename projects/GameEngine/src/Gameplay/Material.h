@@ -1,5 +1,6 @@
 #pragma once
 #include <memory>
+#include <atomic>
 #include "Graphics/ShaderProgram.h"
 #include "Graphics/Textures/ITexture.h"
 
@@ -60,12 +61,31 @@ namespace Gameplay {
 		/// </summary>
 		const ShaderProgram::Sptr& GetShader() const;
 
+		/// <summary>
+		/// Gets a small unique ID for this material instance, used by the renderer
+		/// to group draws that share a material
+		/// </summary>
+		uint32_t GetSortId() const;
+
+		/// <summary>
+		/// Returns true if this material discards fragments based on their alpha, in which
+		/// case it needs to be applied even for depth only passes (ex: shadow casters)
+		/// </summary>
+		bool IsAlphaTested() const;
+
 		/// <summary>
 		/// Handles applying this material's state to the OpenGL pipeline
 		/// Will bind the shader, update material uniforms, and bind textures
 		/// </summary>
 		virtual void Apply();
 
+		/// <summary>
+		/// Applies this material's state to a variant of its shader (ex: the instanced variant),
+		/// where uniform locations may differ, so they are looked up by name
+		/// </summary>
+		/// <param name="variant">The shader variant that is bound for rendering</param>
+		void ApplyToVariant(ShaderProgram* variant);
+
 		/// <summary>
 		/// Renders some UI controls for manipulating a material at runtime
 		/// </summary>
@@ -174,8 +194,15 @@ namespace Gameplay {
 		/// The uniforms that the material will be modifying
 		/// </summary>
 		std::unordered_map<std::string, UniformData> _uniforms;
+		/// <summary>
+		/// The ID used for sorting draws by material, see GetSortId
+		/// </summary>
+		uint32_t               _sortId;
+
+		static std::atomic_uint32_t _NextSortId;
 
 		UniformData& _GetUniform(const std::string& name);
+		void _ApplyTo(ShaderProgram* shader, bool remapLocations);
 		void _PopulateUniforms();
 	};
 }
\ No newline at end of file
@@ -1,7 +1,7 @@
 #include "MeshResource.h"
 #include <filesystem>
 
-#include "Utils/ObjLoader.h"
+#include "Utils/OptimizedObjLoader.h"
 
 namespace Gameplay {
 	MeshResource::MeshResource() :
@@ -19,7 +19,7 @@ namespace Gameplay {
 		Mesh(nullptr),
 		BulletTriMesh(nullptr)
 	{
-		Mesh = ObjLoader::LoadFromFile(filename);
+		Mesh = OptimizedObjLoader::LoadFromFile(filename);
 	}
 
 	MeshResource::~MeshResource() = default;
@@ -55,12 +55,7 @@ namespace Gameplay {
 		} else {
 			result->Filename = JsonGet<std::string>(blob, "filename", "null");
 			if (result->Filename != "null" && std::filesystem::exists(result->Filename)) {
-				#ifdef OPTIMIZED_OBJ_LOADER
 				result->Mesh = OptimizedObjLoader::LoadFromFile(result->Filename);
-				#else
-				result->Mesh = ObjLoader::LoadFromFile(result->Filename);
-				#endif
-
 			}
 		}
 		return result;
@@ -78,4 +73,9 @@ namespace Gameplay {
 	void MeshResource::AddParam(const MeshBuilderParam & param) {
 		MeshBuilderParams.push_back(param);
 	}
+
+	const Bounds& MeshResource::GetBounds() const {
+		static const Bounds empty = Bounds();
+		return Mesh != nullptr ? Mesh->GetBounds() : empty;
+	}
 }
\ No newline at end of file
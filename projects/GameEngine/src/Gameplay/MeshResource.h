@@ -61,6 +61,11 @@ namespace Gameplay {
 		/// <param name="param">The parameter to add</param>
 		void AddParam(const MeshBuilderParam& param);
 
+		/// <summary>
+		/// Gets the model space bounds of the mesh, will be invalid if the mesh has not been loaded
+		/// </summary>
+		const Bounds& GetBounds() const;
+
 		// Inherited from IResource
 
 		virtual nlohmann::json ToJson() const override;
@@ -0,0 +1,54 @@
+#include "Gameplay/ObjectPool.h"
+#include "Gameplay/Scene.h"
+
+namespace Gameplay {
+	ObjectPool::ObjectPool(Scene* scene, const Prefab::Sptr& prefab, uint32_t initialSize) :
+		_scene(scene),
+		_prefab(prefab),
+		_available(),
+		_numActive(0)
+	{
+		LOG_ASSERT(_scene != nullptr, "Object pools need a scene");
+		LOG_ASSERT(_prefab != nullptr, "Object pools need a prefab");
+		Reserve(initialSize);
+	}
+
+	void ObjectPool::Reserve(uint32_t count) {
+		_available.reserve(count);
+		while (_available.size() < count) {
+			GameObject::Sptr object = _prefab->Instantiate(_scene);
+			object->SetActive(false);
+			_available.push_back(object);
+		}
+	}
+
+	GameObject::Sptr ObjectPool::Acquire(const glm::vec3& position, const glm::quat& rotation) {
+		GameObject::Sptr result;
+		if (_available.empty()) {
+			result = _prefab->Instantiate(_scene, position, rotation);
+		} else {
+			result = std::move(_available.back());
+			_available.pop_back();
+
+			// Move it before waking it up, so its physics bodies come back in the right place
+			result->SetPosition(position);
+			result->SetRotation(rotation);
+			result->SetActive(true);
+		}
+
+		_numActive++;
+		return result;
+	}
+
+	void ObjectPool::Release(const GameObject::Sptr& object) {
+		LOG_ASSERT(object != nullptr && object->GetScene() == _scene, "Object does not belong to this pool's scene");
+		if (!object->IsActive()) {
+			LOG_WARN("Object \"{}\" was released to its pool twice, ignoring", object->Name);
+			return;
+		}
+
+		object->SetActive(false);
+		_available.push_back(object);
+		_numActive--;
+	}
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <vector>
+
+#include "Gameplay/Prefab.h"
+
+namespace Gameplay {
+	class Scene;
+
+	/// <summary>
+	/// Keeps a supply of instances of a prefab around for things that get spawned and removed
+	/// often, like projectiles. Released objects are deactivated rather than removed from the scene,
+	/// so acquiring one again doesn't allocate, register new components or rebuild physics bodies
+	/// </summary>
+	class ObjectPool {
+	public:
+		MAKE_PTRS(ObjectPool);
+		NO_COPY(ObjectPool);
+
+		/// <summary>
+		/// Creates a new pool of instances of the given prefab
+		/// </summary>
+		/// <param name="scene">The scene that the pooled objects live in</param>
+		/// <param name="prefab">The prefab to create objects from</param>
+		/// <param name="initialSize">The number of inactive objects to create up front</param>
+		ObjectPool(Scene* scene, const Prefab::Sptr& prefab, uint32_t initialSize = 0);
+		~ObjectPool() = default;
+
+		/// <summary>
+		/// Makes sure that at least the given number of inactive objects are ready to be acquired
+		/// </summary>
+		void Reserve(uint32_t count);
+
+		/// <summary>
+		/// Takes an object out of the pool and activates it at the given location, creating a new
+		/// instance of the prefab if the pool is empty
+		/// </summary>
+		/// <param name="position">The position to place the object at</param>
+		/// <param name="rotation">The rotation to give the object</param>
+		/// <returns>The activated object</returns>
+		GameObject::Sptr Acquire(const glm::vec3& position, const glm::quat& rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+		/// <summary>
+		/// Deactivates an object that was acquired from this pool, and makes it available again
+		/// </summary>
+		/// <param name="object">The object to return to the pool</param>
+		void Release(const GameObject::Sptr& object);
+
+		/// <summary>
+		/// Gets the number of objects that are waiting in the pool
+		/// </summary>
+		size_t NumAvailable() const { return _available.size(); }
+		/// <summary>
+		/// Gets the number of objects that have been acquired and not released yet
+		/// </summary>
+		size_t NumActive() const { return _numActive; }
+
+		const Prefab::Sptr& GetPrefab() const { return _prefab; }
+
+	protected:
+		Scene*                        _scene;
+		Prefab::Sptr                  _prefab;
+		std::vector<GameObject::Sptr> _available;
+		size_t                        _numActive;
+	};
+}
@@ -17,6 +17,10 @@ namespace Gameplay::Physics {
 
 	BoxCollider::~BoxCollider() = default;
 
+	ICollider::Sptr BoxCollider::Clone() const {
+		return std::shared_ptr<BoxCollider>(new BoxCollider(*this));
+	}
+
 	btCollisionShape* BoxCollider::CreateShape() const {
 		return new btBoxShape(btVector3(_extents.x, _extents.y, _extents.z));
 	}
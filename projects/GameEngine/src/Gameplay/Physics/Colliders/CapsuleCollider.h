@@ -22,6 +22,7 @@ namespace Gameplay::Physics {
 		virtual void DrawImGui() override;
 		virtual void ToJson(nlohmann::json& blob) const override;
 		virtual void FromJson(const nlohmann::json& data) override;
+		virtual ICollider::Sptr Clone() const override;
 
 	protected:
 		virtual btCollisionShape* CreateShape() const override;
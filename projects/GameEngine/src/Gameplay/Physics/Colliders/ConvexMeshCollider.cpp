@@ -14,6 +14,16 @@ namespace Gameplay::Physics {
 
 	ConvexMeshCollider::~ConvexMeshCollider() = default;
 
+	ICollider::Sptr ConvexMeshCollider::Clone() const {
+		return std::shared_ptr<ConvexMeshCollider>(new ConvexMeshCollider(*this));
+	}
+
+	ConvexMeshCollider::ConvexMeshCollider(const ConvexMeshCollider& other) :
+		ICollider(other),
+		// The mesh is rebuilt from our game object's render component in Awake
+		_triMesh(nullptr)
+	{ }
+
 	ConvexMeshCollider::ConvexMeshCollider() :
 		ICollider(ColliderType::ConvexMesh),
 		_triMesh(nullptr)
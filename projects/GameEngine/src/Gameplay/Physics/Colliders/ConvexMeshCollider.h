@@ -17,10 +17,12 @@ namespace Gameplay::Physics {
 		virtual void DrawImGui() override;
 		virtual void ToJson(nlohmann::json& blob) const override;
 		virtual void FromJson(const nlohmann::json& data) override;
+		virtual ICollider::Sptr Clone() const override;
 
 	protected:
 		btTriangleMesh* _triMesh;
 		ConvexMeshCollider();
+		ConvexMeshCollider(const ConvexMeshCollider& other);
 
 		virtual btCollisionShape* CreateShape() const override;
 	};
@@ -16,6 +16,10 @@ namespace Gameplay::Physics {
 
 	CylinderCollider::~CylinderCollider() = default;
 
+	ICollider::Sptr CylinderCollider::Clone() const {
+		return std::shared_ptr<CylinderCollider>(new CylinderCollider(*this));
+	}
+
 	void CylinderCollider::DrawImGui() {
 		_isDirty |= LABEL_LEFT(ImGui::DragFloat3, "Half Extents", &_extents.x, 0.1f, 0.01f);
 	}
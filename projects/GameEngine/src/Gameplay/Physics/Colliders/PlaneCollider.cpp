@@ -15,6 +15,10 @@ namespace Gameplay::Physics {
 
 	PlaneCollider::~PlaneCollider() = default;
 
+	ICollider::Sptr PlaneCollider::Clone() const {
+		return std::shared_ptr<PlaneCollider>(new PlaneCollider(*this));
+	}
+
 	void PlaneCollider::DrawImGui() {
 		_isDirty |= LABEL_LEFT(ImGui::DragFloat3, "Normal", &_normal.x, 0.01f, -1.0f, 1.0f);
 	}
@@ -27,6 +27,16 @@ namespace Gameplay::Physics {
 		_guid(Guid::New())
 	{ }
 
+	ICollider::ICollider(const ICollider& other) :
+		_type(other._type),
+		_shape(nullptr),
+		_isDirty(true),
+		_position(other._position),
+		_rotation(other._rotation),
+		_scale(other._scale),
+		_guid(Guid::New())
+	{ }
+
 	ICollider::~ICollider() {
 		if (_shape != nullptr) {
 			delete _shape;
@@ -141,6 +141,12 @@ namespace Gameplay::Physics {
 		/// <returns>A new collider of the given type with default values</returns>
 		static ICollider::Sptr Create(ColliderType type);
 
+		/// <summary>
+		/// Creates a copy of this collider's settings, the copy gets its own GUID and
+		/// builds its own shape when it's first used
+		/// </summary>
+		virtual ICollider::Sptr Clone() const = 0;
+
 	protected:
 		// Stores type 
 		ColliderType _type;
@@ -149,6 +155,7 @@ namespace Gameplay::Physics {
 		mutable bool _isDirty;
 
 		ICollider(ColliderType type);
+		ICollider(const ICollider& other);
 
 		/// <summary>
 		/// Creates the bullet collision shape from this collider's info
@@ -21,6 +21,24 @@ int PhysicsBase::_editorSelectedColliderType = 0;
 		_prevScale(glm::vec3(1.0f))
 	{ }
 
+	PhysicsBase::PhysicsBase(const PhysicsBase& other) :
+		IComponent(other),
+		_scene(nullptr),
+		_shape(nullptr),
+		_colliders(std::vector<ICollider::Sptr>()),
+		_isShapeDirty(true),
+		_collisionGroup(other._collisionGroup),
+		_collisionMask(other._collisionMask),
+		_isGroupMaskDirty(true),
+		_prevScale(other._prevScale)
+	{
+		// Colliders own their bullet shapes, so each copy needs colliders of its own
+		_colliders.reserve(other._colliders.size());
+		for (const auto& collider : other._colliders) {
+			_colliders.push_back(collider->Clone());
+		}
+	}
+
 	PhysicsBase::~PhysicsBase() {
 		if (_scene != nullptr) {
 			delete _shape;
@@ -104,6 +104,8 @@ namespace Gameplay {
 			glm::vec3 _prevScale;
 
 			PhysicsBase();
+			// Copies our settings and colliders, but none of the bullet state
+			PhysicsBase(const PhysicsBase& other);
 
 			void _RenderImGuiBase();
 
@@ -27,7 +27,16 @@ namespace Gameplay::Physics {
 		_angularVelocity(btVector3(0, 0, 0)),
 		_angularVelocityDirty(false),
 		_angularFactor(btVector3(1,1,1)),
-		_angularFactorDirty(false)
+		_angularFactorDirty(false),
+		_prevPhysicsPosition(glm::vec3(0.0f)),
+		_prevPhysicsRotation(glm::quat(1.0f, 0.0f, 0.0f, 0.0f)),
+		_physicsPosition(glm::vec3(0.0f)),
+		_physicsRotation(glm::quat(1.0f, 0.0f, 0.0f, 0.0f)),
+		_hasPhysicsPose(false),
+		_isPositionInterpolated(false),
+		_isRotationInterpolated(false),
+		_frameForce(btVector3(0, 0, 0)),
+		_frameTorque(btVector3(0, 0, 0))
 	{ }
 
 	RigidBody::~RigidBody() {
@@ -101,11 +110,13 @@ namespace Gameplay::Physics {
 	}
 
 	void RigidBody::ApplyForce(const glm::vec3& worldForce) {
-		_body->applyCentralForce(ToBt(worldForce));
+		_frameForce += ToBt(worldForce);
 	}
 
 	void RigidBody::ApplyForce(const glm::vec3& worldForce, const glm::vec3& localOffset) {
-		_body->applyForce(ToBt(worldForce), ToBt(localOffset));
+		// Same split as btRigidBody::applyForce, a central force plus the torque from the offset
+		_frameForce += ToBt(worldForce);
+		_frameTorque += ToBt(localOffset).cross(ToBt(worldForce));
 	}
 
 	void RigidBody::ApplyImpulse(const glm::vec3& worldForce) {
@@ -117,7 +128,12 @@ namespace Gameplay::Physics {
 	}
 
 	void RigidBody::ApplyTorque(const glm::vec3& worldTorque) {
-		_body->applyTorque(ToBt(worldTorque));
+		_frameTorque += ToBt(worldTorque);
+	}
+
+	void RigidBody::ClearFrameForces() {
+		_frameForce.setZero();
+		_frameTorque.setZero();
 	}
 
 	void RigidBody::ApplyTorqueImpulse(const glm::vec3& worldTorque) {
@@ -165,6 +181,16 @@ namespace Gameplay::Physics {
 			// Copy to body and to it's motion state
 			if (_type == RigidBodyType::Dynamic) {
 				_body->setWorldTransform(transform);
+
+				// Remember where we started this step, so rendering can blend from here
+				GameObject* context = GetGameObject();
+				_prevPhysicsPosition = context->GetPosition();
+				_prevPhysicsRotation = context->GetRotation();
+
+				// Bullet clears its forces after every step, so the forces from this frame's update
+				// get applied again for each step we take until the next update
+				_body->applyCentralForce(_frameForce);
+				_body->applyTorque(_frameTorque);
 			} else {
 				// Kinematics prefer to be driven my motion state for some reason :|
 				_body->getMotionState()->setWorldTransform(transform);
@@ -182,6 +208,52 @@ namespace Gameplay::Physics {
 			_linearVelocity = _body->getLinearVelocity();
 			_angularVelocity = _body->getAngularVelocity();
 		}
+
+		// Sleeping bodies still need their pose recorded, so they don't blend from a stale one
+		if (_type == RigidBodyType::Dynamic) {
+			GameObject* context = GetGameObject();
+			_physicsPosition = context->GetPosition();
+			_physicsRotation = context->GetRotation();
+			_hasPhysicsPose = true;
+		}
+	}
+
+	void RigidBody::ApplyInterpolation(float alpha) {
+		if (_type != RigidBodyType::Dynamic || !_hasPhysicsPose) {
+			return;
+		}
+
+		GameObject* context = GetGameObject();
+
+		// If something else moved us since the step (ex: a teleport, or a controller setting our
+		// facing) there's nothing sensible to blend from, so leave that part of the pose alone
+		glm::vec3 position = context->GetPosition();
+		if (position == _physicsPosition) {
+			context->SetPosition(glm::mix(_prevPhysicsPosition, _physicsPosition, alpha));
+			_isPositionInterpolated = true;
+		} else {
+			_prevPhysicsPosition = _physicsPosition = position;
+		}
+
+		glm::quat rotation = context->GetRotation();
+		if (rotation == _physicsRotation) {
+			context->SetRotation(glm::slerp(_prevPhysicsRotation, _physicsRotation, alpha));
+			_isRotationInterpolated = true;
+		} else {
+			_prevPhysicsRotation = _physicsRotation = rotation;
+		}
+	}
+
+	void RigidBody::RestoreSimulatedTransform() {
+		GameObject* context = GetGameObject();
+		if (_isPositionInterpolated) {
+			context->SetPosition(_physicsPosition);
+			_isPositionInterpolated = false;
+		}
+		if (_isRotationInterpolated) {
+			context->SetRotation(_physicsRotation);
+			_isRotationInterpolated = false;
+		}
 	}
 
 	void RigidBody::Awake() {
@@ -222,7 +294,10 @@ namespace Gameplay::Physics {
 		// Add a pointer to our own weak reference to allow getting this component as a shared_ptr later
 		_body->setUserPointer(&SelfRef());
 
-		_scene->GetPhysicsWorld()->addRigidBody(_body);
+		// Inactive objects (like pooled ones) only join the world once they're activated
+		if (context->IsActive()) {
+			_scene->GetPhysicsWorld()->addRigidBody(_body, _collisionGroup, _collisionMask);
+		}
 
 		// If the object is kinematic (driven by a controller), tell bullet that
 		if (_type == RigidBodyType::Kinematic) {
@@ -239,11 +314,36 @@ namespace Gameplay::Physics {
 		}
 
 		//_body->setFriction(1.0f);
+	}
 
+	void RigidBody::OnDeactivated() {
+		if (_body != nullptr) {
+			// The body and shape are kept around, so coming back is just re-inserting into the broadphase
+			_scene->GetPhysicsWorld()->removeRigidBody(_body);
+		}
+	}
+
+	void RigidBody::OnActivated() {
+		if (_body == nullptr) {
+			return;
+		}
 
-		// Copy over group and mask info
-		_body->getBroadphaseProxy()->m_collisionFilterGroup = _collisionGroup;
-		_body->getBroadphaseProxy()->m_collisionFilterMask  = _collisionMask;
+		// Start fresh from wherever the object was placed, rather than where it was when it was put away
+		btTransform transform;
+		_CopyGameobjectTransformTo(transform);
+		_body->setWorldTransform(transform);
+		_body->getMotionState()->setWorldTransform(transform);
+		_body->setInterpolationWorldTransform(transform);
+
+		_linearVelocity = btVector3(0, 0, 0);
+		_angularVelocity = btVector3(0, 0, 0);
+		_body->setLinearVelocity(_linearVelocity);
+		_body->setAngularVelocity(_angularVelocity);
+		_body->clearForces();
+		_hasPhysicsPose = false;
+
+		_scene->GetPhysicsWorld()->addRigidBody(_body, _collisionGroup, _collisionMask);
+		_body->activate(true);
 	}
 
 	void RigidBody::RenderImGui()
@@ -2,6 +2,8 @@
 #include <EnumToString.h>
 #include <btBulletCollisionCommon.h>
 #include <btBulletDynamicsCommon.h>
+#include <GLM/glm.hpp>
+#include <GLM/gtc/quaternion.hpp>
 
 #include "Gameplay/Components/IComponent.h"
 #include "Gameplay/Physics/ICollider.h"
@@ -108,7 +110,8 @@ namespace Gameplay::Physics {
 
 		/// <summary>
 		/// Applies a force in world space to this object, this would be used
-		/// if you want to apply a force every frame on an object
+		/// if you want to apply a force every frame on an object. The force is
+		/// held for every physics step until the next update
 		/// </summary>
 		/// <param name="worldForce">The force in world space and Newtons</param>
 		void ApplyForce(const glm::vec3& worldForce);
@@ -132,7 +135,8 @@ namespace Gameplay::Physics {
 		/// <param name="localOffset">The offset from the object in worldspace units to apply the impulse</param>
 		void ApplyImpulse(const glm::vec3& worldForce, const glm::vec3& localOffset);
 		/// <summary>
-		/// Applies torque (rotational energy) to the object
+		/// Applies torque (rotational energy) to the object, held for every physics
+		/// step until the next update
 		/// </summary>
 		/// <param name="worldTorque">The torque, in world units and in Nm</param>
 		void ApplyTorque(const glm::vec3& worldTorque);
@@ -142,6 +146,12 @@ namespace Gameplay::Physics {
 		/// <param name="worldTorque">The torque, in radians per second and world space</param>
 		void ApplyTorqueImpulse(const glm::vec3& worldTorque);
 
+		/// <summary>
+		/// Drops the forces and torques applied since the last update, called by the
+		/// scene before components are updated
+		/// </summary>
+		void ClearFrameForces();
+
 		/// <summary>
 		/// Sets the type of rigid body (static, dynamic, kinematic)
 		/// </summary>
@@ -165,8 +175,22 @@ namespace Gameplay::Physics {
 		/// <param name="dt">The time in seconds since the last frame</param>
 		virtual void PhysicsPostStep(float dt) override;
 
+		/// <summary>
+		/// Moves a dynamic body's game object to a blend between the poses from the last two
+		/// physics steps, for rendering. Any part of the pose that something other than physics
+		/// changed since the last step is left as is
+		/// </summary>
+		/// <param name="alpha">0 for the previous step's pose, 1 for the current step's pose</param>
+		void ApplyInterpolation(float alpha);
+		/// <summary>
+		/// Puts the game object back to the pose from the last physics step, after ApplyInterpolation
+		/// </summary>
+		void RestoreSimulatedTransform();
+
 		// Inherited from IComponent
 		virtual void Awake() override;
+		virtual void OnDeactivated() override;
+		virtual void OnActivated() override;
 		virtual void RenderImGui() override;
 		virtual nlohmann::json ToJson() const override;
 		static RigidBody::Sptr FromJson(const nlohmann::json& data);
@@ -198,6 +222,19 @@ namespace Gameplay::Physics {
 		btVector3        _angularFactor;
 		bool             _angularFactorDirty;
 
+		// The game object's pose before and after the last physics step, for interpolating between them
+		glm::vec3        _prevPhysicsPosition;
+		glm::quat        _prevPhysicsRotation;
+		glm::vec3        _physicsPosition;
+		glm::quat        _physicsRotation;
+		bool             _hasPhysicsPose;
+		bool             _isPositionInterpolated;
+		bool             _isRotationInterpolated;
+
+		// The force and torque applied during the current frame, re-applied before every physics step
+		btVector3        _frameForce;
+		btVector3        _frameTorque;
+
 		// Handles resolving any dirty state stuff for our object
 		void _HandleStateDirty();
 
@@ -167,12 +167,38 @@ namespace Gameplay::Physics {
 		_CopyGameobjectTransformTo(transform);
 		_ghost->setWorldTransform(transform);
 
-		// Add the object to the scene
-		_scene->GetPhysicsWorld()->addCollisionObject(_ghost);
-		
-		// Copy over group and mask info
-		_ghost->getBroadphaseHandle()->m_collisionFilterGroup = _collisionGroup;
-		_ghost->getBroadphaseHandle()->m_collisionFilterMask  = _collisionMask;
+		// Add the object to the scene, inactive objects wait until they're activated
+		if (context->IsActive()) {
+			_scene->GetPhysicsWorld()->addCollisionObject(_ghost, _collisionGroup, _collisionMask);
+		}
+	}
+
+	void TriggerVolume::OnDeactivated() {
+		if (_ghost == nullptr) {
+			return;
+		}
+		_scene->GetPhysicsWorld()->removeCollisionObject(_ghost);
+
+		// Anything that was inside us won't get a chance to see us leave otherwise
+		TriggerVolume::Sptr self = std::dynamic_pointer_cast<TriggerVolume>(SelfRef().lock());
+		for (auto& weakPtr : _currentCollisions) {
+			RigidBody::Sptr body = weakPtr.lock();
+			if (body != nullptr) {
+				body->GetGameObject()->OnLeavingTrigger(self);
+				GetGameObject()->OnTriggerVolumeLeaving(body);
+			}
+		}
+		_currentCollisions.clear();
+	}
+
+	void TriggerVolume::OnActivated() {
+		if (_ghost == nullptr) {
+			return;
+		}
+		btTransform transform;
+		_CopyGameobjectTransformTo(transform);
+		_ghost->setWorldTransform(transform);
+		_scene->GetPhysicsWorld()->addCollisionObject(_ghost, _collisionGroup, _collisionMask);
 	}
 
 	void TriggerVolume::RenderImGui() {
@@ -45,6 +45,8 @@ namespace Gameplay::Physics {
 		// Inherited from IComponent
 
 		virtual void Awake() override;
+		virtual void OnDeactivated() override;
+		virtual void OnActivated() override;
 		virtual void RenderImGui() override;
 		virtual nlohmann::json ToJson() const override;
 		static TriggerVolume::Sptr FromJson(const nlohmann::json& data);
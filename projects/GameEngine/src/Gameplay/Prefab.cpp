@@ -0,0 +1,109 @@
+#include "Gameplay/Prefab.h"
+#include "Gameplay/Scene.h"
+
+namespace Gameplay {
+	Prefab::Sptr Prefab::Create(const GameObject::Sptr& root) {
+		LOG_ASSERT(root != nullptr, "Cannot create a prefab from a null object");
+		Prefab::Sptr result(new Prefab());
+
+		// Flatten the hierarchy so that parents always come before their children
+		std::vector<GameObject::Sptr> objects;
+		std::vector<int> parents;
+		objects.push_back(root);
+		parents.push_back(-1);
+		for (size_t ix = 0; ix < objects.size(); ix++) {
+			for (const auto& child : objects[ix]->GetChildren()) {
+				GameObject::Sptr childPtr = child;
+				if (childPtr != nullptr) {
+					objects.push_back(childPtr);
+					parents.push_back(static_cast<int>(ix));
+				}
+			}
+		}
+
+		result->_objects.reserve(objects.size());
+		for (size_t ix = 0; ix < objects.size(); ix++) {
+			const GameObject::Sptr& object = objects[ix];
+
+			ObjectRecord record;
+			record.Name = object->Name;
+			record.Parent = parents[ix];
+			record.HideInHierarchy = object->HideInHierarchy;
+			record.Position = object->GetPosition();
+			record.Rotation = object->GetRotation();
+			record.Scale = object->GetScale();
+
+			record.Components.reserve(object->_components.size());
+			for (size_t componentIx = 0; componentIx < object->_components.size(); componentIx++) {
+				const IComponent::Sptr& component = object->_components[componentIx];
+
+				// Going through the component's own serialization gives us a template without any of the
+				// original's runtime state (physics bodies, GPU buffers and so on)
+				nlohmann::json blob = component->ToJson();
+				IComponent::SaveBaseJson(component, blob);
+				IComponent::Sptr templateComponent = ComponentManager::LoadUnregistered(component->ComponentTypeName(), blob);
+				if (templateComponent == nullptr) {
+					LOG_WARN("Prefab \"{}\" skipped a component of unregistered type {}", root->Name, component->ComponentTypeName());
+					continue;
+				}
+
+				// A prefab captured from an inactive object should still produce working copies
+				if (!object->IsActive() && componentIx < object->_enabledBeforeDeactivate.size()) {
+					templateComponent->IsEnabled = object->_enabledBeforeDeactivate[componentIx];
+				}
+
+				record.Components.push_back(std::move(templateComponent));
+			}
+
+			result->_objects.push_back(std::move(record));
+		}
+
+		return result;
+	}
+
+	GameObject::Sptr Prefab::Instantiate(Scene* scene) const {
+		return Instantiate(scene, _objects[0].Position, _objects[0].Rotation);
+	}
+
+	GameObject::Sptr Prefab::Instantiate(Scene* scene, const glm::vec3& position, const glm::quat& rotation) const {
+		LOG_ASSERT(scene != nullptr, "Cannot instantiate a prefab without a scene");
+
+		std::vector<GameObject::Sptr> objects;
+		objects.reserve(_objects.size());
+		for (size_t ix = 0; ix < _objects.size(); ix++) {
+			const ObjectRecord& record = _objects[ix];
+
+			GameObject::Sptr object = scene->CreateGameObject(record.Name);
+			object->HideInHierarchy = record.HideInHierarchy;
+			if (record.Parent >= 0) {
+				objects[record.Parent]->AddChild(object);
+				object->SetPosition(record.Position);
+				object->SetRotation(record.Rotation);
+			} else {
+				object->SetPosition(position);
+				object->SetRotation(rotation);
+			}
+			object->SetScale(record.Scale);
+
+			// Copy the templates, the objects and components all get new GUIDs as they're created
+			for (const IComponent::Sptr& component : record.Components) {
+				object->_CloneComponent(*component);
+			}
+
+			objects.push_back(object);
+		}
+
+		// Wake everything up together, like a scene does when it's loaded
+		if (scene->GetIsAwake()) {
+			for (const auto& object : objects) {
+				object->Awake();
+			}
+		}
+
+		return objects[0];
+	}
+
+	const std::string& Prefab::GetName() const {
+		return _objects[0].Name;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Gameplay/GameObject.h"
+#include "Utils/Macros.h"
+
+namespace Gameplay {
+	class Scene;
+
+	/// <summary>
+	/// A template for a game object and its children, captured once and then stamped out as
+	/// many times as needed. When the prefab is created, the components are loaded into templates
+	/// that never join a scene, so they are never updated or woken up
+	///
+	/// Instantiating copy constructs each template, and only fixes up what has to be unique to
+	/// the new copy: its GUID, the object it's attached to, and its place in the component pools
+	/// </summary>
+	class Prefab {
+	public:
+		MAKE_PTRS(Prefab);
+
+		/// <summary>
+		/// Captures a game object and all of its children into a new prefab. The original objects
+		/// are not modified, and can be removed from the scene afterwards
+		/// </summary>
+		/// <param name="root">The object at the top of the hierarchy to capture</param>
+		static Prefab::Sptr Create(const GameObject::Sptr& root);
+
+		/// <summary>
+		/// Creates a new copy of the prefab's objects in the given scene. If the scene is already
+		/// awake, the new components are woken up once the whole hierarchy has been created, so they
+		/// can find each other in Awake
+		/// </summary>
+		/// <param name="scene">The scene to create the objects in</param>
+		/// <param name="position">The local position for the new root object</param>
+		/// <param name="rotation">The local rotation for the new root object</param>
+		/// <returns>The new root object</returns>
+		GameObject::Sptr Instantiate(Scene* scene, const glm::vec3& position, const glm::quat& rotation) const;
+		/// <summary>
+		/// Creates a new copy of the prefab's objects in the given scene, at the same position as the
+		/// object the prefab was captured from
+		/// </summary>
+		GameObject::Sptr Instantiate(Scene* scene) const;
+
+		/// <summary>
+		/// Gets the name of the prefab's root object
+		/// </summary>
+		const std::string& GetName() const;
+		/// <summary>
+		/// Gets the number of objects that each instance of the prefab creates
+		/// </summary>
+		size_t NumObjects() const { return _objects.size(); }
+
+	protected:
+		Prefab() = default;
+
+		struct ObjectRecord {
+			std::string Name;
+			// Index of the parent in _objects, parents always come before their children
+			int         Parent;
+			bool        HideInHierarchy;
+			glm::vec3   Position;
+			glm::quat   Rotation;
+			glm::vec3   Scale;
+			// Components that aren't attached to anything or in any pools, copied into each instance
+			std::vector<IComponent::Sptr> Components;
+		};
+
+		std::vector<ObjectRecord> _objects;
+	};
+}
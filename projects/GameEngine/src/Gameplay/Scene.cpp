@@ -3,10 +3,14 @@
 #include <GLFW/glfw3.h>
 #include <locale>
 #include <codecvt>
+#include <filesystem>
 
+#include "Utils/AsyncLoader.h"
 #include "Utils/FileHelpers.h"
+#include "Utils/MemoryMappedFile.h"
 #include "Utils/GlmBulletConversions.h"
 
+#include "Gameplay/SceneBinary.h"
 #include "Gameplay/Physics/RigidBody.h"
 #include "Gameplay/Physics/TriggerVolume.h"
 #include "Gameplay/MeshResource.h"
@@ -26,6 +30,8 @@ namespace Gameplay {
 		MainCamera(nullptr),
 		DefaultMaterial(nullptr),
 		_isAwake(false),
+		_isInterpolated(false),
+		_physicsStepsSinceForceClear(0),
 		_filePath(""),
 		_skyboxShader(nullptr),
 		_skyboxMesh(nullptr),
@@ -47,7 +53,11 @@ namespace Gameplay {
 		_skyboxShader = nullptr;
 		_skyboxMesh = nullptr;
 		_skyboxTexture = nullptr;
-		_objects.clear();
+		// Anything that outlives us keeps its transform, but can't keep it in our transform system
+		for (const auto& object : _objects) {
+			object->_DetachTransform();
+		}
+		_ClearObjects();
 		_components.Clear();
 		_CleanupPhysics();
 		IsDestroyed = true;
@@ -95,33 +105,70 @@ namespace Gameplay {
 
 	GameObject::Sptr Scene::CreateGameObject(const std::string& name)
 	{
+		LOG_ASSERT(!_components.IsUpdatingInParallel(), "Game objects can't be created during parallel updates, use Commands instead");
+		AsyncLoader::YieldIfOverBudget();
+
 		GameObject::Sptr result(new GameObject());
 		result->Name = name;
-		result->_scene = this;
+		result->_SetScene(this);
 		result->_selfRef = result;
-		_objects.push_back(result);
+		_AddObject(result);
 		return result;
 	}
 
 	void Scene::RemoveGameObject(const GameObject::Sptr& object) {
-		_deletionQueue.push_back(object);
-		for (const auto& child : object->_children) {
-			RemoveGameObject(child);
+		LOG_ASSERT(!_components.IsUpdatingInParallel(), "Game objects can't be removed during parallel updates, use Commands instead");
+		_QueueForDeletion(object);
+	}
+
+	void Scene::RemoveGameObjects(const std::vector<GameObject::Sptr>& objects) {
+		LOG_ASSERT(!_components.IsUpdatingInParallel(), "Game objects can't be removed during parallel updates, use Commands instead");
+		_deletionQueue.reserve(_deletionQueue.size() + objects.size());
+		for (const auto& object : objects) {
+			_QueueForDeletion(object);
 		}
 	}
 
-	GameObject::Sptr Scene::FindObjectByName(const std::string name) const {
-		auto it = std::find_if(_objects.begin(), _objects.end(), [&](const GameObject::Sptr& obj) {
-			return obj->Name == name;
-		});
-		return it == _objects.end() ? nullptr : *it;
+	void Scene::RemoveAllGameObjects() {
+		LOG_ASSERT(!_components.IsUpdatingInParallel(), "Game objects can't be removed during parallel updates, use Commands instead");
+		// Children are in the object list too, so there's no need to walk the hierarchy
+		_deletionQueue.reserve(_deletionQueue.size() + _objects.size());
+		for (const auto& object : _objects) {
+			if (!object->_isQueuedForDeletion) {
+				object->_isQueuedForDeletion = true;
+				_deletionQueue.push_back(object);
+			}
+		}
+	}
+
+	GameObject::Sptr Scene::FindObjectByName(const std::string& name) const {
+		auto it = _nameIndex.find(name);
+		return it == _nameIndex.end() ? nullptr : it->second.front()->SelfRef();
+	}
+
+	void Scene::FindObjectsByName(const std::string& name, std::vector<GameObject::Sptr>& result) const {
+		auto it = _nameIndex.find(name);
+		if (it != _nameIndex.end()) {
+			result.reserve(result.size() + it->second.size());
+			for (GameObject* object : it->second) {
+				result.push_back(object->SelfRef());
+			}
+		}
 	}
 
 	GameObject::Sptr Scene::FindObjectByGUID(Guid id) const {
-		auto it = std::find_if(_objects.begin(), _objects.end(), [&](const GameObject::Sptr& obj) {
-			return obj->_guid == id;
-		});
-		return it == _objects.end() ? nullptr : *it;
+		auto it = _guidIndex.find(id);
+		return it == _guidIndex.end() ? nullptr : it->second->SelfRef();
+	}
+
+	GameObject::Sptr Scene::FindObjectByHandle(GameObjectHandle handle) const {
+		return IsHandleValid(handle) ? _objectSlots[handle.Index].Object->SelfRef() : nullptr;
+	}
+
+	bool Scene::IsHandleValid(GameObjectHandle handle) const {
+		return handle.Index < _objectSlots.size() &&
+			_objectSlots[handle.Index].Generation == handle.Generation &&
+			_objectSlots[handle.Index].Object != nullptr;
 	}
 
 	void Scene::SetAmbientLight(const glm::vec3& value) {
@@ -156,27 +203,59 @@ namespace Gameplay {
 		_isAwake = true;
 	}
 
-	void Scene::DoPhysics(float dt) {
-		_components.Each<Gameplay::Physics::RigidBody>([=](const std::shared_ptr<Gameplay::Physics::RigidBody>& body) {
+	void Scene::DoPhysics(float dt, bool isFixedStep) {
+		_RestoreSimulatedTransforms();
+
+		_components.Each<Gameplay::Physics::RigidBody>([=](Gameplay::Physics::RigidBody* body) {
 			body->PhysicsPreStep(dt);
 		});
-		_components.Each<Gameplay::Physics::TriggerVolume>([=](const std::shared_ptr<Gameplay::Physics::TriggerVolume>& body) {
+		_components.Each<Gameplay::Physics::TriggerVolume>([=](Gameplay::Physics::TriggerVolume* body) {
 			body->PhysicsPreStep(dt);
 		});
 
 		if (IsPlaying) {
 
-			_physicsWorld->stepSimulation(dt, 1);
+			if (isFixedStep) {
+				// Advance by exactly one step of our own length, so bullet doesn't accumulate time on top of us
+				_physicsWorld->stepSimulation(dt, 1, dt);
+			} else {
+				_physicsWorld->stepSimulation(dt, 1);
+			}
+			_physicsStepsSinceForceClear++;
 
-			_components.Each<Gameplay::Physics::RigidBody>([=](const std::shared_ptr<Gameplay::Physics::RigidBody>& body) {
+			_components.Each<Gameplay::Physics::RigidBody>([=](Gameplay::Physics::RigidBody* body) {
 				body->PhysicsPostStep(dt);
 			});
-			_components.Each<Gameplay::Physics::TriggerVolume>([=](const std::shared_ptr<Gameplay::Physics::TriggerVolume>& body) {
+			_components.Each<Gameplay::Physics::TriggerVolume>([=](Gameplay::Physics::TriggerVolume* body) {
 				body->PhysicsPostStep(dt);
 			});
 		}
 	}
 
+	void Scene::UpdateTransforms() {
+		_transforms.Propagate();
+	}
+
+	void Scene::InterpolateTransforms(float alpha) {
+		if (!IsPlaying) {
+			return;
+		}
+		_components.Each<Gameplay::Physics::RigidBody>([=](Gameplay::Physics::RigidBody* body) {
+			body->ApplyInterpolation(alpha);
+		});
+		_isInterpolated = true;
+	}
+
+	void Scene::_RestoreSimulatedTransforms() {
+		if (!_isInterpolated) {
+			return;
+		}
+		_components.Each<Gameplay::Physics::RigidBody>([](Gameplay::Physics::RigidBody* body) {
+			body->RestoreSimulatedTransform();
+		});
+		_isInterpolated = false;
+	}
+
 	void Scene::DrawPhysicsDebug() {
 		if (_bulletDebugDraw->getDebugMode() != btIDebugDraw::DBG_NoDebug) {
 			_physicsWorld->debugDrawWorld();
@@ -185,12 +264,28 @@ namespace Gameplay {
 	}
 
 	void Scene::Update(float dt) {
+		_RestoreSimulatedTransforms();
 		_FlushDeleteQueue();
+
+		// Forces only last for the frame they were applied in, but frames that don't run a fixed step
+		// have to hold on to them until one does
+		if (_physicsStepsSinceForceClear > 0) {
+			_components.Each<Gameplay::Physics::RigidBody>([](Gameplay::Physics::RigidBody* body) {
+				body->ClearFrameForces();
+			});
+			_physicsStepsSinceForceClear = 0;
+		}
+
 		if (IsPlaying) {
 			for (int i = 0; i < _objects.size(); i++) {
 				_objects[i]->Update(dt);
 			}
+
+			// Components that declared their update as thread safe run in parallel, one type at a time
+			_components.UpdateParallel(dt);
 		}
+		// Apply anything that was recorded during the update, now that we're back on one thread
+		_commands.Flush(*this);
 		_FlushDeleteQueue();
 	}
 
@@ -214,20 +309,8 @@ namespace Gameplay {
 
 		Scene::Sptr result = std::make_shared<Scene>();
 		result->MainCamera = nullptr;
-		result->_objects.clear();
-		result->DefaultMaterial = ResourceManager::Get<Material>(Guid(data["default_material"]));
-
-		if (data.contains("ambient")) {
-			result->SetAmbientLight((data["ambient"]));
-		}
-
-		if (data.contains("skybox") && data["skybox"].is_object()) {
-			nlohmann::json& blob = data["skybox"].get<nlohmann::json>();
-			result->_skyboxMesh = ResourceManager::Get<MeshResource>(Guid(blob["mesh"]));
-			result->SetSkyboxShader(ResourceManager::Get<ShaderProgram>(Guid(blob["shader"])));
-			result->SetSkyboxTexture(ResourceManager::Get<TextureCube>(Guid(blob["texture"])));
-			result->SetSkyboxRotation(glm::mat3_cast((glm::quat)(blob["orientation"])));
-		}
+		result->_ClearObjects();
+		result->_LoadSettingsJson(data);
 
 		// Make sure the scene has objects, then load them all in!
 		LOG_ASSERT(data["objects"].is_array(), "Objects not present in scene!");
@@ -236,24 +319,46 @@ namespace Gameplay {
 			obj->_scene = result.get();
 			obj->_parent.SceneContext = result.get();
 			obj->_selfRef = obj;
-			result->_objects.push_back(obj);
+			result->_AddObject(obj);
 		}
 
-		// Re-build the parent hierarchy 
-		for (const auto& object : result->_objects) {
-			if (object->GetParent() != nullptr) {
-				object->GetParent()->AddChild(object);
-			}
-		}
-
-		// Create and load camera config
-		result->MainCamera = result->_components.GetComponentByGUID<Camera>(Guid(data["main_camera"]));
+		result->_FinishLoad(data);
 	
 		return result;
 	}
 
 	nlohmann::json Scene::ToJson() const
 	{
+		nlohmann::json blob = _SettingsToJson();
+
+		// Save renderables
+		std::vector<nlohmann::json> objects;
+		objects.resize(_objects.size());
+		for (int ix = 0; ix < _objects.size(); ix++) {
+			objects[ix] = _objects[ix]->ToJson();
+		}
+		blob["objects"] = objects;
+
+		return blob;
+	}
+
+	void Scene::_LoadSettingsJson(const nlohmann::json& data) {
+		DefaultMaterial = ResourceManager::Get<Material>(Guid(data["default_material"]));
+
+		if (data.contains("ambient")) {
+			SetAmbientLight((data["ambient"]));
+		}
+
+		if (data.contains("skybox") && data["skybox"].is_object()) {
+			const nlohmann::json& blob = data["skybox"];
+			_skyboxMesh = ResourceManager::Get<MeshResource>(Guid(blob["mesh"]));
+			SetSkyboxShader(ResourceManager::Get<ShaderProgram>(Guid(blob["shader"])));
+			SetSkyboxTexture(ResourceManager::Get<TextureCube>(Guid(blob["texture"])));
+			SetSkyboxRotation(glm::mat3_cast((glm::quat)(blob["orientation"])));
+		}
+	}
+
+	nlohmann::json Scene::_SettingsToJson() const {
 		nlohmann::json blob;
 		// Save the default shader (really need a material class)
 		blob["default_material"] = DefaultMaterial ? DefaultMaterial->GetGUID().str() : "null";
@@ -266,34 +371,86 @@ namespace Gameplay {
 		blob["skybox"]["texture"] = _skyboxTexture ? _skyboxTexture->GetGUID().str() : "null";
 		blob["skybox"]["orientation"] = (glm::quat)_skyboxRotation;
 
-		// Save renderables
-		std::vector<nlohmann::json> objects;
-		objects.resize(_objects.size());
-		for (int ix = 0; ix < _objects.size(); ix++) {
-			objects[ix] = _objects[ix]->ToJson();
-		}
-		blob["objects"] = objects;
-
 		// Save camera info
 		blob["main_camera"] = MainCamera != nullptr ? MainCamera->GetGUID().str() : "null";
 
 		return blob;
 	}
 
+	void Scene::_FinishLoad(const nlohmann::json& settings) {
+		// Re-build the parent hierarchy 
+		for (const auto& object : _objects) {
+			if (object->GetParent() != nullptr) {
+				object->GetParent()->AddChild(object);
+			}
+		}
+
+		// Create and load camera config
+		MainCamera = _components.GetComponentByGUID<Camera>(Guid(settings["main_camera"]));
+	}
+
 	void Scene::Save(const std::string& path) {
 		_filePath = path;
+		// Make sure we save where the bodies actually are, not where they were drawn
+		_RestoreSimulatedTransforms();
 		// Save data to file
 		FileHelpers::WriteContentsToFile(path, ToJson().dump(1, '\t'));
 		LOG_INFO("Saved scene to \"{}\"", path);
 	}
 
 	Scene::Sptr Scene::Load(const std::string& path)
+	{
+		// JSON scenes get a binary snapshot baked next to them, which we load instead for as long as it's newer than the JSON
+		std::filesystem::path binaryPath = std::filesystem::path(path).replace_extension(SCENE_BINARY_EXTENSION);
+		const bool isJson = binaryPath != std::filesystem::path(path);
+
+		// If we can't tell how old either file is, the JSON is the safe choice
+		bool isBinaryCurrent = false;
+		std::error_code error;
+		if (isJson && std::filesystem::exists(binaryPath, error) && !error) {
+			const std::filesystem::file_time_type binaryTime = std::filesystem::last_write_time(binaryPath, error);
+			if (!error) {
+				const std::filesystem::file_time_type jsonTime = std::filesystem::last_write_time(path, error);
+				isBinaryCurrent = !error && binaryTime >= jsonTime;
+			}
+		}
+
+		if (isBinaryCurrent) {
+			Scene::Sptr result = _LoadFile(binaryPath.string());
+			if (result != nullptr) {
+				// Saving should still go to the JSON file
+				result->_filePath = path;
+				return result;
+			}
+			LOG_WARN("Binary scene \"{}\" could not be loaded, re-building it from \"{}\"", binaryPath.string(), path);
+		}
+
+		Scene::Sptr result = _LoadFile(path);
+		if (result != nullptr && isJson) {
+			result->SaveBinary(binaryPath.string());
+		}
+		return result;
+	}
+
+	Scene::Sptr Scene::_LoadFile(const std::string& path)
 	{
 		LOG_INFO("Loading scene from \"{}\"", path);
-		std::string content = FileHelpers::ReadFile(path);
-		nlohmann::json blob = nlohmann::json::parse(content);
-		Scene::Sptr result = FromJson(blob);
-		result->_filePath = path;
+		// Map the file rather than reading it, both formats can be parsed straight from the mapping
+		MemoryMappedFile file;
+		if (!file.Open(path)) {
+			return nullptr;
+		}
+
+		Scene::Sptr result;
+		if (IsBinary(file.Data(), file.Size())) {
+			result = FromBinary(file.Data(), file.Size());
+		} else {
+			nlohmann::json blob = nlohmann::json::parse(file.Data(), file.Data() + file.Size());
+			result = FromJson(blob);
+		}
+		if (result != nullptr) {
+			result->_filePath = path;
+		}
 		return result;
 	}
 
@@ -336,14 +493,147 @@ namespace Gameplay {
 
 
 	void Scene::_FlushDeleteQueue() {
-		for (auto& weakPtr : _deletionQueue) {
-			if (weakPtr.expired()) continue;
-			auto& it = std::find(_objects.begin(), _objects.end(), weakPtr.lock());
-			if (it != _objects.end()) {
-				_objects.erase(it);
+		std::vector<std::weak_ptr<GameObject>> queue;
+		// Destroying an object can queue more deletions, so keep going until nothing new shows up
+		while (!_deletionQueue.empty()) {
+			queue.swap(_deletionQueue);
+			for (auto& weakPtr : queue) {
+				GameObject::Sptr object = weakPtr.lock();
+				if (object == nullptr) continue;
+				object->_isQueuedForDeletion = false;
+
+				const uint32_t index = object->_sceneIndex;
+				if (index >= _objects.size() || _objects[index] != object) continue;
+				_UnindexObject(object.get());
+
+				// Fill the hole with the last object rather than shifting everything down
+				if (index != _objects.size() - 1) {
+					_objects[index] = std::move(_objects.back());
+					_objects[index]->_sceneIndex = index;
+				}
+				_objects.pop_back();
+				object->_sceneIndex = GameObject::NO_SCENE_INDEX;
+				// Someone else may still be holding the object, give our transform slot back now rather than when they let go
+				object->_DetachTransform();
+			}
+			queue.clear();
+		}
+	}
+
+	void Scene::_QueueForDeletion(const GameObject::Sptr& root) {
+		if (root == nullptr || root->_isQueuedForDeletion) {
+			return;
+		}
+
+		// Walk the hierarchy with our own stack, deep hierarchies shouldn't be able to blow the real one
+		std::vector<GameObject::Sptr> stack;
+		stack.push_back(root);
+		while (!stack.empty()) {
+			GameObject::Sptr object = std::move(stack.back());
+			stack.pop_back();
+			if (object == nullptr || object->_isQueuedForDeletion) {
+				continue;
 			}
+
+			object->_isQueuedForDeletion = true;
+			_deletionQueue.push_back(object);
+			for (const auto& child : object->_children) {
+				stack.push_back(child);
+			}
+		}
+	}
+
+	void Scene::_AddObject(const GameObject::Sptr& object) {
+		object->_sceneIndex = static_cast<uint32_t>(_objects.size());
+		_objects.push_back(object);
+		object->_creationOrder = _nextCreationOrder++;
+
+		_nameIndex[object->Name].push_back(object.get());
+		// GUIDs should be unique, if they aren't then the first object keeps the GUID lookup
+		if (!_guidIndex.emplace(object->_guid, object.get()).second) {
+			LOG_WARN("Duplicate game object GUID {} in scene (\"{}\")", object->_guid.str(), object->Name);
+		}
+
+		// Grab a slot in the object table
+		uint32_t slotIx;
+		if (!_freeObjectSlots.empty()) {
+			slotIx = _freeObjectSlots.back();
+			_freeObjectSlots.pop_back();
+		} else {
+			slotIx = static_cast<uint32_t>(_objectSlots.size());
+			_objectSlots.push_back(ObjectSlot());
+		}
+		_objectSlots[slotIx].Object = object.get();
+		object->_handle.Index = slotIx;
+		object->_handle.Generation = _objectSlots[slotIx].Generation;
+	}
+
+	void Scene::_UnindexObject(GameObject* object) {
+		if (!IsHandleValid(object->_handle) || _objectSlots[object->_handle.Index].Object != object) {
+			return;
+		}
+
+		_RemoveFromNameIndex(object, object->Name);
+		auto guidIt = _guidIndex.find(object->_guid);
+		if (guidIt != _guidIndex.end() && guidIt->second == object) {
+			_guidIndex.erase(guidIt);
+		}
+
+		// Retire the slot so that any cached handles go stale
+		ObjectSlot& slot = _objectSlots[object->_handle.Index];
+		slot.Object = nullptr;
+		slot.Generation++;
+		_freeObjectSlots.push_back(object->_handle.Index);
+		object->_handle = GameObjectHandle();
+	}
+
+	void Scene::_ClearObjects() {
+		for (const auto& object : _objects) {
+			object->_handle = GameObjectHandle();
+			object->_sceneIndex = GameObject::NO_SCENE_INDEX;
+			object->_isQueuedForDeletion = false;
 		}
+		_objects.clear();
 		_deletionQueue.clear();
+		_nameIndex.clear();
+		_guidIndex.clear();
+		// Bump the generations rather than dropping the table, so that old handles can't resolve
+		_freeObjectSlots.clear();
+		for (uint32_t ix = 0; ix < _objectSlots.size(); ix++) {
+			_objectSlots[ix].Object = nullptr;
+			_objectSlots[ix].Generation++;
+			_freeObjectSlots.push_back(ix);
+		}
+	}
+
+	void Scene::_OnObjectRenamed(GameObject* object, const std::string& oldName) {
+		// Objects that have been removed from the scene are not in the lookup
+		if (!IsHandleValid(object->_handle)) {
+			return;
+		}
+		_RemoveFromNameIndex(object, oldName);
+
+		// Keep the list in creation order, so FindObjectByName still returns the oldest match
+		std::vector<GameObject*>& list = _nameIndex[object->Name];
+		auto it = std::upper_bound(list.begin(), list.end(), object, [](GameObject* a, GameObject* b) {
+			return a->_creationOrder < b->_creationOrder;
+		});
+		list.insert(it, object);
+	}
+
+	void Scene::_RemoveFromNameIndex(GameObject* object, const std::string& name) {
+		auto it = _nameIndex.find(name);
+		if (it == _nameIndex.end()) {
+			return;
+		}
+		std::vector<GameObject*>& list = it->second;
+		auto entry = std::find(list.begin(), list.end(), object);
+		if (entry != list.end()) {
+			list.erase(entry);
+		}
+		if (list.empty()) {
+			_nameIndex.erase(it);
+		}
 	}
 
 	void Scene::DrawAllGameObjectGUIs()
@@ -1,9 +1,11 @@
 #pragma once
+#include <unordered_map>
 #include <btBulletDynamicsCommon.h>
 #include "BulletCollision/CollisionDispatch/btGhostObject.h"
 
 #include "Gameplay/Components/Camera.h"
 #include "Gameplay/GameObject.h"
+#include "Gameplay/SceneCommandBuffer.h"
 
 #include "Physics/BulletDebugDraw.h"
 
@@ -82,25 +84,52 @@ namespace Gameplay {
 		GameObject::Sptr CreateGameObject(const std::string& name);
 
 		/// <summary>
-		/// Queues a game object for deletion at the call of the next Update function
+		/// Queues a game object and all of its children for deletion at the call of the
+		/// next Update function. Queuing an object that is already queued does nothing
 		/// </summary>
 		/// <param name="object">The gameobject to delete</param>
 		void RemoveGameObject(const GameObject::Sptr& object);
+		/// <summary>
+		/// Queues a batch of game objects and all of their children for deletion at the call
+		/// of the next Update function. Removal costs are linear in the number of objects
+		/// removed, so this is the way to clear out things like projectiles in bulk
+		/// </summary>
+		/// <param name="objects">The gameobjects to delete</param>
+		void RemoveGameObjects(const std::vector<GameObject::Sptr>& objects);
+		/// <summary>
+		/// Queues every game object in the scene for deletion at the call of the next Update function
+		/// </summary>
+		void RemoveAllGameObjects();
 
 		/// <summary>
-		/// Searches all objects in the scene and returns the first
-		/// one who's name matches the one given, or nullptr if no object
-		/// is found
+		/// Returns the first object created in the scene who's name matches the
+		/// one given, or nullptr if no object is found
 		/// </summary>
 		/// <param name="name">The name of the object to find</param>
-		GameObject::Sptr FindObjectByName(const std::string name) const;
+		GameObject::Sptr FindObjectByName(const std::string& name) const;
 		/// <summary>
-		/// Searches all render objects in the scene and returns the first
-		/// one who's guid matches the one given, or nullptr if no object
-		/// is found
+		/// Gets all objects in the scene who's name matches the one given, in
+		/// the order they were created
+		/// </summary>
+		/// <param name="name">The name of the objects to find</param>
+		/// <param name="result">The list to append the objects to</param>
+		void FindObjectsByName(const std::string& name, std::vector<GameObject::Sptr>& result) const;
+		/// <summary>
+		/// Returns the object in the scene who's guid matches the one given, 
+		/// or nullptr if no object is found
 		/// </summary>
 		/// <param name="id">The guid of the object to find</param>
 		GameObject::Sptr FindObjectByGUID(Guid id) const;
+		/// <summary>
+		/// Resolves a handle from GameObject::GetHandle, returns nullptr if the
+		/// object has since been removed from the scene
+		/// </summary>
+		/// <param name="handle">The handle of the object to find</param>
+		GameObject::Sptr FindObjectByHandle(GameObjectHandle handle) const;
+		/// <summary>
+		/// Returns true if the handle still refers to an object in this scene
+		/// </summary>
+		bool IsHandleValid(GameObjectHandle handle) const;
 
 		/// <summary>
 		/// Sets the ambient light color for this scene
@@ -129,8 +158,9 @@ namespace Gameplay {
 		/// 
 		/// Only invokes events if IsPlaying is true
 		/// </summary>
-		/// <param name="dt">The time in seconds since the last frame</param>
-		void DoPhysics(float dt);
+		/// <param name="dt">The time in seconds since the last frame, or the length of the step when fixed stepping</param>
+		/// <param name="isFixedStep">True if dt is a fixed step, in which case the world is advanced by exactly dt</param>
+		void DoPhysics(float dt, bool isFixedStep = false);
 		/// <summary>
 		/// Renders debug information for the physics scene
 		/// </summary>
@@ -138,7 +168,8 @@ namespace Gameplay {
 
 		/// <summary>
 		/// Performs updates on all enabled components and gameobjects in the
-		/// scene
+		/// scene. Components with a thread safe Update are updated in parallel
+		/// after everything else, then any recorded commands are applied
 		/// 
 		/// Only invokes events if IsPlaying is true
 		/// </summary>
@@ -171,17 +202,64 @@ namespace Gameplay {
 		/// Converts this object into it's JSON representation for storage
 		/// </summary>
 		nlohmann::json ToJson() const;
+		/// <summary>
+		/// Loads a scene from a binary snapshot (see SceneBinary.h). The data is read in place, so it
+		/// can point straight into a memory mapped file
+		/// </summary>
+		/// <param name="data">The start of the snapshot</param>
+		/// <param name="size">The size of the snapshot in bytes</param>
+		/// <returns>The loaded scene, or nullptr if the data is not a valid snapshot of the current version</returns>
+		static Scene::Sptr FromBinary(const uint8_t* data, size_t size);
+		/// <summary>
+		/// Converts this scene into a binary snapshot (see SceneBinary.h)
+		/// </summary>
+		std::vector<uint8_t> ToBinary() const;
+		/// <summary>
+		/// Returns true if the data starts with a binary scene header, of any version
+		/// </summary>
+		static bool IsBinary(const uint8_t* data, size_t size);
 
 		ComponentManager& Components() { return _components; }
 		const ComponentManager& Components() const { return _components; }
 
+		/// <summary>
+		/// Gets the buffer for recording structural changes from code that can't make them
+		/// directly, such as parallel component updates
+		/// </summary>
+		SceneCommandBuffer& Commands() { return _commands; }
+
+		TransformSystem& Transforms() { return _transforms; }
+		const TransformSystem& Transforms() const { return _transforms; }
+
+		/// <summary>
+		/// Brings every object's world transform up to date in one pass, should be called
+		/// once per frame after Update and DoPhysics
+		/// </summary>
+		void UpdateTransforms();
+
+		/// <summary>
+		/// Moves dynamic rigid bodies to a blend between their poses from the last two physics steps,
+		/// so that motion looks smooth when rendering faster or slower than the physics tick rate.
+		/// The simulated poses are put back before the next Update or DoPhysics
+		/// </summary>
+		/// <param name="alpha">How far between the previous and current physics step to blend, see Timing::InterpolationAlpha</param>
+		void InterpolateTransforms(float alpha);
+
 		/// <summary>
 		/// Saves this scene to an output JSON file
 		/// </summary>
 		/// <param name="path">The path of the file to write to</param>
 		void Save(const std::string& path);
 		/// <summary>
-		/// Loads a scene from an input JSON file
+		/// Saves this scene to a binary snapshot file, which loads much faster than JSON
+		/// </summary>
+		/// <param name="path">The path of the file to write to</param>
+		void SaveBinary(const std::string& path);
+		/// <summary>
+		/// Loads a scene from an input JSON file or binary snapshot, the file is memory
+		/// mapped and the format is detected from its contents. When loading a JSON file,
+		/// an up to date snapshot next to it (same name, .bscene extension) is loaded
+		/// instead, and if there isn't one it is created
 		/// </summary>
 		/// <param name="path">The path of the file to read from</param>
 		/// <returns>A new scene loaded from the file</returns>
@@ -197,6 +275,10 @@ namespace Gameplay {
 
 		// The component manager will store all components for objects in this scene
 		ComponentManager _components;
+		// Stores the transforms for all objects in this scene
+		TransformSystem  _transforms;
+		// Structural changes recorded during the update, applied at the end of Update
+		SceneCommandBuffer _commands;
 
 		// Bullet physics stuff world
 		btDynamicsWorld*          _physicsWorld;
@@ -221,8 +303,24 @@ namespace Gameplay {
 
 		// Stores all the objects in our scene
 		std::vector<GameObject::Sptr>  _objects;
+		// Objects waiting to be removed, each object appears at most once
 		std::vector<std::weak_ptr<GameObject>>  _deletionQueue;
 
+		// Lookups so that finding objects doesn't need to walk _objects. Names are not unique, so
+		// each name maps to every object with that name, in creation order
+		std::unordered_map<std::string, std::vector<GameObject*>> _nameIndex;
+		std::unordered_map<Guid, GameObject*> _guidIndex;
+
+		// The object table that GameObjectHandles index into
+		struct ObjectSlot {
+			GameObject* Object = nullptr;
+			uint32_t Generation = 0;
+		};
+		std::vector<ObjectSlot> _objectSlots;
+		std::vector<uint32_t>   _freeObjectSlots;
+		// Stamped onto objects as they are added, so the name lookup can stay in creation order
+		uint64_t                _nextCreationOrder = 0;
+
 		// Info for rendering our skybox will be stored in the scene itself
 		std::shared_ptr<ShaderProgram>       _skyboxShader;
 		std::shared_ptr<MeshResource> _skyboxMesh;
@@ -235,6 +333,10 @@ namespace Gameplay {
 		Texture3D::Sptr               _colorCorrection;
 
 		bool                       _isAwake;
+		// True while dynamic bodies are showing their interpolated pose rather than their simulated one
+		bool                       _isInterpolated;
+		// The number of physics steps since frame forces were last cleared, forces are only cleared once a step has used them
+		int                        _physicsStepsSinceForceClear;
 
 		/// <summary>
 		/// Handles configuring our bullet physics stuff
@@ -245,6 +347,52 @@ namespace Gameplay {
 		/// </summary>
 		void _CleanupPhysics();
 
+		/// <summary>
+		/// Removes every object in the deletion queue, swapping the last object into each hole
+		/// </summary>
 		void _FlushDeleteQueue();
+		/// <summary>
+		/// Memory maps a scene file and loads it as JSON or binary depending on its contents
+		/// </summary>
+		static Scene::Sptr _LoadFile(const std::string& path);
+		/// <summary>
+		/// Loads the scene wide settings (skybox, ambient light, etc...) shared by the JSON and binary formats
+		/// </summary>
+		void _LoadSettingsJson(const nlohmann::json& data);
+		/// <summary>
+		/// Saves the scene wide settings shared by the JSON and binary formats
+		/// </summary>
+		nlohmann::json _SettingsToJson() const;
+		/// <summary>
+		/// Rebuilds the object hierarchy and resolves the main camera once all objects have been loaded
+		/// </summary>
+		void _FinishLoad(const nlohmann::json& settings);
+		/// <summary>
+		/// Adds an object and everything under it to the deletion queue, skipping anything already queued
+		/// </summary>
+		void _QueueForDeletion(const GameObject::Sptr& root);
+		/// <summary>
+		/// Undoes InterpolateTransforms, so that gameplay and physics see the simulated poses
+		/// </summary>
+		void _RestoreSimulatedTransforms();
+
+		/// <summary>
+		/// Adds an object to _objects, the lookups and the object table
+		/// </summary>
+		void _AddObject(const GameObject::Sptr& object);
+		/// <summary>
+		/// Removes an object from the lookups and retires its handle, does not touch _objects
+		/// </summary>
+		void _UnindexObject(GameObject* object);
+		/// <summary>
+		/// Removes all objects from the scene along with the lookups
+		/// </summary>
+		void _ClearObjects();
+		/// <summary>
+		/// Invoked by GameObject::SetName to move the object in the name lookup
+		/// </summary>
+		void _OnObjectRenamed(GameObject* object, const std::string& oldName);
+		// Removes an object from the name lookup under the given name
+		void _RemoveFromNameIndex(GameObject* object, const std::string& name);
 	};
 }
\ No newline at end of file
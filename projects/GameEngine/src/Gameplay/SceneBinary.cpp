@@ -0,0 +1,257 @@
+#include "Gameplay/Scene.h"
+#include "Gameplay/SceneBinary.h"
+
+#include <cstring>
+#include <fstream>
+
+#include "Logging.h"
+
+namespace Gameplay {
+	namespace {
+		// Appends raw bytes to the output buffer, and returns where they were written
+		uint32_t AppendBytes(std::vector<uint8_t>& buffer, const void* data, size_t size) {
+			uint32_t offset = static_cast<uint32_t>(buffer.size());
+			buffer.insert(buffer.end(), static_cast<const uint8_t*>(data), static_cast<const uint8_t*>(data) + size);
+			return offset;
+		}
+
+		// Pads the output buffer so the next section starts on an aligned boundary
+		void AlignBuffer(std::vector<uint8_t>& buffer) {
+			size_t remainder = buffer.size() % SCENE_BINARY_ALIGNMENT;
+			if (remainder != 0) {
+				buffer.resize(buffer.size() + SCENE_BINARY_ALIGNMENT - remainder, 0);
+			}
+		}
+
+		template <typename T>
+		SceneBinarySection AppendSection(std::vector<uint8_t>& buffer, const std::vector<T>& values) {
+			AlignBuffer(buffer);
+			SceneBinarySection result;
+			result.Size = static_cast<uint32_t>(values.size() * sizeof(T));
+			result.Offset = values.empty() ? static_cast<uint32_t>(buffer.size()) : AppendBytes(buffer, values.data(), result.Size);
+			return result;
+		}
+
+		// Builds the string table, storing each unique string once
+		class StringTableBuilder {
+		public:
+			SceneBinaryString Add(const std::string& value) {
+				auto it = _lookup.find(value);
+				if (it != _lookup.end()) {
+					return it->second;
+				}
+				SceneBinaryString result;
+				result.Offset = static_cast<uint32_t>(Data.size());
+				result.Length = static_cast<uint32_t>(value.size());
+				Data.insert(Data.end(), value.begin(), value.end());
+				_lookup[value] = result;
+				return result;
+			}
+
+			std::vector<char> Data;
+
+		private:
+			std::unordered_map<std::string, SceneBinaryString> _lookup;
+		};
+
+		bool IsSectionValid(const SceneBinarySection& section, size_t fileSize) {
+			return static_cast<size_t>(section.Offset) + section.Size <= fileSize;
+		}
+
+		bool IsRangeValid(uint32_t offset, uint32_t size, uint32_t sectionSize) {
+			return static_cast<size_t>(offset) + size <= sectionSize;
+		}
+	}
+
+	bool Scene::IsBinary(const uint8_t* data, size_t size) {
+		if (data == nullptr || size < sizeof(SceneBinaryHeader)) {
+			return false;
+		}
+		const SceneBinaryHeader& header = *reinterpret_cast<const SceneBinaryHeader*>(data);
+		const SceneBinaryHeader reference;
+		return memcmp(header.HeaderBytes, reference.HeaderBytes, sizeof(reference.HeaderBytes)) == 0;
+	}
+
+	Scene::Sptr Scene::FromBinary(const uint8_t* data, size_t size)
+	{
+		if (!IsBinary(data, size)) {
+			LOG_ERROR("Data is not a binary scene");
+			return nullptr;
+		}
+
+		const SceneBinaryHeader& header = *reinterpret_cast<const SceneBinaryHeader*>(data);
+		if (header.Version != SCENE_BINARY_VERSION) {
+			LOG_WARN("Binary scene is version {}, expected version {}", header.Version, SCENE_BINARY_VERSION);
+			return nullptr;
+		}
+		if (!IsSectionValid(header.Settings, size) || !IsSectionValid(header.Objects, size) ||
+			!IsSectionValid(header.Transforms, size) || !IsSectionValid(header.Components, size) ||
+			!IsSectionValid(header.Blobs, size) || !IsSectionValid(header.Strings, size) ||
+			header.Objects.Size != header.NumObjects * sizeof(SceneBinaryObject) ||
+			header.Transforms.Size != header.NumObjects * sizeof(SceneBinaryTransform) ||
+			header.Components.Size != header.NumComponents * sizeof(SceneBinaryComponent)) {
+			LOG_ERROR("Binary scene is truncated or corrupt");
+			return nullptr;
+		}
+
+		// Records are read in place, the sections are aligned when the file is written
+		const SceneBinaryObject*    objects    = reinterpret_cast<const SceneBinaryObject*>(data + header.Objects.Offset);
+		const SceneBinaryTransform* transforms = reinterpret_cast<const SceneBinaryTransform*>(data + header.Transforms.Offset);
+		const SceneBinaryComponent* components = reinterpret_cast<const SceneBinaryComponent*>(data + header.Components.Offset);
+		const uint8_t*              blobs      = data + header.Blobs.Offset;
+		const char*                 strings    = reinterpret_cast<const char*>(data + header.Strings.Offset);
+
+		// Check every record before we start building anything, so a bad file gets discarded rather than half loaded
+		for (uint32_t ix = 0; ix < header.NumObjects; ix++) {
+			const SceneBinaryObject& record = objects[ix];
+			if (!IsRangeValid(record.Name.Offset, record.Name.Length, header.Strings.Size) ||
+				static_cast<size_t>(record.FirstComponent) + record.NumComponents > header.NumComponents) {
+				LOG_ERROR("Binary scene object {} is out of range, the file is corrupt", ix);
+				return nullptr;
+			}
+		}
+		for (uint32_t ix = 0; ix < header.NumComponents; ix++) {
+			const SceneBinaryComponent& component = components[ix];
+			if (!IsRangeValid(component.TypeName.Offset, component.TypeName.Length, header.Strings.Size) ||
+				!IsRangeValid(component.BlobOffset, component.BlobSize, header.Blobs.Size)) {
+				LOG_ERROR("Binary scene component {} is out of range, the file is corrupt", ix);
+				return nullptr;
+			}
+		}
+
+		auto getString = [&](const SceneBinaryString& value) {
+			return std::string(strings + value.Offset, value.Length);
+		};
+
+		Scene::Sptr result = std::make_shared<Scene>();
+		try {
+			nlohmann::json settings = nlohmann::json::from_msgpack(data + header.Settings.Offset, data + header.Settings.Offset + header.Settings.Size);
+
+			result->MainCamera = nullptr;
+			result->_ClearObjects();
+			result->_LoadSettingsJson(settings);
+			result->_objects.reserve(header.NumObjects);
+
+			for (uint32_t ix = 0; ix < header.NumObjects; ix++) {
+				const SceneBinaryObject& record = objects[ix];
+				const SceneBinaryTransform& transform = transforms[ix];
+
+				// Scene is a friend of GameObject, so we can construct it directly like FromJson does
+				GameObject::Sptr obj(new GameObject());
+				obj->_SetScene(result.get());
+
+				uint8_t guidBytes[16];
+				memcpy(guidBytes, record.Guid, sizeof(guidBytes));
+				obj->_guid = Guid::FromBytes(guidBytes);
+				memcpy(guidBytes, record.ParentGuid, sizeof(guidBytes));
+				obj->_parent = GameObject::WeakRef(Guid::FromBytes(guidBytes), result.get());
+
+				obj->Name = getString(record.Name);
+				obj->HideInHierarchy = (record.Flags & SCENE_BINARY_OBJECT_HIDDEN) != 0;
+				obj->SetPosition(glm::vec3(transform.Position[0], transform.Position[1], transform.Position[2]));
+				obj->SetRotation(glm::quat(transform.Rotation[0], transform.Rotation[1], transform.Rotation[2], transform.Rotation[3]));
+				obj->SetScale(glm::vec3(transform.Scale[0], transform.Scale[1], transform.Scale[2]));
+
+				for (uint32_t componentIx = 0; componentIx < record.NumComponents; componentIx++) {
+					const SceneBinaryComponent& component = components[record.FirstComponent + componentIx];
+
+					// Decoded straight from the file's bytes, no text parsing or intermediate copies
+					const uint8_t* blob = blobs + component.BlobOffset;
+					obj->_LoadComponent(getString(component.TypeName), nlohmann::json::from_msgpack(blob, blob + component.BlobSize));
+				}
+
+				obj->_selfRef = obj;
+				result->_AddObject(obj);
+			}
+
+			result->_FinishLoad(settings);
+		} catch (const std::exception& e) {
+			// The caller re-builds the snapshot from the JSON scene when we fail
+			LOG_ERROR("Failed to decode binary scene: {}", e.what());
+			return nullptr;
+		}
+
+		return result;
+	}
+
+	std::vector<uint8_t> Scene::ToBinary() const
+	{
+		StringTableBuilder strings;
+		std::vector<SceneBinaryObject>    objects;
+		std::vector<SceneBinaryTransform> transforms;
+		std::vector<SceneBinaryComponent> components;
+		std::vector<uint8_t>              blobs;
+		objects.reserve(_objects.size());
+		transforms.reserve(_objects.size());
+
+		for (const auto& object : _objects) {
+			SceneBinaryObject record;
+			memcpy(record.Guid, object->_guid.bytes(), sizeof(record.Guid));
+			GameObject::Sptr parent = object->_parent;
+			if (parent != nullptr) {
+				memcpy(record.ParentGuid, parent->_guid.bytes(), sizeof(record.ParentGuid));
+			} else {
+				memset(record.ParentGuid, 0, sizeof(record.ParentGuid));
+			}
+			record.Name = strings.Add(object->Name);
+			record.Flags = object->HideInHierarchy ? SCENE_BINARY_OBJECT_HIDDEN : 0;
+			record.FirstComponent = static_cast<uint32_t>(components.size());
+			record.NumComponents = static_cast<uint32_t>(object->_components.size());
+
+			for (const auto& component : object->_components) {
+				nlohmann::json blob = component->ToJson();
+				IComponent::SaveBaseJson(component, blob);
+
+				SceneBinaryComponent componentRecord;
+				componentRecord.TypeName = strings.Add(component->ComponentTypeName());
+				componentRecord.BlobOffset = static_cast<uint32_t>(blobs.size());
+				nlohmann::json::to_msgpack(blob, blobs);
+				componentRecord.BlobSize = static_cast<uint32_t>(blobs.size()) - componentRecord.BlobOffset;
+				components.push_back(componentRecord);
+			}
+			objects.push_back(record);
+
+			const glm::vec3& position = object->GetPosition();
+			const glm::quat& rotation = object->GetRotation();
+			const glm::vec3& scale = object->GetScale();
+			transforms.push_back(SceneBinaryTransform{
+				{ position.x, position.y, position.z },
+				{ rotation.w, rotation.x, rotation.y, rotation.z },
+				{ scale.x, scale.y, scale.z }
+			});
+		}
+
+		std::vector<uint8_t> settings;
+		nlohmann::json::to_msgpack(_SettingsToJson(), settings);
+
+		// Leave room for the header, we fill it in once we know where everything ended up
+		SceneBinaryHeader header;
+		header.NumObjects = static_cast<uint32_t>(objects.size());
+		header.NumComponents = static_cast<uint32_t>(components.size());
+
+		std::vector<uint8_t> result(sizeof(SceneBinaryHeader), 0);
+		header.Settings   = AppendSection(result, settings);
+		header.Objects    = AppendSection(result, objects);
+		header.Transforms = AppendSection(result, transforms);
+		header.Components = AppendSection(result, components);
+		header.Blobs      = AppendSection(result, blobs);
+		header.Strings    = AppendSection(result, strings.Data);
+		memcpy(result.data(), &header, sizeof(SceneBinaryHeader));
+
+		return result;
+	}
+
+	void Scene::SaveBinary(const std::string& path) {
+		// Make sure we save where the bodies actually are, not where they were drawn
+		_RestoreSimulatedTransforms();
+
+		std::vector<uint8_t> data = ToBinary();
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		if (!file) {
+			LOG_ERROR("Could not open \"{}\" for writing", path);
+			return;
+		}
+		file.write(reinterpret_cast<const char*>(data.data()), data.size());
+		LOG_INFO("Saved binary scene to \"{}\" ({} bytes)", path, data.size());
+	}
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include <cstdint>
+
+namespace Gameplay {
+	/*
+	 * Layout of a binary scene snapshot, as written by Scene::SaveBinary. JSON is still the format
+	 * that the editor saves and that gets checked in, the binary file is a cache that loads without
+	 * any text parsing
+	 *
+	 * The file is a header followed by sections, each starting on a SCENE_BINARY_ALIGNMENT boundary
+	 * so that the records can be read in place from a memory mapped file:
+	 *   Settings   - MessagePack blob with the scene wide settings (skybox, ambient, camera, etc...)
+	 *   Objects    - NumObjects SceneBinaryObject records
+	 *   Transforms - NumObjects SceneBinaryTransform records, parallel to Objects
+	 *   Components - NumComponents SceneBinaryComponent records, each object owns a contiguous range
+	 *   Blobs      - MessagePack encoded component data, referenced by the component records
+	 *   Strings    - Raw characters for every string in the file, referenced by SceneBinaryString
+	 */
+
+	static constexpr uint16_t SCENE_BINARY_VERSION = 1;
+	static constexpr const char* SCENE_BINARY_EXTENSION = ".bscene";
+	static constexpr uint32_t SCENE_BINARY_ALIGNMENT = 16;
+
+	// A range of bytes within the file
+	struct SceneBinarySection {
+		uint32_t Offset = 0;
+		uint32_t Size   = 0;
+	};
+
+	// A string stored in the string table, not null terminated
+	struct SceneBinaryString {
+		uint32_t Offset = 0;
+		uint32_t Length = 0;
+	};
+
+	struct SceneBinaryHeader {
+		// A check value so we can ensure that we're loading in the right file type
+		char     HeaderBytes[4] ={ 'B', 'S', 'C', 'N' };
+		// The version code, files with a different version are rejected and re-baked from JSON
+		uint16_t Version = SCENE_BINARY_VERSION;
+		uint16_t Reserved = 0;
+		uint32_t NumObjects = 0;
+		uint32_t NumComponents = 0;
+
+		SceneBinarySection Settings;
+		SceneBinarySection Objects;
+		SceneBinarySection Transforms;
+		SceneBinarySection Components;
+		SceneBinarySection Blobs;
+		SceneBinarySection Strings;
+	};
+
+	// Bits for SceneBinaryObject::Flags
+	static constexpr uint32_t SCENE_BINARY_OBJECT_HIDDEN = 1 << 0;
+
+	struct SceneBinaryObject {
+		uint8_t           Guid[16];
+		// All zeros if the object has no parent
+		uint8_t           ParentGuid[16];
+		SceneBinaryString Name;
+		// The range of component records that belong to this object
+		uint32_t          FirstComponent = 0;
+		uint32_t          NumComponents = 0;
+		uint32_t          Flags = 0;
+		uint32_t          Padding = 0;
+	};
+
+	struct SceneBinaryTransform {
+		float Position[3];
+		// Stored as W, X, Y, Z so the file doesn't depend on GLM's quaternion layout
+		float Rotation[4];
+		float Scale[3];
+	};
+
+	struct SceneBinaryComponent {
+		SceneBinaryString TypeName;
+		// Offset of the component's blob, relative to the start of the blobs section
+		uint32_t          BlobOffset = 0;
+		uint32_t          BlobSize = 0;
+	};
+
+	// These get read straight out of the file, so their layout can't change without bumping the version
+	static_assert(sizeof(SceneBinaryHeader) == 64, "Scene binary header layout changed");
+	static_assert(sizeof(SceneBinaryObject) == 56, "Scene binary object layout changed");
+	static_assert(sizeof(SceneBinaryTransform) == 40, "Scene binary transform layout changed");
+	static_assert(sizeof(SceneBinaryComponent) == 16, "Scene binary component layout changed");
+}
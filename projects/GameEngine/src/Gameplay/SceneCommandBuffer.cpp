@@ -0,0 +1,46 @@
+#include "Gameplay/SceneCommandBuffer.h"
+#include "Gameplay/Scene.h"
+
+namespace Gameplay {
+	void SceneCommandBuffer::Push(Command&& command) {
+		std::lock_guard<std::mutex> lock(_mutex);
+		_commands.push_back(std::move(command));
+	}
+
+	void SceneCommandBuffer::CreateGameObject(const std::string& name, std::function<void(const GameObject::Sptr&)> onCreated) {
+		Push([name, onCreated](Scene& scene) {
+			GameObject::Sptr object = scene.CreateGameObject(name);
+			if (onCreated) {
+				onCreated(object);
+			}
+		});
+	}
+
+	void SceneCommandBuffer::RemoveGameObject(const GameObject::Sptr& object) {
+		std::weak_ptr<GameObject> target = object;
+		Push([target](Scene& scene) {
+			GameObject::Sptr object = target.lock();
+			if (object != nullptr) {
+				scene.RemoveGameObject(object);
+			}
+		});
+	}
+
+	void SceneCommandBuffer::Flush(Scene& scene) {
+		std::vector<Command> commands;
+		while (true) {
+			// Swap the list out, so that commands can record more commands without deadlocking
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				if (_commands.empty()) {
+					break;
+				}
+				commands.swap(_commands);
+			}
+			for (Command& command : commands) {
+				command(scene);
+			}
+			commands.clear();
+		}
+	}
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "Gameplay/GameObject.h"
+
+namespace Gameplay {
+	class Scene;
+
+	/// <summary>
+	/// Records changes to the structure of a scene (creating and removing objects, adding
+	/// components) from code that isn't allowed to touch the scene directly, like components
+	/// with a thread safe Update. The scene applies the commands in the order they were
+	/// recorded once the update phase has finished
+	///
+	/// Recording commands is thread safe
+	/// </summary>
+	class SceneCommandBuffer {
+	public:
+		typedef std::function<void(Scene& scene)> Command;
+
+		SceneCommandBuffer() = default;
+		~SceneCommandBuffer() = default;
+
+		SceneCommandBuffer(const SceneCommandBuffer& other) = delete;
+		SceneCommandBuffer& operator=(const SceneCommandBuffer& other) = delete;
+
+		/// <summary>
+		/// Records an arbitrary command to run on the main thread
+		/// </summary>
+		void Push(Command&& command);
+
+		/// <summary>
+		/// Records the creation of a new game object
+		/// </summary>
+		/// <param name="name">The name of the object to create</param>
+		/// <param name="onCreated">Optional callback invoked with the new object once it has been created</param>
+		void CreateGameObject(const std::string& name, std::function<void(const GameObject::Sptr&)> onCreated = nullptr);
+		/// <summary>
+		/// Records the removal of a game object from the scene
+		/// </summary>
+		void RemoveGameObject(const GameObject::Sptr& object);
+		/// <summary>
+		/// Records adding a component to a game object. If the object has already been removed by the
+		/// time the command runs, nothing happens, and if it already has a component of that type the
+		/// existing one is passed to the callback
+		/// </summary>
+		/// <typeparam name="T">The type of component to add</typeparam>
+		/// <param name="object">The object to add the component to</param>
+		/// <param name="onAdded">Optional callback invoked with the component once it has been added</param>
+		template <typename T>
+		void AddComponent(const GameObject::Sptr& object, std::function<void(const std::shared_ptr<T>&)> onAdded = nullptr) {
+			std::weak_ptr<GameObject> target = object;
+			Push([target, onAdded](Scene&) {
+				GameObject::Sptr object = target.lock();
+				if (object == nullptr) {
+					return;
+				}
+				std::shared_ptr<T> component = object->Has<T>() ? object->Get<T>() : object->Add<T>();
+				if (onAdded) {
+					onAdded(component);
+				}
+			});
+		}
+
+		/// <summary>
+		/// Runs and clears all recorded commands, should only be called from the main thread.
+		/// Commands recorded while flushing are run as well
+		/// </summary>
+		void Flush(Scene& scene);
+
+	private:
+		std::mutex           _mutex;
+		std::vector<Command> _commands;
+	};
+}
@@ -0,0 +1,323 @@
+#include "TransformSystem.h"
+#include <algorithm>
+
+#include "GLM/gtc/matrix_inverse.hpp"
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#include <xmmintrin.h>
+#define TRANSFORM_SYSTEM_SSE 1
+#else
+#define TRANSFORM_SYSTEM_SSE 0
+#endif
+
+namespace Gameplay {
+	// Calculates result = a * b, the matrices are column major so each column of the result is
+	// a linear combination of a's columns, which maps directly onto 4-wide SSE registers
+	inline void MultiplyMatrices(const glm::mat4& a, const glm::mat4& b, glm::mat4& result) {
+		#if TRANSFORM_SYSTEM_SSE
+		const float* pa = &a[0][0];
+		const float* pb = &b[0][0];
+		float* pr = &result[0][0];
+		__m128 a0 = _mm_loadu_ps(pa);
+		__m128 a1 = _mm_loadu_ps(pa + 4);
+		__m128 a2 = _mm_loadu_ps(pa + 8);
+		__m128 a3 = _mm_loadu_ps(pa + 12);
+		for (int col = 0; col < 4; col++) {
+			const float* bc = pb + col * 4;
+			__m128 r = _mm_mul_ps(a0, _mm_set1_ps(bc[0]));
+			r = _mm_add_ps(r, _mm_mul_ps(a1, _mm_set1_ps(bc[1])));
+			r = _mm_add_ps(r, _mm_mul_ps(a2, _mm_set1_ps(bc[2])));
+			r = _mm_add_ps(r, _mm_mul_ps(a3, _mm_set1_ps(bc[3])));
+			_mm_storeu_ps(pr + col * 4, r);
+		}
+		#else
+		result = a * b;
+		#endif
+	}
+
+	TransformSystem::TransformSystem() :
+		_isOrderDirty(false),
+		_isAnyDirty(false)
+	{ }
+
+	TransformSystem::Slot TransformSystem::Allocate() {
+		Slot slot;
+		if (!_freeSlots.empty()) {
+			slot = _freeSlots.back();
+			_freeSlots.pop_back();
+		} else {
+			slot = static_cast<Slot>(_slotToDense.size());
+			_slotToDense.push_back(INVALID_INDEX);
+		}
+
+		// New transforms are roots, so appending them keeps parents ahead of children
+		uint32_t index = static_cast<uint32_t>(_positions.size());
+		_positions.push_back(glm::vec3(0.0f));
+		_rotations.push_back(glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+		_scales.push_back(glm::vec3(1.0f));
+		_local.push_back(glm::mat4(1.0f));
+		_world.push_back(glm::mat4(1.0f));
+		_inverseLocal.push_back(glm::mat4(1.0f));
+		_inverseWorld.push_back(glm::mat4(1.0f));
+		_parents.push_back(INVALID_INDEX);
+		_versions.push_back(0);
+		_parentVersions.push_back(0);
+		_flags.push_back(InverseLocalValid | InverseWorldValid);
+		_indexToSlot.push_back(slot);
+
+		_slotToDense[slot] = index;
+		return slot;
+	}
+
+	void TransformSystem::Free(Slot slot) {
+		if (slot >= _slotToDense.size() || _slotToDense[slot] == INVALID_INDEX) {
+			return;
+		}
+
+		// The entry stays in the arrays until the next sort, so that indices don't move mid-frame
+		_indexToSlot[_slotToDense[slot]] = INVALID_SLOT;
+		_slotToDense[slot] = INVALID_INDEX;
+		_pendingFreeSlots.push_back(slot);
+		_isOrderDirty = true;
+	}
+
+	void TransformSystem::Clear() {
+		_positions.clear();
+		_rotations.clear();
+		_scales.clear();
+		_local.clear();
+		_world.clear();
+		_inverseLocal.clear();
+		_inverseWorld.clear();
+		_parents.clear();
+		_versions.clear();
+		_parentVersions.clear();
+		_flags.clear();
+		_indexToSlot.clear();
+		_slotToDense.clear();
+		_freeSlots.clear();
+		_pendingFreeSlots.clear();
+		_isOrderDirty = false;
+		_isAnyDirty = false;
+	}
+
+	void TransformSystem::SetParent(Slot slot, Slot parent) {
+		uint32_t index = _slotToDense[slot];
+		_parents[index] = parent == INVALID_SLOT ? INVALID_INDEX : _slotToDense[parent];
+		// Force the world transform to be re-calculated against the new parent
+		_MarkDirty(index);
+		_isOrderDirty = true;
+	}
+
+	void TransformSystem::SetPosition(Slot slot, const glm::vec3& value) {
+		uint32_t index = _slotToDense[slot];
+		_positions[index] = value;
+		_MarkDirty(index);
+	}
+
+	void TransformSystem::SetRotation(Slot slot, const glm::quat& value) {
+		uint32_t index = _slotToDense[slot];
+		_rotations[index] = value;
+		_MarkDirty(index);
+	}
+
+	void TransformSystem::SetScale(Slot slot, const glm::vec3& value) {
+		uint32_t index = _slotToDense[slot];
+		_scales[index] = value;
+		_MarkDirty(index);
+	}
+
+	const glm::mat4& TransformSystem::GetLocalTransform(Slot slot) {
+		uint32_t index = _slotToDense[slot];
+		if (_flags[index] & LocalDirty) {
+			// Bring the world transform along too, since we're clearing the dirty flag
+			_UpdateWorld(index);
+		}
+		return _local[index];
+	}
+
+	const glm::mat4& TransformSystem::GetInverseLocalTransform(Slot slot) {
+		uint32_t index = _slotToDense[slot];
+		if (_flags[index] & LocalDirty) {
+			_UpdateWorld(index);
+		}
+		if (!(_flags[index] & InverseLocalValid)) {
+			_inverseLocal[index] = glm::affineInverse(_local[index]);
+			_flags[index] |= InverseLocalValid;
+		}
+		return _inverseLocal[index];
+	}
+
+	const glm::mat4& TransformSystem::GetWorldTransform(Slot slot) {
+		uint32_t index = _slotToDense[slot];
+		if (_isAnyDirty) {
+			_UpdateWorld(index);
+		}
+		return _world[index];
+	}
+
+	const glm::mat4& TransformSystem::GetInverseWorldTransform(Slot slot) {
+		uint32_t index = _slotToDense[slot];
+		if (_isAnyDirty) {
+			_UpdateWorld(index);
+		}
+		if (!(_flags[index] & InverseWorldValid)) {
+			_inverseWorld[index] = glm::affineInverse(_world[index]);
+			_flags[index] |= InverseWorldValid;
+		}
+		return _inverseWorld[index];
+	}
+
+	void TransformSystem::Propagate() {
+		if (_isOrderDirty) {
+			_Sort();
+		}
+		if (!_isAnyDirty) {
+			return;
+		}
+
+		// Parents come before children, so by the time we reach an entry its parent is up to date
+		const uint32_t count = static_cast<uint32_t>(_positions.size());
+		for (uint32_t ix = 0; ix < count; ix++) {
+			const uint32_t parent = _parents[ix];
+			const bool localDirty = (_flags[ix] & LocalDirty) != 0;
+			if (localDirty) {
+				_RecalcLocal(ix);
+			}
+
+			if (parent != INVALID_INDEX) {
+				if (localDirty || _parentVersions[ix] != _versions[parent]) {
+					MultiplyMatrices(_world[parent], _local[ix], _world[ix]);
+					_parentVersions[ix] = _versions[parent];
+					_versions[ix]++;
+					_flags[ix] &= ~InverseWorldValid;
+				}
+			} else if (localDirty) {
+				_world[ix] = _local[ix];
+				_versions[ix]++;
+				_flags[ix] &= ~InverseWorldValid;
+			}
+		}
+		_isAnyDirty = false;
+	}
+
+	void TransformSystem::_MarkDirty(uint32_t index) {
+		_flags[index] |= LocalDirty;
+		_isAnyDirty.store(true, std::memory_order_relaxed);
+	}
+
+	void TransformSystem::_RecalcLocal(uint32_t index) {
+		// Equivalent to translate * rotate * scale, without the full matrix multiplies
+		glm::mat3 rot = glm::mat3_cast(_rotations[index]);
+		const glm::vec3& scale = _scales[index];
+		glm::mat4& local = _local[index];
+		local[0] = glm::vec4(rot[0] * scale.x, 0.0f);
+		local[1] = glm::vec4(rot[1] * scale.y, 0.0f);
+		local[2] = glm::vec4(rot[2] * scale.z, 0.0f);
+		local[3] = glm::vec4(_positions[index], 1.0f);
+		_flags[index] &= ~(LocalDirty | InverseLocalValid);
+	}
+
+	void TransformSystem::_UpdateWorld(uint32_t index) {
+		const uint32_t parent = _parents[index];
+		if (parent != INVALID_INDEX) {
+			_UpdateWorld(parent);
+		}
+
+		const bool localDirty = (_flags[index] & LocalDirty) != 0;
+		if (localDirty) {
+			_RecalcLocal(index);
+		}
+
+		if (parent != INVALID_INDEX) {
+			if (localDirty || _parentVersions[index] != _versions[parent]) {
+				MultiplyMatrices(_world[parent], _local[index], _world[index]);
+				_parentVersions[index] = _versions[parent];
+				_versions[index]++;
+				_flags[index] &= ~InverseWorldValid;
+			}
+		} else if (localDirty) {
+			_world[index] = _local[index];
+			_versions[index]++;
+			_flags[index] &= ~InverseWorldValid;
+		}
+	}
+
+	void TransformSystem::_Sort() {
+		const uint32_t count = static_cast<uint32_t>(_positions.size());
+
+		// Anything parented to a freed transform becomes a root
+		for (uint32_t ix = 0; ix < count; ix++) {
+			if (_parents[ix] != INVALID_INDEX && _indexToSlot[_parents[ix]] == INVALID_SLOT) {
+				_parents[ix] = INVALID_INDEX;
+				_MarkDirty(ix);
+			}
+		}
+
+		// Work out the depth of every live entry, walking up until we hit something we already know
+		std::vector<uint32_t> depths(count, INVALID_INDEX);
+		std::vector<uint32_t> chain;
+		for (uint32_t ix = 0; ix < count; ix++) {
+			uint32_t current = ix;
+			while (current != INVALID_INDEX && depths[current] == INVALID_INDEX) {
+				chain.push_back(current);
+				current = _parents[current];
+			}
+			uint32_t depth = current == INVALID_INDEX ? 0 : depths[current] + 1;
+			for (auto it = chain.rbegin(); it != chain.rend(); it++) {
+				depths[*it] = depth++;
+			}
+			chain.clear();
+		}
+
+		std::vector<uint32_t> order;
+		order.reserve(count);
+		for (uint32_t ix = 0; ix < count; ix++) {
+			if (_indexToSlot[ix] != INVALID_SLOT) {
+				order.push_back(ix);
+			}
+		}
+		// Stable so that siblings keep their relative order, which keeps the arrays from churning
+		std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+			return depths[a] < depths[b];
+		});
+
+		std::vector<uint32_t> oldToNew(count, INVALID_INDEX);
+		for (uint32_t ix = 0; ix < order.size(); ix++) {
+			oldToNew[order[ix]] = ix;
+		}
+
+		auto permute = [&](auto& values) {
+			std::remove_reference_t<decltype(values)> result;
+			result.reserve(order.size());
+			for (uint32_t oldIx : order) {
+				result.push_back(values[oldIx]);
+			}
+			values.swap(result);
+		};
+		permute(_positions);
+		permute(_rotations);
+		permute(_scales);
+		permute(_local);
+		permute(_world);
+		permute(_inverseLocal);
+		permute(_inverseWorld);
+		permute(_parents);
+		permute(_versions);
+		permute(_parentVersions);
+		permute(_flags);
+		permute(_indexToSlot);
+
+		for (uint32_t ix = 0; ix < _parents.size(); ix++) {
+			if (_parents[ix] != INVALID_INDEX) {
+				_parents[ix] = oldToNew[_parents[ix]];
+			}
+			_slotToDense[_indexToSlot[ix]] = ix;
+		}
+
+		// Nothing refers to the freed slots any more, so they can be handed out again
+		_freeSlots.insert(_freeSlots.end(), _pendingFreeSlots.begin(), _pendingFreeSlots.end());
+		_pendingFreeSlots.clear();
+		_isOrderDirty = false;
+	}
+}
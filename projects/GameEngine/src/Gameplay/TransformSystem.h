@@ -0,0 +1,151 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "GLM/glm.hpp"
+#include "GLM/gtc/quaternion.hpp"
+
+namespace Gameplay {
+	/// <summary>
+	/// Stores the transforms of every game object in a scene in flat arrays, sorted so that
+	/// parents always come before their children. Propagate walks the arrays once per frame
+	/// and updates every world transform that has changed, so readers never have to chase
+	/// parent pointers
+	///
+	/// Transforms that are read before the next Propagate are updated on demand by walking
+	/// up the parent indices, and inverses are only calculated when they are requested
+	///
+	/// References returned by the getters are invalidated when a transform is allocated or
+	/// when Propagate re-sorts the arrays, don't hold on to them across frames
+	///
+	/// Setting the position, rotation or scale of different transforms from different threads
+	/// is safe, anything else should only be done from the main thread
+	/// </summary>
+	class TransformSystem {
+	public:
+		/// <summary>
+		/// A stable ID for a transform in the system, which does not change when the
+		/// arrays are re-sorted
+		/// </summary>
+		typedef uint32_t Slot;
+		static constexpr Slot INVALID_SLOT = UINT32_MAX;
+
+		TransformSystem();
+		~TransformSystem() = default;
+
+		TransformSystem(const TransformSystem& other) = delete;
+		TransformSystem& operator=(const TransformSystem& other) = delete;
+
+		/// <summary>
+		/// Allocates a new identity transform with no parent
+		/// </summary>
+		Slot Allocate();
+		/// <summary>
+		/// Frees a transform, any transforms parented to it will become roots
+		/// </summary>
+		void Free(Slot slot);
+		/// <summary>
+		/// Frees all transforms in the system
+		/// </summary>
+		void Clear();
+
+		/// <summary>
+		/// Sets the parent of a transform, or INVALID_SLOT to make it a root
+		/// </summary>
+		void SetParent(Slot slot, Slot parent);
+
+		void SetPosition(Slot slot, const glm::vec3& value);
+		const glm::vec3& GetPosition(Slot slot) const { return _positions[_slotToDense[slot]]; }
+
+		void SetRotation(Slot slot, const glm::quat& value);
+		const glm::quat& GetRotation(Slot slot) const { return _rotations[_slotToDense[slot]]; }
+
+		void SetScale(Slot slot, const glm::vec3& value);
+		const glm::vec3& GetScale(Slot slot) const { return _scales[_slotToDense[slot]]; }
+
+		/// <summary>
+		/// Gets the transform relative to the parent
+		/// </summary>
+		const glm::mat4& GetLocalTransform(Slot slot);
+		/// <summary>
+		/// Gets the inverse of the local transform, calculating it if required
+		/// </summary>
+		const glm::mat4& GetInverseLocalTransform(Slot slot);
+		/// <summary>
+		/// Gets the transform in world space
+		/// </summary>
+		const glm::mat4& GetWorldTransform(Slot slot);
+		/// <summary>
+		/// Gets the inverse of the world transform, calculating it if required
+		/// </summary>
+		const glm::mat4& GetInverseWorldTransform(Slot slot);
+
+		/// <summary>
+		/// Re-sorts the arrays if the hierarchy has changed, then updates all local and world
+		/// transforms that are out of date in a single pass. Should be called once per frame,
+		/// after gameplay and physics have moved things around and before rendering
+		/// </summary>
+		void Propagate();
+
+		/// <summary>
+		/// Gets the number of transforms in the arrays
+		/// </summary>
+		size_t Size() const { return _positions.size(); }
+		/// <summary>
+		/// Gets the world transforms in hierarchy order, only up to date after Propagate
+		/// </summary>
+		const glm::mat4* GetWorldTransforms() const { return _world.data(); }
+		/// <summary>
+		/// Gets the array index of a transform, for use with GetWorldTransforms
+		/// </summary>
+		uint32_t GetIndex(Slot slot) const { return _slotToDense[slot]; }
+
+	private:
+		static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+		enum Flags : uint8_t {
+			LocalDirty        = 1 << 0,
+			InverseLocalValid = 1 << 1,
+			InverseWorldValid = 1 << 2
+		};
+
+		// Per transform data, indexed by position in the sorted arrays
+		std::vector<glm::vec3> _positions;
+		std::vector<glm::quat> _rotations;
+		std::vector<glm::vec3> _scales;
+		std::vector<glm::mat4> _local;
+		std::vector<glm::mat4> _world;
+		std::vector<glm::mat4> _inverseLocal;
+		std::vector<glm::mat4> _inverseWorld;
+		// The index of the parent, or INVALID_INDEX for roots
+		std::vector<uint32_t>  _parents;
+		// Bumped every time the world transform changes
+		std::vector<uint32_t>  _versions;
+		// The version of the parent that our world transform was calculated from
+		std::vector<uint32_t>  _parentVersions;
+		std::vector<uint8_t>   _flags;
+		std::vector<Slot>      _indexToSlot;
+
+		// Maps a Slot to its index in the arrays above
+		std::vector<uint32_t>  _slotToDense;
+		std::vector<Slot>      _freeSlots;
+		// Slots freed since the last sort, they can't be re-used until children pointing at them are fixed up
+		std::vector<Slot>      _pendingFreeSlots;
+
+		// True when the hierarchy has changed or transforms were freed, and the arrays need sorting
+		bool _isOrderDirty;
+		// True when any transform has changed since the last Propagate, atomic since the setters
+		// may be called from parallel component updates
+		std::atomic<bool> _isAnyDirty;
+
+		// Marks a transform as changed
+		void _MarkDirty(uint32_t index);
+		// Re-calculates the local matrix from the TRS values
+		void _RecalcLocal(uint32_t index);
+		// Brings a single world transform up to date, along with its parents
+		void _UpdateWorld(uint32_t index);
+		// Compacts out freed transforms and sorts the arrays by hierarchy depth
+		void _Sort();
+	};
+}
@@ -0,0 +1,66 @@
+#include "Graphics/Bounds.h"
+#include <cstring>
+
+Bounds::Bounds() :
+	Min(glm::vec3(0.0f)),
+	Max(glm::vec3(0.0f)),
+	Center(glm::vec3(0.0f)),
+	Radius(-1.0f)
+{ }
+
+bool Bounds::IsValid() const {
+	return Radius >= 0.0f;
+}
+
+glm::vec3 Bounds::GetExtents() const {
+	return (Max - Min) * 0.5f;
+}
+
+void Bounds::Encapsulate(const Bounds& other) {
+	if (!other.IsValid()) {
+		return;
+	}
+	if (!IsValid()) {
+		*this = other;
+		return;
+	}
+
+	Min = glm::min(Min, other.Min);
+	Max = glm::max(Max, other.Max);
+	Center = (Min + Max) * 0.5f;
+	Radius = glm::length(Max - Min) * 0.5f;
+}
+
+Bounds Bounds::FromPoints(const void* data, size_t count, size_t stride) {
+	Bounds result;
+	if (data == nullptr || count == 0) {
+		return result;
+	}
+
+	stride = stride == 0 ? sizeof(glm::vec3) : stride;
+	const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+
+	// The data may not be aligned for a vec3, so we copy out each position
+	glm::vec3 point;
+	memcpy(&point, bytes, sizeof(glm::vec3));
+	result.Min = point;
+	result.Max = point;
+	for (size_t ix = 1; ix < count; ix++) {
+		memcpy(&point, bytes + ix * stride, sizeof(glm::vec3));
+		result.Min = glm::min(result.Min, point);
+		result.Max = glm::max(result.Max, point);
+	}
+
+	// Center the sphere on the box, then find the furthest point from that center
+	// This is tighter than using the box's half diagonal for most meshes
+	result.Center = (result.Min + result.Max) * 0.5f;
+	float radiusSq = 0.0f;
+	for (size_t ix = 0; ix < count; ix++) {
+		memcpy(&point, bytes + ix * stride, sizeof(glm::vec3));
+		glm::vec3 delta = point - result.Center;
+		radiusSq = glm::max(radiusSq, glm::dot(delta, delta));
+	}
+	result.Radius = glm::sqrt(radiusSq);
+
+	return result;
+}
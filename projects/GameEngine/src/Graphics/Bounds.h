@@ -0,0 +1,57 @@
+#pragma once
+#include <cstdint>
+#include <GLM/glm.hpp>
+
+/// <summary>
+/// Represents the bounding volume of a mesh, stored as both an axis aligned box
+/// and a bounding sphere. The sphere is used for a cheap first test, the box
+/// for a tighter second test
+/// </summary>
+struct Bounds {
+	/// <summary>
+	/// The minimum corner of the axis aligned bounding box
+	/// </summary>
+	glm::vec3 Min;
+	/// <summary>
+	/// The maximum corner of the axis aligned bounding box
+	/// </summary>
+	glm::vec3 Max;
+	/// <summary>
+	/// The center of the bounding sphere (the center of the box)
+	/// </summary>
+	glm::vec3 Center;
+	/// <summary>
+	/// The radius of the bounding sphere, negative if the bounds are empty
+	/// </summary>
+	float     Radius;
+
+	/// <summary>
+	/// Creates an empty bounding volume, which will never be culled
+	/// </summary>
+	Bounds();
+
+	/// <summary>
+	/// Returns true if these bounds contain at least one point
+	/// </summary>
+	bool IsValid() const;
+
+	/// <summary>
+	/// Gets the half size of the bounding box along each axis
+	/// </summary>
+	glm::vec3 GetExtents() const;
+
+	/// <summary>
+	/// Grows these bounds to contain the other bounds
+	/// </summary>
+	/// <param name="other">The bounds to encapsulate</param>
+	void Encapsulate(const Bounds& other);
+
+	/// <summary>
+	/// Calculates the bounds of a set of positions, possibly interleaved with
+	/// other vertex data
+	/// </summary>
+	/// <param name="data">A pointer to the first position</param>
+	/// <param name="count">The number of positions to read</param>
+	/// <param name="stride">The number of bytes between positions, or 0 for tightly packed data</param>
+	static Bounds FromPoints(const void* data, size_t count, size_t stride = 0);
+};
@@ -1,11 +1,13 @@
 #include "IBuffer.h"
 #include "Logging.h"
+#include "Graphics/GlStateCache.h"
 
 IBuffer::IBuffer(BufferType type, BufferUsage usage) :
 	IGraphicsResource(),
 	_elementCount(0),
 	_elementSize(0),
-	_size(0)
+	_size(0),
+	_isImmutable(false)
 {
 	_type = type;
 	_usage = usage;
@@ -18,12 +20,15 @@ GlResourceType IBuffer::GetResourceClass() const {
 
 IBuffer::~IBuffer() {
 	if (_rendererId != 0) {
+		GlStateCache::ForgetBuffer(_rendererId);
 		glDeleteBuffers(1, &_rendererId);
 		_rendererId = 0;
 	}
 }
 
 void IBuffer::LoadData(const void* data, uint32_t elementSize, uint32_t elementCount) {
+	LOG_ASSERT(!_isImmutable, "Cannot re-load an immutable buffer!");
+
 	// Note, this is part of the bindless state access stuff added in 4.5
 	glNamedBufferData(_rendererId, (GLsizeiptr)elementSize * elementCount, data, (GLenum)_usage);
 
@@ -32,8 +37,22 @@ void IBuffer::LoadData(const void* data, uint32_t elementSize, uint32_t elementC
 	_size = elementCount * elementSize;
 }
 
+void IBuffer::LoadImmutableData(const void* data, uint32_t elementSize, uint32_t elementCount) {
+	LOG_ASSERT(!_isImmutable, "Cannot re-load an immutable buffer!");
+
+	// No flags, the data never changes after this so the driver can put it wherever is fastest for the GPU
+	glNamedBufferStorage(_rendererId, (GLsizeiptr)elementSize * elementCount, data, 0);
+
+	_elementCount = elementCount;
+	_elementSize = elementSize;
+	_size = elementCount * elementSize;
+	_isImmutable = true;
+}
+
 void IBuffer::UpdateData(const void* data, uint32_t elementSize, uint32_t elementCount, bool allowResize /*= true*/)
 {
+	LOG_ASSERT(!_isImmutable, "Cannot update an immutable buffer!");
+
 	if (elementSize * elementCount > _size) {
 		if (allowResize) {
 			glNamedBufferData(_rendererId, (GLsizeiptr)elementSize * elementCount, data, (GLenum)_usage);
@@ -73,7 +92,7 @@ void IBuffer::Bind() const {
 
 void IBuffer::Bind(uint32_t slot) const
 {
-	glBindBufferBase((GLenum)_type, slot, _rendererId);
+	GlStateCache::BindBufferBase((GLenum)_type, slot, _rendererId);
 }
 
 void IBuffer::UnBind(BufferType type) {
@@ -81,5 +100,5 @@ void IBuffer::UnBind(BufferType type) {
 }
 
 void IBuffer::UnBind(BufferType type, uint32_t slot) {
-	glBindBufferBase((GLenum)type, slot, 0);
+	GlStateCache::BindBufferBase((GLenum)type, slot, 0);
 }
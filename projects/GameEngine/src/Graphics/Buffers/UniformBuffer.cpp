@@ -1,5 +1,6 @@
 #include "UniformBuffer.h"
 #include "Logging.h"
+#include "Graphics/GlStateCache.h"
 
 AbstractUniformBuffer::~AbstractUniformBuffer() {
 	delete[] _rawData;
@@ -25,11 +26,11 @@ void AbstractUniformBuffer::LoadData(const void* data, uint32_t elementSize, uin
 }
 
 void AbstractUniformBuffer::Bind() const {
-	glBindBufferBase(GL_UNIFORM_BUFFER, 0, _rendererId);
+	GlStateCache::BindBufferBase(GL_UNIFORM_BUFFER, 0, _rendererId);
 }
 
 void AbstractUniformBuffer::Bind(int slot) const
 {
-	glBindBufferBase(GL_UNIFORM_BUFFER, slot, _rendererId);
+	GlStateCache::BindBufferBase(GL_UNIFORM_BUFFER, slot, _rendererId);
 }
 
@@ -0,0 +1,95 @@
+#include "UniformRingBuffer.h"
+#include "Logging.h"
+#include "Graphics/GlStateCache.h"
+
+// How long we'll wait for a single fence before giving up and warning, in nanoseconds
+static const GLuint64 FENCE_TIMEOUT = 1000000000;
+
+UniformRingBuffer::UniformRingBuffer(uint32_t blockSize, uint32_t blocksPerFrame, uint32_t frameCount) :
+	IGraphicsResource(),
+	_blockSize(blockSize),
+	_blockStride(0),
+	_blocksPerFrame(blocksPerFrame),
+	_segmentSize(0),
+	_segment(0),
+	_blocksUsed(0),
+	_mappedData(nullptr),
+	_fences(std::vector<GLsync>())
+{
+	LOG_ASSERT(frameCount > 0, "Ring buffer needs at least one segment!");
+
+	// Each block needs to start on an offset that the driver will accept for glBindBufferRange
+	GLint alignment = 256;
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+	_blockStride = ((blockSize + alignment - 1) / alignment) * alignment;
+	_segmentSize = _blockStride * blocksPerFrame;
+	_fences.resize(frameCount, nullptr);
+
+	// Immutable storage lets us keep the buffer mapped while the GPU is using it
+	GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	glCreateBuffers(1, &_rendererId);
+	glNamedBufferStorage(_rendererId, (GLsizeiptr)_segmentSize * frameCount, nullptr, flags);
+	_mappedData = reinterpret_cast<uint8_t*>(glMapNamedBufferRange(_rendererId, 0, (GLsizeiptr)_segmentSize * frameCount, flags));
+
+	LOG_ASSERT(_mappedData != nullptr, "Failed to map ring buffer!");
+
+	// Start on the last segment, so that the first BeginFrame wraps around to 0
+	_segment = frameCount - 1;
+}
+
+UniformRingBuffer::~UniformRingBuffer() {
+	for (GLsync& fence : _fences) {
+		if (fence != nullptr) {
+			glDeleteSync(fence);
+			fence = nullptr;
+		}
+	}
+	if (_rendererId != 0) {
+		glUnmapNamedBuffer(_rendererId);
+		GlStateCache::ForgetBuffer(_rendererId);
+		glDeleteBuffers(1, &_rendererId);
+		_rendererId = 0;
+	}
+}
+
+void UniformRingBuffer::BeginFrame() {
+	_segment = (_segment + 1) % static_cast<uint32_t>(_fences.size());
+	_blocksUsed = 0;
+
+	// Make sure the GPU is done with this segment before we start writing over it
+	GLsync& fence = _fences[_segment];
+	if (fence != nullptr) {
+		GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_TIMEOUT);
+		if (result == GL_TIMEOUT_EXPIRED || result == GL_WAIT_FAILED) {
+			LOG_WARN("Timed out waiting for uniform ring buffer segment {}", _segment);
+		}
+		glDeleteSync(fence);
+		fence = nullptr;
+	}
+}
+
+void UniformRingBuffer::EndFrame() {
+	GLsync& fence = _fences[_segment];
+	if (fence != nullptr) {
+		glDeleteSync(fence);
+	}
+	fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void* UniformRingBuffer::Allocate(uint32_t& offset) {
+	if (_blocksUsed >= _blocksPerFrame || _mappedData == nullptr) {
+		return nullptr;
+	}
+
+	offset = _segment * _segmentSize + _blocksUsed * _blockStride;
+	_blocksUsed++;
+	return _mappedData + offset;
+}
+
+void UniformRingBuffer::BindRange(int slot, uint32_t offset) const {
+	GlStateCache::BindBufferRange(GL_UNIFORM_BUFFER, slot, _rendererId, offset, _blockSize);
+}
+
+GlResourceType UniformRingBuffer::GetResourceClass() const {
+	return GlResourceType::Buffer;
+}
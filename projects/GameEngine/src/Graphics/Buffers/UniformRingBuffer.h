@@ -0,0 +1,91 @@
+#pragma once
+#include <glad/glad.h>
+#include <vector>
+#include <memory>
+
+#include "Graphics/IGraphicsResource.h"
+#include "Logging.h"
+
+/// <summary>
+/// A persistently mapped uniform buffer, split into one segment per frame in flight,
+/// that hands out fixed size blocks for per-draw data. Each draw binds its own
+/// block with glBindBufferRange, so we never have to update a buffer that the GPU
+/// may still be reading from
+///
+/// Each segment is guarded by a fence, so that we only wait on the GPU if it is
+/// more than FrameCount frames behind the CPU
+/// </summary>
+class UniformRingBuffer : public IGraphicsResource {
+public:
+	DEFINE_RESOURCE(UniformRingBuffer);
+
+	/// <summary>
+	/// Creates a new ring buffer
+	/// </summary>
+	/// <param name="blockSize">The size in bytes of a single block, will be padded to GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT</param>
+	/// <param name="blocksPerFrame">The maximum number of blocks that can be allocated between BeginFrame and EndFrame</param>
+	/// <param name="frameCount">The number of frames that can be in flight, default 3 (triple buffering)</param>
+	UniformRingBuffer(uint32_t blockSize, uint32_t blocksPerFrame, uint32_t frameCount = 3);
+	virtual ~UniformRingBuffer();
+
+	/// <summary>
+	/// Moves to the next segment in the ring, waiting for the GPU if it is
+	/// still using that segment. Should be called once per frame before any allocations
+	/// </summary>
+	void BeginFrame();
+	/// <summary>
+	/// Places a fence after all the draws that use the current segment
+	/// </summary>
+	void EndFrame();
+
+	/// <summary>
+	/// Allocates a block from the current frame's segment
+	/// </summary>
+	/// <param name="offset">Will store the offset of the block in the buffer, to be passed to BindRange</param>
+	/// <returns>A write-only pointer to the block, or nullptr if the segment is full</returns>
+	void* Allocate(uint32_t& offset);
+
+	/// <summary>
+	/// Allocates a block from the current frame's segment
+	/// </summary>
+	/// <typeparam name="T">The type of structure to allocate, should not be larger than the block size</typeparam>
+	/// <param name="offset">Will store the offset of the block in the buffer, to be passed to BindRange</param>
+	/// <returns>A write-only pointer to the block, or nullptr if the segment is full</returns>
+	template <typename T>
+	T* Allocate(uint32_t& offset) {
+		LOG_ASSERT(sizeof(T) <= _blockSize, "Structure is larger than the block size!");
+		return reinterpret_cast<T*>(Allocate(offset));
+	}
+
+	/// <summary>
+	/// Binds a single block to the given uniform buffer binding slot
+	/// </summary>
+	/// <param name="slot">The uniform buffer binding slot</param>
+	/// <param name="offset">The offset of the block, as returned by Allocate</param>
+	void BindRange(int slot, uint32_t offset) const;
+
+	/// <summary>
+	/// Gets the number of blocks that have been allocated this frame
+	/// </summary>
+	uint32_t GetBlocksUsed() const { return _blocksUsed; }
+	/// <summary>
+	/// Gets the maximum number of blocks that can be allocated per frame
+	/// </summary>
+	uint32_t GetBlocksPerFrame() const { return _blocksPerFrame; }
+
+	// Inherited from IGraphicsResource
+	virtual GlResourceType GetResourceClass() const override;
+
+protected:
+	uint32_t _blockSize;
+	uint32_t _blockStride;
+	uint32_t _blocksPerFrame;
+	uint32_t _segmentSize;
+	uint32_t _segment;
+	uint32_t _blocksUsed;
+
+	// The CPU side pointer to the whole buffer, valid for the lifetime of the buffer
+	uint8_t* _mappedData;
+	// One fence per segment, nullptr when the segment is not in use
+	std::vector<GLsync> _fences;
+};
@@ -70,18 +70,12 @@ void DebugDrawer::FlushLines()
 	if (_lineOffset > 0) {
 		__Shader->Bind();
 		__Shader->SetUniformMatrix("u_MVP", _viewProjection * _transformStack.top());
-		int restorePoint = 0;
 		glLineWidth(2.0f);
-		glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &restorePoint);
-		VertexArrayObject::Unbind();
+		// Buffer uploads use DSA, so there's no need to unbind and restore the current VAO around them
 		_linesVBO->LoadData<VertexPosCol>(_lineBuffer, LINE_BATCH_SIZE * 2);
 		_linesVAO->Bind();
 		glDrawArrays((GLenum)DrawMode::LineList, 0, _lineOffset);
-		_linesVAO->Unbind();
 		_lineOffset = 0;
-		if (restorePoint != 0) {
-			glBindVertexArray(restorePoint);
-		}
 	}
 }
 
@@ -114,17 +108,10 @@ void DebugDrawer::FlushTris()
 	if (_triangleOffset > 0) {
 		__Shader->Bind();
 		__Shader->SetUniformMatrix("u_MVP", _viewProjection * _transformStack.top());
-		int restorePoint = 0;
-		glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &restorePoint);
-		VertexArrayObject::Unbind();
 		_trisVBO->LoadData<VertexPosCol>(_triBuffer, TRI_BATCH_SIZE * 3);
 		_trisVAO->Bind();
 		glDrawArrays((GLenum)DrawMode::TriangleList, 0, _triangleOffset);
-		_trisVAO->Unbind();
 		_triangleOffset = 0;
-		if (restorePoint != 0) {
-			glBindVertexArray(restorePoint);
-		}
 	}
 }
 
@@ -1,6 +1,9 @@
 #include "Graphics/Framebuffer.h"
 
+#include <algorithm>
+
 #include "Graphics/RenderBuffer.h"
+#include "Graphics/GlStateCache.h"
 #include "Utils/JsonGlmHelpers.h"
 
 
@@ -25,6 +28,7 @@ Framebuffer::Framebuffer(const FramebufferDescriptor& description) :
 
 Framebuffer::~Framebuffer() {
 	LOG_INFO("Deleting frame buffer with ID: {}", _rendererId);
+	GlStateCache::ForgetFramebuffer(_rendererId);
 	glDeleteFramebuffers(1, &_rendererId);
 }
 
@@ -177,26 +181,73 @@ bool Framebuffer::BindAttachment(RenderTargetAttachment attachment, int slot) co
 	return false;
 }
 
+void Framebuffer::ClearAttachment(RenderTargetAttachment attachment, const glm::vec4& value) {
+	if (IsColorAttachment(attachment)) {
+		// Color clears are addressed by draw buffer index, not by attachment
+		auto it = std::find(_drawBuffers.begin(), _drawBuffers.end(), attachment);
+		if (it == _drawBuffers.end()) {
+			LOG_WARN("Attempted to clear attachment {} that is not in framebuffer {}", ~attachment, _rendererId);
+			return;
+		}
+		glClearNamedFramebufferfv(_rendererId, GL_COLOR, (GLint)(it - _drawBuffers.begin()), &value.x);
+	}
+	else if (attachment == RenderTargetAttachment::Depth) {
+		glClearNamedFramebufferfv(_rendererId, GL_DEPTH, 0, &value.x);
+	}
+	else if (attachment == RenderTargetAttachment::Stencil) {
+		GLint stencil = (GLint)value.x;
+		glClearNamedFramebufferiv(_rendererId, GL_STENCIL, 0, &stencil);
+	}
+	else if (attachment == RenderTargetAttachment::DepthStencil) {
+		glClearNamedFramebufferfi(_rendererId, GL_DEPTH_STENCIL, 0, value.x, (GLint)value.y);
+	}
+}
+
+void Framebuffer::ApplyLoadPolicy(const FramebufferLoadPolicy& policy) {
+	// Collect all the don't care attachments so we can invalidate them in one call
+	RenderTargetAttachment discarded[16];
+	GLsizei numDiscarded = 0;
+
+	for (const AttachmentLoadAction& action : policy) {
+		switch (action.Op) {
+			case LoadOp::Clear:
+				ClearAttachment(action.Attachment, action.ClearValue);
+				break;
+			case LoadOp::DontCare:
+				if (numDiscarded < 16) {
+					discarded[numDiscarded++] = action.Attachment;
+				}
+				break;
+			case LoadOp::Load:
+			default:
+				break;
+		}
+	}
+
+	if (numDiscarded > 0) {
+		glInvalidateNamedFramebufferData(_rendererId, numDiscarded, reinterpret_cast<const GLenum*>(discarded));
+	}
+}
+
 void Framebuffer::Bind(FramebufferBinding bindMode /*= FramebufferBinding::Draw*/) const {
 	_currentBinding = bindMode;
-	// Make sure that we're drawing to all the color buffers
-	glNamedFramebufferDrawBuffers(_rendererId, _drawBuffers.size(), reinterpret_cast<const GLenum*>(_drawBuffers.data()));
-	glBindFramebuffer(*bindMode, _rendererId);
+	// Our draw buffers are framebuffer state and are kept up to date in _AddAttachment, so all we need is the bind
+	GlStateCache::BindFramebuffer(*bindMode, _rendererId);
 }
 
 void Framebuffer::Unbind() {
 	// Only handle if we've been bound
 	if (_currentBinding != FramebufferBinding::None) {
 		// Unbind the framebuffer and clear our binding
-		glBindFramebuffer(*_currentBinding, 0);
+		GlStateCache::BindFramebuffer(*_currentBinding, 0);
 		_currentBinding = FramebufferBinding::None;
 	}
 }
 
 void Framebuffer::Blit(const Sptr& source, const Sptr& dest, BufferFlags flags /*= BufferFlags::All*/, MagFilter filter /*= MagFilter::Linear*/) {
 	// Bind this buffer as the read, and the unsampled as the write
-	glBindFramebuffer(GL_READ_FRAMEBUFFER, source ? source->GetHandle() : 0);
-	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, dest ? dest->GetHandle() : 0);
+	GlStateCache::BindFramebuffer(GL_READ_FRAMEBUFFER, source ? source->GetHandle() : 0);
+	GlStateCache::BindFramebuffer(GL_DRAW_FRAMEBUFFER, dest ? dest->GetHandle() : 0);
 
 	// Figure out bounds of the framebuffers
 	glm::ivec4 srcBounds; 
@@ -222,8 +273,8 @@ void Framebuffer::Blit(const Sptr& source, const Sptr& dest, BufferFlags flags /
 	Blit(srcBounds, dstBounds, flags, filter);
 
 	// Unbind both buffers
-	glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
-	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+	GlStateCache::BindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+	GlStateCache::BindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
 }
 
 void Framebuffer::Blit(const glm::ivec4& srcBounds, const glm::ivec4& dstBounds, BufferFlags flags /*= BufferFlags::All*/, MagFilter filter /*= MagFilter::Linear*/) {
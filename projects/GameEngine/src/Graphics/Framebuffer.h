@@ -33,6 +33,50 @@ struct RenderTargetDescriptor {
 	{ }
 };
 
+/**
+ * What a pass does with the existing contents of an attachment when it starts
+ * rendering to it
+ *
+ * Load     - Keep the existing contents
+ * Clear    - Clear the attachment to a given value
+ * DontCare - The pass will overwrite every pixel, the existing contents may be discarded
+ */
+ENUM(LoadOp, uint32_t,
+	Load     = 0,
+	Clear    = 1,
+	DontCare = 2
+);
+
+/**
+ * Describes how a single attachment should be prepared at the start of a pass
+ */
+struct AttachmentLoadAction {
+	/**
+	 * The attachment that this action applies to
+	 */
+	RenderTargetAttachment Attachment;
+	/**
+	 * What to do with the attachment's existing contents
+	 */
+	LoadOp                 Op;
+	/**
+	 * The value to clear to if Op is Clear. For depth attachments, x is the depth
+	 * value, and for depth-stencil attachments y is the stencil value
+	 */
+	glm::vec4              ClearValue;
+
+	AttachmentLoadAction(RenderTargetAttachment attachment = RenderTargetAttachment::Color0, LoadOp op = LoadOp::Load, const glm::vec4& clearValue = glm::vec4(0.0f)) :
+		Attachment(attachment),
+		Op(op),
+		ClearValue(clearValue)
+	{ }
+};
+
+/**
+ * A declarative set of load actions for a pass, attachments that are not listed are loaded
+ */
+typedef std::vector<AttachmentLoadAction> FramebufferLoadPolicy;
+
 /**
  * Describes a frame buffer, allowing framebuffers to be easily serialized
  * and cloned
@@ -111,6 +155,23 @@ public:
 	 */
 	bool BindAttachment(RenderTargetAttachment attachment, int slot) const;
 
+	/**
+	 * Clears a single attachment of this framebuffer to the given value, without needing
+	 * to bind the framebuffer. Respects the current color, depth and stencil write masks
+	 * 
+	 * @param attachment The render target attachment to clear
+	 * @param value      The value to clear to. For depth attachments, x is the depth value, and
+	 *                   for depth-stencil attachments y is the stencil value
+	 */
+	void ClearAttachment(RenderTargetAttachment attachment, const glm::vec4& value);
+	/**
+	 * Applies a pass load policy to this framebuffer, clearing attachments marked as Clear
+	 * and invalidating attachments marked as DontCare
+	 * 
+	 * @param policy The load actions to apply, attachments not in the policy are left as-is
+	 */
+	void ApplyLoadPolicy(const FramebufferLoadPolicy& policy);
+
 	/**
 	 * Binds this framebuffer to the given framebuffer binding slot
 	 * 
@@ -0,0 +1,146 @@
+#include "Graphics/Frustum.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE__)
+#define FRUSTUM_USE_SSE
+#include <xmmintrin.h>
+#endif
+
+Frustum::Frustum() {
+	// Every plane is (0, 0, 0, 1), so every point is 1 unit inside of them
+	for (int ix = 0; ix < 8; ix++) {
+		_planeX[ix] = 0.0f;
+		_planeY[ix] = 0.0f;
+		_planeZ[ix] = 0.0f;
+		_planeW[ix] = 1.0f;
+	}
+}
+
+Frustum::Frustum(const glm::mat4& viewProjection) :
+	Frustum()
+{
+	SetFromMatrix(viewProjection);
+}
+
+void Frustum::SetFromMatrix(const glm::mat4& viewProjection) {
+	// GLM is column major, so we need to grab the rows by hand
+	glm::vec4 rows[4];
+	for (int ix = 0; ix < 4; ix++) {
+		rows[ix] = glm::vec4(viewProjection[0][ix], viewProjection[1][ix], viewProjection[2][ix], viewProjection[3][ix]);
+	}
+
+	const glm::vec4 planes[6] = {
+		rows[3] + rows[0], // Left
+		rows[3] - rows[0], // Right
+		rows[3] + rows[1], // Bottom
+		rows[3] - rows[1], // Top
+		rows[3] + rows[2], // Near
+		rows[3] - rows[2]  // Far
+	};
+
+	for (int ix = 0; ix < 6; ix++) {
+		// Normalize so that the plane distance is in world units, which we need for sphere tests
+		float length = glm::length(glm::vec3(planes[ix]));
+		glm::vec4 plane = length > 0.0f ? planes[ix] / length : planes[ix];
+
+		_planeX[ix] = plane.x;
+		_planeY[ix] = plane.y;
+		_planeZ[ix] = plane.z;
+		_planeW[ix] = plane.w;
+	}
+}
+
+bool Frustum::TestSphere(const glm::vec3& center, float radius) const {
+	#ifdef FRUSTUM_USE_SSE
+	const __m128 cx = _mm_set1_ps(center.x);
+	const __m128 cy = _mm_set1_ps(center.y);
+	const __m128 cz = _mm_set1_ps(center.z);
+	const __m128 negRadius = _mm_set1_ps(-radius);
+
+	for (int ix = 0; ix < 8; ix += 4) {
+		// dist = dot(plane.xyz, center) + plane.w, for 4 planes at once
+		__m128 dist = _mm_add_ps(
+			_mm_add_ps(_mm_mul_ps(_mm_load_ps(_planeX + ix), cx), _mm_mul_ps(_mm_load_ps(_planeY + ix), cy)),
+			_mm_add_ps(_mm_mul_ps(_mm_load_ps(_planeZ + ix), cz), _mm_load_ps(_planeW + ix))
+		);
+		// If the sphere is fully behind any of the planes, it's outside
+		if (_mm_movemask_ps(_mm_cmplt_ps(dist, negRadius)) != 0) {
+			return false;
+		}
+	}
+	return true;
+	#else
+	for (int ix = 0; ix < 6; ix++) {
+		float dist = _planeX[ix] * center.x + _planeY[ix] * center.y + _planeZ[ix] * center.z + _planeW[ix];
+		if (dist < -radius) {
+			return false;
+		}
+	}
+	return true;
+	#endif
+}
+
+bool Frustum::TestAABB(const glm::vec3& min, const glm::vec3& max) const {
+	#ifdef FRUSTUM_USE_SSE
+	const __m128 minX = _mm_set1_ps(min.x), maxX = _mm_set1_ps(max.x);
+	const __m128 minY = _mm_set1_ps(min.y), maxY = _mm_set1_ps(max.y);
+	const __m128 minZ = _mm_set1_ps(min.z), maxZ = _mm_set1_ps(max.z);
+	const __m128 zero = _mm_setzero_ps();
+
+	for (int ix = 0; ix < 8; ix += 4) {
+		__m128 px = _mm_load_ps(_planeX + ix);
+		__m128 py = _mm_load_ps(_planeY + ix);
+		__m128 pz = _mm_load_ps(_planeZ + ix);
+
+		// Taking the max of each axis selects the corner furthest along the plane normal
+		__m128 dist = _mm_add_ps(
+			_mm_add_ps(
+				_mm_max_ps(_mm_mul_ps(px, minX), _mm_mul_ps(px, maxX)),
+				_mm_max_ps(_mm_mul_ps(py, minY), _mm_mul_ps(py, maxY))),
+			_mm_add_ps(
+				_mm_max_ps(_mm_mul_ps(pz, minZ), _mm_mul_ps(pz, maxZ)),
+				_mm_load_ps(_planeW + ix))
+		);
+		// If even that corner is behind a plane, the whole box is outside
+		if (_mm_movemask_ps(_mm_cmplt_ps(dist, zero)) != 0) {
+			return false;
+		}
+	}
+	return true;
+	#else
+	for (int ix = 0; ix < 6; ix++) {
+		float dist =
+			glm::max(_planeX[ix] * min.x, _planeX[ix] * max.x) +
+			glm::max(_planeY[ix] * min.y, _planeY[ix] * max.y) +
+			glm::max(_planeZ[ix] * min.z, _planeZ[ix] * max.z) +
+			_planeW[ix];
+		if (dist < 0.0f) {
+			return false;
+		}
+	}
+	return true;
+	#endif
+}
+
+bool Frustum::TestBounds(const Bounds& bounds, const glm::mat4& transform) const {
+	if (!bounds.IsValid()) {
+		return true;
+	}
+
+	const glm::mat3 basis = glm::mat3(transform);
+
+	// Sphere first, scaled by the largest axis scale so non-uniform scales stay conservative
+	float scale = glm::sqrt(glm::max(glm::dot(basis[0], basis[0]), glm::max(glm::dot(basis[1], basis[1]), glm::dot(basis[2], basis[2]))));
+	glm::vec3 center = glm::vec3(transform * glm::vec4(bounds.Center, 1.0f));
+	if (!TestSphere(center, bounds.Radius * scale)) {
+		return false;
+	}
+
+	// Then the box, re-fit around the transformed box (Arvo's method)
+	glm::vec3 extents = bounds.GetExtents();
+	glm::vec3 worldExtents = glm::vec3(
+		glm::abs(basis[0][0]) * extents.x + glm::abs(basis[1][0]) * extents.y + glm::abs(basis[2][0]) * extents.z,
+		glm::abs(basis[0][1]) * extents.x + glm::abs(basis[1][1]) * extents.y + glm::abs(basis[2][1]) * extents.z,
+		glm::abs(basis[0][2]) * extents.x + glm::abs(basis[1][2]) * extents.y + glm::abs(basis[2][2]) * extents.z
+	);
+	return TestAABB(center - worldExtents, center + worldExtents);
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <GLM/glm.hpp>
+#include "Graphics/Bounds.h"
+
+/// <summary>
+/// A view frustum, extracted from a view-projection matrix, that we can test
+/// bounding volumes against for culling
+///
+/// The 6 planes are stored in structure of arrays form, padded out to 8 planes,
+/// so that we can test 4 planes at a time with SSE
+/// </summary>
+class Frustum {
+public:
+	/// <summary>
+	/// Creates a frustum that will contain everything
+	/// </summary>
+	Frustum();
+	/// <summary>
+	/// Creates a frustum from the given view projection matrix
+	/// </summary>
+	/// <param name="viewProjection">The matrix to extract the planes from</param>
+	explicit Frustum(const glm::mat4& viewProjection);
+
+	/// <summary>
+	/// Extracts the frustum planes from a view-projection matrix (Gribb-Hartmann)
+	/// Passing in just a projection matrix will give planes in view space
+	/// </summary>
+	/// <param name="viewProjection">The matrix to extract the planes from</param>
+	void SetFromMatrix(const glm::mat4& viewProjection);
+
+	/// <summary>
+	/// Returns true if the sphere is at least partially inside the frustum
+	/// </summary>
+	bool TestSphere(const glm::vec3& center, float radius) const;
+	/// <summary>
+	/// Returns true if the axis aligned box is at least partially inside the frustum
+	/// </summary>
+	bool TestAABB(const glm::vec3& min, const glm::vec3& max) const;
+	/// <summary>
+	/// Transforms the local space bounds into the frustum's space, then tests the
+	/// sphere and the box against the frustum. Invalid bounds are always visible
+	/// </summary>
+	/// <param name="bounds">The bounds in model space</param>
+	/// <param name="transform">The model to world transform for the bounds</param>
+	/// <returns>True if the bounds are at least partially inside the frustum</returns>
+	bool TestBounds(const Bounds& bounds, const glm::mat4& transform) const;
+
+protected:
+	// Plane components, where index 0-5 are left, right, bottom, top, near, far
+	// and 6-7 are padding planes that always pass
+	alignas(16) float _planeX[8];
+	alignas(16) float _planeY[8];
+	alignas(16) float _planeZ[8];
+	alignas(16) float _planeW[8];
+};
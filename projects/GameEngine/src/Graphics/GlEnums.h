@@ -17,6 +17,7 @@ ENUM(ShaderPartType, GLint,
 	TessControl = GL_TESS_CONTROL_SHADER,
 	TessEval = GL_TESS_EVALUATION_SHADER,
 	Geometry = GL_GEOMETRY_SHADER,
+	Compute = GL_COMPUTE_SHADER,
 	Unknown = GL_NONE // Usually good practice to have an "unknown" or "none" state for enums
 )
 
@@ -751,7 +752,8 @@ ENUM(FillMode, uint32_t,
 	ENUM(BufferType, GLenum,
 		Vertex = GL_ARRAY_BUFFER,
 		Index = GL_ELEMENT_ARRAY_BUFFER,
-		Uniform = GL_UNIFORM_BUFFER
+		Uniform = GL_UNIFORM_BUFFER,
+		ShaderStorage = GL_SHADER_STORAGE_BUFFER
 	)
 
 	/// <summary>
@@ -0,0 +1,196 @@
+#include "Graphics/GlStateCache.h"
+
+GLuint GlStateCache::_program = GlStateCache::UNKNOWN;
+GLuint GlStateCache::_vertexArray = GlStateCache::UNKNOWN;
+// Zero initialized, which matches the state of a new context
+GLuint GlStateCache::_textures[GlStateCache::MAX_TEXTURE_UNITS];
+GlStateCache::BufferBinding GlStateCache::_uniformBuffers[GlStateCache::MAX_BUFFER_SLOTS];
+GlStateCache::BufferBinding GlStateCache::_storageBuffers[GlStateCache::MAX_BUFFER_SLOTS];
+GLuint GlStateCache::_drawFramebuffer = GlStateCache::UNKNOWN;
+GLuint GlStateCache::_readFramebuffer = GlStateCache::UNKNOWN;
+
+GlStateCounters GlStateCache::_counters[GlStateCache::NUM_STATE_TYPES];
+GlStateCounters GlStateCache::_lastFrameCounters[GlStateCache::NUM_STATE_TYPES];
+
+void GlStateCache::UseProgram(GLuint program) {
+	bool issue = _program != program;
+	if (issue) {
+		glUseProgram(program);
+		_program = program;
+	}
+	_Count(GlStateType::Program, issue);
+}
+
+void GlStateCache::BindVertexArray(GLuint vao) {
+	bool issue = _vertexArray != vao;
+	if (issue) {
+		glBindVertexArray(vao);
+		_vertexArray = vao;
+	}
+	_Count(GlStateType::VertexArray, issue);
+}
+
+void GlStateCache::BindTextureUnit(uint32_t unit, GLuint texture) {
+	// Units past what we track always go through
+	if (unit >= MAX_TEXTURE_UNITS) {
+		glBindTextureUnit(unit, texture);
+		_Count(GlStateType::Texture, true);
+		return;
+	}
+
+	bool issue = _textures[unit] != texture;
+	if (issue) {
+		glBindTextureUnit(unit, texture);
+		_textures[unit] = texture;
+	}
+	_Count(GlStateType::Texture, issue);
+}
+
+void GlStateCache::BindBufferBase(GLenum target, uint32_t slot, GLuint buffer) {
+	BufferBinding* slots = _GetBufferSlots(target);
+	if (slots == nullptr || slot >= MAX_BUFFER_SLOTS) {
+		glBindBufferBase(target, slot, buffer);
+		_Count(GlStateType::Buffer, true);
+		return;
+	}
+
+	BufferBinding& binding = slots[slot];
+	bool issue = binding.Buffer != buffer || binding.Offset != 0 || binding.Size != 0;
+	if (issue) {
+		glBindBufferBase(target, slot, buffer);
+		binding.Buffer = buffer;
+		binding.Offset = 0;
+		binding.Size = 0;
+	}
+	_Count(GlStateType::Buffer, issue);
+}
+
+void GlStateCache::BindBufferRange(GLenum target, uint32_t slot, GLuint buffer, GLintptr offset, GLsizeiptr size) {
+	BufferBinding* slots = _GetBufferSlots(target);
+	if (slots == nullptr || slot >= MAX_BUFFER_SLOTS) {
+		glBindBufferRange(target, slot, buffer, offset, size);
+		_Count(GlStateType::Buffer, true);
+		return;
+	}
+
+	BufferBinding& binding = slots[slot];
+	bool issue = binding.Buffer != buffer || binding.Offset != offset || binding.Size != size;
+	if (issue) {
+		glBindBufferRange(target, slot, buffer, offset, size);
+		binding.Buffer = buffer;
+		binding.Offset = offset;
+		binding.Size = size;
+	}
+	_Count(GlStateType::Buffer, issue);
+}
+
+void GlStateCache::BindFramebuffer(GLenum target, GLuint framebuffer) {
+	bool draw = target == GL_FRAMEBUFFER || target == GL_DRAW_FRAMEBUFFER;
+	bool read = target == GL_FRAMEBUFFER || target == GL_READ_FRAMEBUFFER;
+
+	bool issue = (draw && _drawFramebuffer != framebuffer) || (read && _readFramebuffer != framebuffer);
+	if (issue) {
+		glBindFramebuffer(target, framebuffer);
+		if (draw) _drawFramebuffer = framebuffer;
+		if (read) _readFramebuffer = framebuffer;
+	}
+	_Count(GlStateType::Framebuffer, issue);
+}
+
+GLuint GlStateCache::GetDrawFramebuffer() {
+	return _drawFramebuffer;
+}
+
+void GlStateCache::ForgetProgram(GLuint program) {
+	if (_program == program) {
+		_program = UNKNOWN;
+	}
+}
+
+void GlStateCache::ForgetVertexArray(GLuint vao) {
+	if (_vertexArray == vao) {
+		_vertexArray = UNKNOWN;
+	}
+}
+
+void GlStateCache::ForgetTexture(GLuint texture) {
+	for (uint32_t ix = 0; ix < MAX_TEXTURE_UNITS; ix++) {
+		if (_textures[ix] == texture) {
+			_textures[ix] = UNKNOWN;
+		}
+	}
+}
+
+void GlStateCache::ForgetBuffer(GLuint buffer) {
+	for (uint32_t ix = 0; ix < MAX_BUFFER_SLOTS; ix++) {
+		if (_uniformBuffers[ix].Buffer == buffer) {
+			_uniformBuffers[ix] = BufferBinding();
+		}
+		if (_storageBuffers[ix].Buffer == buffer) {
+			_storageBuffers[ix] = BufferBinding();
+		}
+	}
+}
+
+void GlStateCache::ForgetFramebuffer(GLuint framebuffer) {
+	if (_drawFramebuffer == framebuffer) {
+		_drawFramebuffer = UNKNOWN;
+	}
+	if (_readFramebuffer == framebuffer) {
+		_readFramebuffer = UNKNOWN;
+	}
+}
+
+void GlStateCache::Invalidate() {
+	_program = UNKNOWN;
+	_vertexArray = UNKNOWN;
+	for (uint32_t ix = 0; ix < MAX_TEXTURE_UNITS; ix++) {
+		_textures[ix] = UNKNOWN;
+	}
+	for (uint32_t ix = 0; ix < MAX_BUFFER_SLOTS; ix++) {
+		_uniformBuffers[ix] = BufferBinding();
+		_storageBuffers[ix] = BufferBinding();
+	}
+	_drawFramebuffer = UNKNOWN;
+	_readFramebuffer = UNKNOWN;
+}
+
+void GlStateCache::BeginFrame() {
+	for (uint32_t ix = 0; ix < NUM_STATE_TYPES; ix++) {
+		_lastFrameCounters[ix] = _counters[ix];
+		_counters[ix] = GlStateCounters();
+	}
+
+	// ImGui renders at the end of the frame with raw GL calls, so we can't trust anything we tracked
+	Invalidate();
+}
+
+const GlStateCounters& GlStateCache::GetFrameCounters(GlStateType type) {
+	return _lastFrameCounters[*type];
+}
+
+GlStateCounters GlStateCache::GetFrameTotals() {
+	GlStateCounters result;
+	for (uint32_t ix = 0; ix < NUM_STATE_TYPES; ix++) {
+		result.Issued   += _lastFrameCounters[ix].Issued;
+		result.Filtered += _lastFrameCounters[ix].Filtered;
+	}
+	return result;
+}
+
+GlStateCache::BufferBinding* GlStateCache::_GetBufferSlots(GLenum target) {
+	switch (target) {
+		case GL_UNIFORM_BUFFER:        return _uniformBuffers;
+		case GL_SHADER_STORAGE_BUFFER: return _storageBuffers;
+		default:                       return nullptr;
+	}
+}
+
+void GlStateCache::_Count(GlStateType type, bool issued) {
+	GlStateCounters& counters = _counters[*type];
+	if (issued) {
+		counters.Issued++;
+	} else {
+		counters.Filtered++;
+	}
+}
@@ -0,0 +1,149 @@
+#pragma once
+#include <glad/glad.h>
+#include <cstdint>
+#include <EnumToString.h>
+
+/// <summary>
+/// The categories of binding that the GlStateCache tracks
+/// </summary>
+ENUM(GlStateType, uint32_t,
+	Program     = 0,
+	VertexArray = 1,
+	Texture     = 2,
+	Buffer      = 3,
+	Framebuffer = 4
+);
+
+/// <summary>
+/// Counts how many bind calls went to the driver, and how many were skipped
+/// because the binding was already in place
+/// </summary>
+struct GlStateCounters {
+	uint32_t Issued   = 0;
+	uint32_t Filtered = 0;
+};
+
+/// <summary>
+/// Tracks the program, vertex array, texture unit, indexed buffer and framebuffer
+/// bindings of the OpenGL context, so that binding something that is already bound
+/// never reaches the driver
+///
+/// All of our graphics classes route their binds through here. Anything that changes
+/// these bindings with raw GL calls (ex: ImGui) must call Invalidate afterwards, and
+/// anything that deletes a GL object should call the matching Forget function
+/// </summary>
+class GlStateCache {
+public:
+	// The number of texture units that we track, binds to higher units go straight to the driver
+	static const uint32_t MAX_TEXTURE_UNITS = 32;
+	// The number of uniform and storage buffer slots that we track, binds to higher slots go straight to the driver
+	static const uint32_t MAX_BUFFER_SLOTS = 16;
+
+	/// <summary>
+	/// Makes the given program current, if it is not already
+	/// </summary>
+	static void UseProgram(GLuint program);
+	/// <summary>
+	/// Binds the given vertex array, if it is not already bound
+	/// </summary>
+	static void BindVertexArray(GLuint vao);
+	/// <summary>
+	/// Binds a texture to the given texture unit, if it is not already bound there
+	/// </summary>
+	static void BindTextureUnit(uint32_t unit, GLuint texture);
+	/// <summary>
+	/// Binds an entire buffer to an indexed binding point (uniform or shader storage)
+	/// </summary>
+	/// <param name="target">The indexed target, ex GL_UNIFORM_BUFFER</param>
+	/// <param name="slot">The binding index within the target</param>
+	/// <param name="buffer">The buffer to bind</param>
+	static void BindBufferBase(GLenum target, uint32_t slot, GLuint buffer);
+	/// <summary>
+	/// Binds a range of a buffer to an indexed binding point (uniform or shader storage)
+	/// </summary>
+	/// <param name="target">The indexed target, ex GL_UNIFORM_BUFFER</param>
+	/// <param name="slot">The binding index within the target</param>
+	/// <param name="buffer">The buffer to bind</param>
+	/// <param name="offset">The offset of the range in bytes</param>
+	/// <param name="size">The size of the range in bytes</param>
+	static void BindBufferRange(GLenum target, uint32_t slot, GLuint buffer, GLintptr offset, GLsizeiptr size);
+	/// <summary>
+	/// Binds a framebuffer to GL_DRAW_FRAMEBUFFER, GL_READ_FRAMEBUFFER, or both with GL_FRAMEBUFFER
+	/// </summary>
+	static void BindFramebuffer(GLenum target, GLuint framebuffer);
+
+	/// <summary>
+	/// Gets the framebuffer that is currently bound for drawing, or UINT32_MAX if unknown
+	/// </summary>
+	static GLuint GetDrawFramebuffer();
+
+	/// <summary>
+	/// Should be called when a program is deleted, so a new program that re-uses the name is not filtered
+	/// </summary>
+	static void ForgetProgram(GLuint program);
+	/// <summary>
+	/// Should be called when a vertex array is deleted
+	/// </summary>
+	static void ForgetVertexArray(GLuint vao);
+	/// <summary>
+	/// Should be called when a texture is deleted
+	/// </summary>
+	static void ForgetTexture(GLuint texture);
+	/// <summary>
+	/// Should be called when a buffer is deleted
+	/// </summary>
+	static void ForgetBuffer(GLuint buffer);
+	/// <summary>
+	/// Should be called when a framebuffer is deleted
+	/// </summary>
+	static void ForgetFramebuffer(GLuint framebuffer);
+
+	/// <summary>
+	/// Marks all tracked state as unknown, so the next bind of each kind goes to the driver. Use
+	/// after code that binds things without going through the cache
+	/// </summary>
+	static void Invalidate();
+
+	/// <summary>
+	/// Stores the counters for the frame that just finished and resets them, then invalidates
+	/// the cache. Should be called once at the start of every frame
+	/// </summary>
+	static void BeginFrame();
+	/// <summary>
+	/// Gets the counters for a single kind of binding from the previous frame
+	/// </summary>
+	static const GlStateCounters& GetFrameCounters(GlStateType type);
+	/// <summary>
+	/// Gets the counters for all kinds of bindings from the previous frame
+	/// </summary>
+	static GlStateCounters GetFrameTotals();
+
+private:
+	// Marks a binding that we don't know the value of
+	static const GLuint UNKNOWN = UINT32_MAX;
+
+	struct BufferBinding {
+		GLuint     Buffer = UNKNOWN;
+		GLintptr   Offset = 0;
+		// 0 when the whole buffer is bound
+		GLsizeiptr Size = 0;
+	};
+
+	static const uint32_t NUM_STATE_TYPES = 5;
+
+	static GLuint _program;
+	static GLuint _vertexArray;
+	static GLuint _textures[MAX_TEXTURE_UNITS];
+	static BufferBinding _uniformBuffers[MAX_BUFFER_SLOTS];
+	static BufferBinding _storageBuffers[MAX_BUFFER_SLOTS];
+	static GLuint _drawFramebuffer;
+	static GLuint _readFramebuffer;
+
+	static GlStateCounters _counters[NUM_STATE_TYPES];
+	static GlStateCounters _lastFrameCounters[NUM_STATE_TYPES];
+
+	// Gets the tracked slots for an indexed buffer target, or nullptr if we don't track it
+	static BufferBinding* _GetBufferSlots(GLenum target);
+	// Records whether a state change was sent to the driver or filtered
+	static void _Count(GlStateType type, bool issued);
+};
@@ -0,0 +1,100 @@
+#include "Graphics/RenderQueue.h"
+#include <cstring>
+#include <utility>
+
+RenderQueue::RenderQueue() :
+	_items(),
+	_entries(),
+	_scratch()
+{ }
+
+void RenderQueue::Clear() {
+	_items.clear();
+	_entries.clear();
+}
+
+void RenderQueue::Push(uint64_t key, const DrawItem& item) {
+	_entries.push_back({ key, static_cast<uint32_t>(_items.size()) });
+	_items.push_back(item);
+}
+
+void RenderQueue::Sort() {
+	const size_t count = _entries.size();
+	if (count < 2) {
+		return;
+	}
+
+	// Build the histograms for all 8 digits in a single pass over the keys
+	uint32_t histograms[8][256];
+	memset(histograms, 0, sizeof(histograms));
+	for (const SortEntry& entry : _entries) {
+		for (int digit = 0; digit < 8; digit++) {
+			histograms[digit][(entry.Key >> (digit * 8)) & 0xFF]++;
+		}
+	}
+
+	_scratch.resize(count);
+	SortEntry* src = _entries.data();
+	SortEntry* dst = _scratch.data();
+
+	for (int digit = 0; digit < 8; digit++) {
+		uint32_t* histogram = histograms[digit];
+
+		// If every key has the same value for this digit, the pass would not change anything
+		if (histogram[(src[0].Key >> (digit * 8)) & 0xFF] == count) {
+			continue;
+		}
+
+		// Convert the counts into starting offsets
+		uint32_t offset = 0;
+		for (int bucket = 0; bucket < 256; bucket++) {
+			uint32_t bucketSize = histogram[bucket];
+			histogram[bucket] = offset;
+			offset += bucketSize;
+		}
+
+		// Scatter, this is stable so the previous passes are preserved
+		for (size_t ix = 0; ix < count; ix++) {
+			dst[histogram[(src[ix].Key >> (digit * 8)) & 0xFF]++] = src[ix];
+		}
+
+		std::swap(src, dst);
+	}
+
+	// If the sorted data ended up in the scratch buffer, swap the buffers
+	if (src != _entries.data()) {
+		_entries.swap(_scratch);
+	}
+}
+
+size_t RenderQueue::Size() const {
+	return _entries.size();
+}
+
+bool RenderQueue::IsEmpty() const {
+	return _entries.empty();
+}
+
+const RenderQueue::DrawItem& RenderQueue::operator[](size_t index) const {
+	return _items[_entries[index].Index];
+}
+
+uint64_t RenderQueue::GetKey(size_t index) const {
+	return _entries[index].Key;
+}
+
+uint64_t RenderQueue::MakeKey(uint32_t shader, uint32_t material, uint32_t vao, float depth) {
+	// For positive floats, the bit pattern sorts in the same order as the value,
+	// so we can keep the top 20 bits (below the sign bit) as our depth
+	uint32_t depthBits = 0;
+	if (depth > 0.0f) {
+		memcpy(&depthBits, &depth, sizeof(float));
+		depthBits = (depthBits >> 11) & 0xFFFFF;
+	}
+
+	return
+		(static_cast<uint64_t>(shader   & 0xFFF)  << 52) |
+		(static_cast<uint64_t>(material & 0xFFFF) << 36) |
+		(static_cast<uint64_t>(vao      & 0xFFFF) << 20) |
+		static_cast<uint64_t>(depthBits);
+}
@@ -0,0 +1,99 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class VertexArrayObject;
+class ShaderProgram;
+
+namespace Gameplay {
+	class Material;
+	class GameObject;
+}
+
+/// <summary>
+/// A per-frame list of draw records that can be sorted by a 64 bit key, so that
+/// draws sharing a shader, material and mesh end up next to each other and
+/// their state only needs to be bound once per bucket
+///
+/// Key layout, from most to least significant bits:
+///    [63..52] shader program handle (12 bits)
+///    [51..36] material sort ID      (16 bits)
+///    [35..20] VAO handle            (16 bits)
+///    [19..0 ] view depth            (20 bits, front to back)
+///
+/// Handles that overflow their field only weaken the grouping, the renderer still
+/// compares the actual objects when deciding whether state needs to change
+/// </summary>
+class RenderQueue {
+public:
+	/// <summary>
+	/// A single draw record, kept small since we shuffle these around every frame.
+	/// The pointers are non-owning, the render components keep them alive for the frame.
+	/// Material may be null for depth only draws that don't need any material state
+	/// </summary>
+	struct DrawItem {
+		ShaderProgram*        Shader;
+		Gameplay::Material*   Material;
+		VertexArrayObject*    Mesh;
+		Gameplay::GameObject* Object;
+	};
+
+	RenderQueue();
+	~RenderQueue() = default;
+
+	/// <summary>
+	/// Removes all draw records from the queue, keeping the underlying storage
+	/// </summary>
+	void Clear();
+
+	/// <summary>
+	/// Adds a new draw record to the queue
+	/// </summary>
+	/// <param name="key">The sort key for the record, see MakeKey</param>
+	/// <param name="item">The draw record to add</param>
+	void Push(uint64_t key, const DrawItem& item);
+
+	/// <summary>
+	/// Sorts the draw records by their keys, in ascending order. Uses an LSD radix sort
+	/// on 8 bit digits, skipping any digit that is the same across all keys
+	/// </summary>
+	void Sort();
+
+	/// <summary>
+	/// Gets the number of draw records in the queue
+	/// </summary>
+	size_t Size() const;
+	/// <summary>
+	/// Returns true if there are no draw records in the queue
+	/// </summary>
+	bool IsEmpty() const;
+
+	/// <summary>
+	/// Gets the draw record at the given position in sorted order (only valid after Sort)
+	/// </summary>
+	const DrawItem& operator[](size_t index) const;
+	/// <summary>
+	/// Gets the sort key at the given position in sorted order (only valid after Sort)
+	/// </summary>
+	uint64_t GetKey(size_t index) const;
+
+	/// <summary>
+	/// Packs the given state into a sort key
+	/// </summary>
+	/// <param name="shader">The OpenGL handle of the shader program</param>
+	/// <param name="material">The material's sort ID</param>
+	/// <param name="vao">The OpenGL handle of the vertex array</param>
+	/// <param name="depth">The distance from the camera, negative values are clamped to 0</param>
+	static uint64_t MakeKey(uint32_t shader, uint32_t material, uint32_t vao, float depth);
+
+protected:
+	struct SortEntry {
+		uint64_t Key;
+		uint32_t Index;
+	};
+
+	std::vector<DrawItem>  _items;
+	std::vector<SortEntry> _entries;
+	std::vector<SortEntry> _scratch;
+};
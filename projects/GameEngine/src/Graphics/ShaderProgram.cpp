@@ -1,22 +1,28 @@
 #include "ShaderProgram.h"
 #include "Logging.h"
+#include "Graphics/GlStateCache.h"
 #include <fstream>
 #include <sstream>
 #include <filesystem>
+#include <algorithm>
 
 #include "Utils/FileHelpers.h"
 #include "Utils/JsonGlmHelpers.h"
 
 ShaderProgram::ShaderProgram() : 
 	IGraphicsResource(),
-	IResource()
+	IResource(),
+	_instancedVariant(nullptr),
+	_instancedVariantResolved(false)
 {
 	_rendererId = glCreateProgram();
 }
 
 ShaderProgram::ShaderProgram(const std::unordered_map<ShaderPartType, std::string>& filePaths) :
 	IGraphicsResource(),
-	IResource()
+	IResource(),
+	_instancedVariant(nullptr),
+	_instancedVariantResolved(false)
 {
 	_rendererId = glCreateProgram();
 	for (auto& [type, path] : filePaths) {
@@ -27,6 +33,7 @@ ShaderProgram::ShaderProgram(const std::unordered_map<ShaderPartType, std::strin
 
 ShaderProgram::~ShaderProgram() {
 	if (_rendererId != 0) {
+		GlStateCache::ForgetProgram(_rendererId);
 		glDeleteProgram(_rendererId);
 		_rendererId = 0;
 	}
@@ -162,13 +169,13 @@ bool ShaderProgram::Link() {
 }
 
 void ShaderProgram::Bind() {
-	// Simply calls glUseProgram with our shader handle
-	glUseProgram(_rendererId);
+	// Calls glUseProgram with our shader handle, unless we're already in use
+	GlStateCache::UseProgram(_rendererId);
 }
 
 void ShaderProgram::Unbind() {
 	// We unbind a shader program by using the default program (0)
-	glUseProgram(0);
+	GlStateCache::UseProgram(0);
 }
 
 void ShaderProgram::SetUniformMatrix(int location, const glm::mat3* value, int count, bool transposed) {
@@ -535,6 +542,67 @@ GlResourceType ShaderProgram::GetResourceClass() const {
 	return GlResourceType::ShaderProgram;
 }
 
+std::string ShaderProgram::_GetStageSource(ShaderPartType type) const {
+	auto it = _fileSourceMap.find(type);
+	if (it == _fileSourceMap.end()) {
+		return "";
+	}
+	return it->second.IsFilePath ? FileHelpers::ReadResolveIncludes(it->second.Source) : it->second.Source;
+}
+
+ShaderProgram::Sptr ShaderProgram::CreateVariant(const std::vector<std::string>& defines, const std::vector<ShaderPartType>& stages) const {
+	// Build up the block of defines that we'll be injecting
+	std::string defineBlock;
+	for (const std::string& define : defines) {
+		defineBlock += "#define " + define + "\n";
+	}
+
+	ShaderProgram::Sptr result = std::make_shared<ShaderProgram>();
+	for (auto& [type, source] : _fileSourceMap) {
+		std::string code = _GetStageSource(type);
+
+		if (stages.empty() || std::find(stages.begin(), stages.end(), type) != stages.end()) {
+			// The #version directive must be the first thing in the shader, so we insert after that line
+			size_t versionPos = code.find("#version");
+			size_t insertPos = versionPos != std::string::npos ? code.find('\n', versionPos) : std::string::npos;
+			if (insertPos != std::string::npos) {
+				code.insert(insertPos + 1, defineBlock);
+			} else {
+				code.insert(0, defineBlock);
+			}
+		}
+
+		if (!result->LoadShaderPart(code.c_str(), type)) {
+			LOG_WARN("Failed to compile variant of shader \"{}\"", _debugName);
+			return nullptr;
+		}
+	}
+
+	if (!result->Link()) {
+		LOG_WARN("Failed to link variant of shader \"{}\"", _debugName);
+		return nullptr;
+	}
+
+	result->SetDebugName(_debugName + " - variant");
+	return result;
+}
+
+const ShaderProgram::Sptr& ShaderProgram::GetInstancedVariant() {
+	if (!_instancedVariantResolved) {
+		_instancedVariantResolved = true;
+
+		// Only shaders that have an instanced path (ex: via vs_common.glsl) can be instanced
+		std::string vertexSource = _GetStageSource(ShaderPartType::Vertex);
+		if (vertexSource.find("INSTANCED") != std::string::npos) {
+			_instancedVariant = CreateVariant({ "INSTANCED" }, { ShaderPartType::Vertex });
+			if (_instancedVariant != nullptr) {
+				_instancedVariant->SetDebugName(_debugName + " - instanced");
+			}
+		}
+	}
+	return _instancedVariant;
+}
+
 void ShaderProgram::RegisterVaryings(const char* const* names, int numVaryings, bool interleaved /*= true*/)
 {
 	glTransformFeedbackVaryings(_rendererId, numVaryings, names, interleaved ? GL_INTERLEAVED_ATTRIBS : GL_SEPARATE_ATTRIBS);
@@ -3,6 +3,7 @@
 #include <memory>
 #include <string>               // for std::string
 #include <unordered_map>        // for std::unordered_map
+#include <vector>               // for std::vector
 #include <GLM/glm.hpp>          // for our GLM types
 #include <GLM/gtc/type_ptr.hpp> // for glm::value_ptr
 #include <Logging.h>            // for the logging functions
@@ -109,6 +110,23 @@ public:
 
 	const std::unordered_map<std::string, UniformInfo>& GetUniforms() const { return _uniforms; }
 
+	/// <summary>
+	/// Compiles and links a new program from the same sources as this one, with the given
+	/// preprocessor symbols defined in every stage (injected right after the #version line)
+	/// </summary>
+	/// <param name="defines">The symbols to define (ex: "INSTANCED" or "SOME_VALUE 4")</param>
+	/// <param name="stages">The stages to inject the defines into, or empty for every stage</param>
+	/// <returns>The new program, or nullptr if the variant failed to compile</returns>
+	Sptr CreateVariant(const std::vector<std::string>& defines, const std::vector<ShaderPartType>& stages = {}) const;
+
+	/// <summary>
+	/// Gets a variant of this program that reads the model and normal matrices from per-instance
+	/// vertex attributes instead of the instance UBO (see vs_common.glsl). The variant is created
+	/// the first time this is called
+	/// </summary>
+	/// <returns>The instanced variant, or nullptr if the vertex shader has no INSTANCED path</returns>
+	const Sptr& GetInstancedVariant();
+
 	// Inherited from IGraphicsResource
 
 	virtual GlResourceType GetResourceClass() const override;
@@ -198,6 +216,15 @@ protected:
 	};
 	std::unordered_map<ShaderPartType, ShaderSource> _fileSourceMap;
 
+	// Cached result of GetInstancedVariant
+	Sptr _instancedVariant;
+	bool _instancedVariantResolved;
+
+	/// <summary>
+	/// Gets the full source code for one of the stages that has been loaded into this program
+	/// </summary>
+	std::string _GetStageSource(ShaderPartType type) const;
+
 	/// <summary>
 	/// Performs program introspection, where we examine the uniforms that
 	/// the program contains
@@ -1,11 +1,13 @@
 #include "ITexture.h"
+#include "Graphics/GlStateCache.h"
 
 ITexture::Limits ITexture::__limits = ITexture::Limits();
 bool ITexture::__isStaticInit = false;
 
 ITexture::ITexture(TextureType type) :
 	IGraphicsResource(),
-	_type(type)
+	_type(type),
+	_loadToken(std::make_shared<bool>(true))
 {
 	__StaticInit();
 	_Recreate();
@@ -21,6 +23,7 @@ void ITexture::_Recreate()
 
 ITexture::~ITexture() {
 	if (glIsTexture(_rendererId)) {
+		GlStateCache::ForgetTexture(_rendererId);
 		glDeleteTextures(1, &_rendererId);
 		_rendererId = 0;
 	}
@@ -29,12 +32,12 @@ ITexture::~ITexture() {
 void ITexture::Bind(int slot) {
 	if (_rendererId != 0) {
 		// Instead of glActiveTexture + glBindTexture, we can one line it now :D
-		glBindTextureUnit(slot, _rendererId); 
+		GlStateCache::BindTextureUnit(slot, _rendererId);
 	}
 }
 
 void ITexture::Unbind(int slot) {
-	glBindTextureUnit(slot, 0);
+	GlStateCache::BindTextureUnit(slot, 0);
 }
 
 void ITexture::Clear(const glm::vec4& color) {
@@ -61,6 +61,7 @@ protected:
 	virtual void _Recreate();
 
 	TextureType _type; // The type for this texture, mainly used for debugging
+	std::shared_ptr<void> _loadToken; // Stands in for the texture in AssetPipeline loads, so they get dropped if the texture is destroyed first
 
 // STATIC SECTION
 private:
@@ -4,6 +4,25 @@
 #include "GLM/glm.hpp"
 #include "Utils/JsonGlmHelpers.h"
 #include "Utils/Base64.h"
+#include "Utils/AsyncLoader.h"
+#include "Utils/AssetPipeline.h"
+#include "Graphics/GlStateCache.h"
+
+namespace {
+	// Holds an image decoded by STBI, the pixels are freed along with it
+	struct DecodedImage {
+		uint8_t* Data = nullptr;
+		int Width = 0;
+		int Height = 0;
+		int NumChannels = 0;
+
+		~DecodedImage() {
+			if (Data != nullptr) {
+				stbi_image_free(Data);
+			}
+		}
+	};
+}
 
 /// <summary>
 /// Get the number of mipmap levels required for a texture of the given size
@@ -150,58 +169,71 @@ void Texture2D::_LoadDataFromFile() {
 	LOG_ASSERT(_description.Width + _description.Height == 0, "This texture has already been configured with a size! Cannot re-allocate memory!");
 
 	if (!_description.Filename.empty()) {
-		// Variables that will store properties about our image
-		int width, height, numChannels;
 		const int targetChannels = GetTexelComponentCount(_description.FormatHint);
 
-		// Use STBI to load the image
+		// The flip flag is global, so we set it before handing off to a worker
 		stbi_set_flip_vertically_on_load(true);
-		uint8_t* data = stbi_load(_description.Filename.c_str(), &width, &height, &numChannels, targetChannels);
 
-		// If we could not load any data, warn and return null
-		if (data == nullptr) {
-			LOG_WARN("STBI Failed to load image from \"{}\"", _description.Filename);
-			return ;
+		std::shared_ptr<DecodedImage> image = std::make_shared<DecodedImage>();
+		auto decode = [image, filename = _description.Filename, targetChannels]() {
+			image->Data = stbi_load(filename.c_str(), &image->Width, &image->Height, &image->NumChannels, targetChannels);
+			// NumChannels will store the number of channels in the image on disk, if we overrode that we should use the override value
+			if (targetChannels != 0) {
+				image->NumChannels = targetChannels;
+			}
+		};
+
+		// Inside a batch the decode runs alongside the other files, and we upload whenever it's ready
+		if (AssetPipeline::IsBatching()) {
+			AssetPipeline::Enqueue(_loadToken, decode, [this, image]() {
+				_UploadImage(image->Data, image->Width, image->Height, image->NumChannels);
+			});
+		} else {
+			AsyncLoader::RunInBackground(decode);
+			_UploadImage(image->Data, image->Width, image->Height, image->NumChannels);
 		}
+	}
+	
+	SetDebugName(_description.Filename);
+}
 
-		// We should estimate a good format for our data
-
-		// numChannels will store the number of channels in the image on disk, if we overrode that we should use the override value
-		if (targetChannels != 0)
-			numChannels = targetChannels;
-
-		// We'll determine a recommended format for the image based on number of channels
-		// We hinted that we wanted a certain number of channels, but we're not guaranteed
-		// that all those channels exist (ex: loading an RGB image but requesting RGBA)
-		InternalFormat internal_format = GetInternalFormatForChannels8(numChannels);
-		PixelFormat    image_format = GetPixelFormatForChannels(numChannels);
+void Texture2D::_UploadImage(uint8_t* data, int width, int height, int numChannels) {
+	// If we could not load any data, warn and return null
+	if (data == nullptr) {
+		LOG_WARN("STBI Failed to load image from \"{}\"", _description.Filename);
+		return;
+	}
 
-		// This is one of those poorly documented things in OpenGL
-		if ((numChannels * width) % 4 != 0) {
-			LOG_WARN("The alignment of a horizontal line is not a multiple of 4, this will require a call to glPixelStorei(GL_PACK_ALIGNMENT)");
-		}
+	// We'll determine a recommended format for the image based on number of channels
+	// We hinted that we wanted a certain number of channels, but we're not guaranteed
+	// that all those channels exist (ex: loading an RGB image but requesting RGBA)
+	InternalFormat internal_format = GetInternalFormatForChannels8(numChannels);
+	PixelFormat    image_format = GetPixelFormatForChannels(numChannels);
 
-		// Update our description to match what we loaded
-		_description.Format = internal_format;
-		_description.Width = width;
-		_description.Height = height;
+	// This is one of those poorly documented things in OpenGL
+	if ((numChannels * width) % 4 != 0) {
+		LOG_WARN("The alignment of a horizontal line is not a multiple of 4, this will require a call to glPixelStorei(GL_PACK_ALIGNMENT)");
+	}
 
-		// Allocates our memory
-		_SetTextureParams();
+	// Update our description to match what we loaded
+	_description.Format = internal_format;
+	_description.Width = width;
+	_description.Height = height;
 
-		// Upload data to our texture
-		LoadData(width, height, image_format, PixelType::UByte, data);
+	// Allocates our memory
+	_SetTextureParams();
 
-		// We now have data in the image, we can clear the STBI data
-		stbi_image_free(data);
-	}
-	
-	SetDebugName(_description.Filename);
+	// Upload data to our texture
+	void* pixels = AssetPipeline::BeginPixelUpload(data, (size_t)width * height * numChannels);
+	LoadData(width, height, image_format, PixelType::UByte, pixels);
+	AssetPipeline::EndPixelUpload();
 }
 
 void Texture2D::_SetTextureParams() {
 	// If we have a multisampled texture, and the current type is 2D, change it to 2D multisampled
 	if (_description.MultisampleCount > 1 && _type == TextureType::_2D) {
+		// The new texture may get the same name, so the cache can't think it's still bound
+		GlStateCache::ForgetTexture(_rendererId);
 		glDeleteTextures(1, &_rendererId);
 		_type = TextureType::_2DMultisample;
 		glCreateTextures(*_type, 1, &_rendererId);
@@ -154,6 +154,14 @@ protected:
 	/// </summary>
 	void _LoadDataFromFile();
 	/// <summary>
+	/// Allocates storage for and uploads an image that was decoded by STBI
+	/// </summary>
+	/// <param name="data">The decoded pixels, or nullptr if the image failed to load</param>
+	/// <param name="width">The width of the image in pixels</param>
+	/// <param name="height">The height of the image in pixels</param>
+	/// <param name="numChannels">The number of channels in the pixel data</param>
+	void _UploadImage(uint8_t* data, int width, int height, int numChannels);
+	/// <summary>
 	/// Allocates our texture's memory and sets sampling / filtering parameters
 	/// </summary>
 	void _SetTextureParams();
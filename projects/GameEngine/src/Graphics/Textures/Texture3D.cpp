@@ -7,6 +7,110 @@
 #include <iostream>
 #include <fstream>
 #include <filesystem>
+#include "Utils/AssetPipeline.h"
+
+namespace {
+	// A 3D LUT read from a .cube file, before it has been uploaded
+	struct CubeLutData {
+		bool                     IsOpen = false;
+		uint32_t                 Size = 0;
+		std::vector<glm::u8vec3> Texels;
+		std::string              Title;
+	};
+
+	// Parses a .cube file, does not touch the GL context so it can be run on any thread
+	void ParseCubeFile(const std::string& filename, CubeLutData& result) {
+		std::ifstream inFile(filename);
+		result.IsOpen = inFile.is_open();
+		if (!result.IsOpen) {
+			return;
+		}
+
+		uint32_t lutSize{ 0 };
+		uint32_t ix{ 0 };
+		glm::vec3 rgb { 0, 0, 0 };
+
+		std::string line;
+		// Iterate as long as we have lines from the file
+		while (std::getline(inFile, line)) {
+
+			// Trim whitespace from start and end of the line
+			StringTools::Trim(line);
+
+			// Skip empty lines
+			if (line.empty()) {
+				continue;
+			}
+
+			// Skip comments
+			else if (line[0] == '#') {
+				continue;
+			}
+
+			// Handle sizing the LUT
+			else if (line.find("LUT_3D_SIZE") != std::string::npos) {
+
+				// Skip over the LUT_3D_SIZE text and read in the value
+				std::stringstream lReader(line.substr(12));
+				lReader >> lutSize;
+
+				// If the size we read is non-zero, allocate our data!
+				if (lutSize > 0) {
+					// Allocate data to store texels in, replacing anything we had already
+					result.Size = lutSize;
+					result.Texels.assign((size_t)lutSize * lutSize * lutSize, glm::u8vec3(0));
+					ix = 0;
+				}
+			}
+
+			// We'll grab the title for our debug name, nice lil use of it
+			else if (line.find("TITLE") != std::string::npos) {
+
+				// Skip over the TITLE token and the space after it
+				std::string name = line.substr(6);
+
+				// Trim any excess whitespace
+				StringTools::Trim(name);
+
+				// We'll store this for the debug name
+				result.Title = name;
+			}
+
+			else if (line.find("DOMAIN_MIN") != std::string::npos)
+			{ /* ignore for now */ }
+
+			else if (line.find("DOMAIN_MAX") != std::string::npos)
+			{ /* ignore for now */ }
+
+			else if (line.find("LUT_1D_SIZE") != std::string::npos)
+			{ /* ignore for now */ }
+
+			// Reading data lines
+			else if (!line.empty() && !result.Texels.empty()) {
+
+				// Make sure we don't case a write access violation
+				if (ix >= result.Texels.size()) {
+					LOG_ASSERT(false, "Attempting to write outside the bounds of the LUT");
+					break;
+				}
+
+				// Read RGB from the line
+				std::stringstream lReader(line);
+				lReader >> rgb.r >> rgb.g >> rgb.b;
+
+				rgb = glm::clamp(rgb, glm::vec3(0), glm::vec3(1));
+
+				// Store in the array, converting to the correct scale for bytes
+				result.Texels[ix].r = static_cast<uint8_t>(rgb.r * 255);
+				result.Texels[ix].g = static_cast<uint8_t>(rgb.g * 255);
+				result.Texels[ix].b = static_cast<uint8_t>(rgb.b * 255);
+
+				// Move to the next texel
+				ix++;
+			}
+		} 
+	}
+}
 
 inline int CalcRequiredMipLevels(int width, int height, int depth) {
 	return (1 + floor(log2(std::max(width, std::max(height, depth)))));
@@ -149,105 +253,27 @@ void Texture3D::_LoadDataFromFile()
 
 void Texture3D::_LoadCubeFile()
 {
-	std::ifstream inFile(_description.Filename);
-
-	if (!inFile.is_open()) {
-		LOG_WARN("Failed to open file .cube file: {}", _description.Filename);
-		return;
-	}
-
-	glm::u8vec3* textureData = nullptr;
-	uint32_t lutSize{ 0 };
-	uint32_t ix{ 0 };
-	glm::vec3 rgb { 0, 0, 0 };
-
-	std::string line;
-	// Iterate as long as we have lines from the file
-	while (std::getline(inFile, line)) {
-
-		// Trim whitespace from start and end of the line
-		StringTools::Trim(line);
-
-		// Skip empty lines
-		if (line.empty()) {
-			continue;
-		}
-
-		// Skip comments
-		else if (line[0] == '#') {
-			continue;
+	std::shared_ptr<CubeLutData> lut = std::make_shared<CubeLutData>();
+	auto decode = [lut, filename = _description.Filename]() {
+		ParseCubeFile(filename, *lut);
+	};
+	auto upload = [this, lut]() {
+		if (!lut->IsOpen) {
+			LOG_WARN("Failed to open file .cube file: {}", _description.Filename);
+			return;
 		}
-
-		// Handle sizing the LUT
-		else if (line.find("LUT_3D_SIZE") != std::string::npos) {
-
-			// Skip over the LUT_3D_SIZE text and read in the value
-			std::stringstream lReader(line.substr(12));
-			lReader >> lutSize;
-
-			// Update the description's size
-			_description.Width = _description.Height = _description.Depth = lutSize;
-
-			// If the size we read is non-zero, allocate our data!
-			if (lutSize > 0) {
-				// If we had data already, delete it
-				if (textureData != nullptr) {
-					delete[] textureData;
-				} 
-
-				// Allocate data to store texels in
-				textureData = new glm::u8vec3[(size_t)lutSize * lutSize * lutSize];
-				ix = 0;
-			}
+		if (lut->Texels.empty()) {
+			LOG_WARN("Failed to load cube file: \"{}\"", _description.Filename);
+			return;
 		}
 
 		// We'll grab the title for our debug name, nice lil use of it
-		else if (line.find("TITLE") != std::string::npos) {
-
-			// Skip over the TITLE token and the space after it
-			std::string name = line.substr(6);
-
-			// Trim any excess whitespace
-			StringTools::Trim(name);
-
-			// We'll store this in the debug name
-			SetDebugName(name);
+		if (!lut->Title.empty()) {
+			SetDebugName(lut->Title);
 		}
 
-		else if (line.find("DOMAIN_MIN") != std::string::npos)
-		{ /* ignore for now */ }
-
-		else if (line.find("DOMAIN_MAX") != std::string::npos)
-		{ /* ignore for now */ }
-
-		else if (line.find("LUT_1D_SIZE") != std::string::npos)
-		{ /* ignore for now */ }
-
-		// Reading data lines
-		else if (!line.empty() && textureData != nullptr) {
-
-			// Make sure we don't case a write access violation
-			if (ix >= (lutSize * lutSize * lutSize) && lutSize > 0) {
-				LOG_ASSERT(false, "Attempting to write outside the bounds of the LUT");
-			}
-
-			// Read RGB from the line
-			std::stringstream lReader(line);
-			lReader >> rgb.r >> rgb.g >> rgb.b;
-
-			rgb = glm::clamp(rgb, glm::vec3(0), glm::vec3(1));
-
-			// Store in the array, converting to the correct scale for bytes
-			textureData[ix].r = static_cast<uint8_t>(rgb.r * 255);
-			textureData[ix].g = static_cast<uint8_t>(rgb.g * 255);
-			textureData[ix].b = static_cast<uint8_t>(rgb.b * 255);
-
-			// Move to the next texel
-			ix++;
-		}
-	} 
-
-	if (textureData != nullptr) {
+		// Update the description's size
+		_description.Width = _description.Height = _description.Depth = lut->Size;
 		// Set the pixel format
 		_description.Format = InternalFormat::RGB8;
 		// We need to clamp to edge for LUTS
@@ -256,13 +282,17 @@ void Texture3D::_LoadCubeFile()
 		// Allocate data and configure params
 		_SetTextureParams();
 		// Load data
-		LoadData(lutSize, lutSize, lutSize, PixelFormat::RGB, PixelType::UByte, textureData);
+		void* pixels = AssetPipeline::BeginPixelUpload(lut->Texels.data(), lut->Texels.size() * sizeof(glm::u8vec3));
+		LoadData(lut->Size, lut->Size, lut->Size, PixelFormat::RGB, PixelType::UByte, pixels);
+		AssetPipeline::EndPixelUpload();
+	};
 
-		// Clean up after ourselves
-		delete[] textureData;
-	}
-	else {
-		LOG_WARN("Failed to load cube file: \"{}\"", _description.Filename);
+	// Inside a batch the LUT gets parsed alongside the other files, and uploaded whenever it's ready
+	if (AssetPipeline::IsBatching()) {
+		AssetPipeline::Enqueue(_loadToken, decode, upload);
+	} else {
+		decode();
+		upload();
 	}
 }
 
@@ -1,7 +1,83 @@
 #include "TextureCube.h"
+#include <array>
 #include <filesystem>
 #include "stb_image.h"
 #include "Utils/JsonGlmHelpers.h"
+#include "Utils/AssetPipeline.h"
+#include "Utils/JobSystem.h"
+
+namespace {
+	// A single face image decoded by STBI, the pixels are freed along with it
+	struct DecodedFace {
+		uint8_t* Data = nullptr;
+		int Width = 0;
+		int Height = 0;
+		int NumChannels = 0;
+
+		~DecodedFace() {
+			if (Data != nullptr) {
+				stbi_image_free(Data);
+			}
+		}
+	};
+
+	// All 6 faces of a cube map, back to back in memory, before they have been uploaded
+	struct CubeFaceData {
+		std::vector<uint8_t> Data;
+		int Size = 0;
+		int NumChannels = 0;
+	};
+
+	// Decodes the face images and packs them together, does not touch the GL context so it can be run on any thread
+	void DecodeCubeFaces(const std::array<std::string, 6>& filenames, CubeFaceData& result) {
+		// Every face is its own file, so they can all be decoded at once
+		DecodedFace faces[6];
+		JobSystem::ParallelFor(6, 1, [&](uint32_t start, uint32_t end) {
+			for (uint32_t ix = start; ix < end; ix++) {
+				faces[ix].Data = stbi_load(filenames[ix].c_str(), &faces[ix].Width, &faces[ix].Height, &faces[ix].NumChannels, 0);
+			}
+		});
+
+		// The size of a single face's texture, in bytes
+		size_t textureDataSize = 0;
+
+		for (int ix = 0; ix < 6; ix++) {
+			const DecodedFace& face = faces[ix];
+
+			// If we could not load any data, warn and return null
+			if (face.Data == nullptr) {
+				LOG_ERROR("STBI Failed to load image from \"{}\"", filenames[ix]);
+				result.Data.clear();
+				return;
+			}
+			// If the texture is not square, warn and abort
+			if (face.Width != face.Height) {
+				LOG_ERROR("Image loaded from \"{}\" was not square", filenames[ix]);
+				result.Data.clear();
+				return;
+			}
+			// If this is the first texture we loaded, it decides the size and format of the cube
+			if (ix == 0) {
+				result.Size = face.Width;
+				result.NumChannels = face.NumChannels;
+
+				// Determine how many bytes we'll need to store a single face worth of data
+				textureDataSize = (size_t)face.Width * face.Height * face.NumChannels;
+				result.Data.resize(textureDataSize * 6);
+			}
+			// If this is NOT the first image, and it does not match previous images, abort
+			else if (face.Width != result.Size || face.NumChannels != result.NumChannels) {
+				LOG_WARN("Image \"{}\" did not match size or format of texture cube", filenames[ix]);
+				result.Data.clear();
+				return;
+			}
+
+			// Copy the data we loaded into the corresponding location in the data store
+			memcpy(result.Data.data() + textureDataSize * ix, face.Data, textureDataSize);
+		}
+	}
+}
+
 
 TextureCube::TextureCube(const std::string& baseFilename) :
 	ITexture(TextureType::Cubemap),
@@ -100,81 +176,54 @@ void TextureCube::_LoadFromDescription()
 
 void TextureCube::_LoadImages(const std::unordered_map<CubeMapFace, std::string>& faceFilenames)
 {
-	// Will store all of our texture data, back to back in memory
-	uint8_t* datastore = nullptr;
-	// The size of a single face's texture, in bytes
-	size_t textureDataSize = 0;
+	std::array<std::string, 6> filenames;
+	for (int ix = 0; ix < 6; ix++) {
+		filenames[ix] = faceFilenames.at((CubeMapFace)ix);
+	}
 
-	// The number of channels that we're expecting
-	int numChannels = 0;
+	// Use STBI to load the images, the flip flag is global so we set it before handing off to any workers
+	stbi_set_flip_vertically_on_load(true);
 
-	// Load all 6 faces
-	for (int ix = 0; ix < 6; ix++) {
-		CubeMapFace face = (CubeMapFace)ix;
-		
-		const std::string& filename = _description.FaceFileNames[face];
-		int fileWidth, fileHeight, fileNumChannels;
-
-		// Use STBI to load the image
-		stbi_set_flip_vertically_on_load(true);
-		uint8_t* data = stbi_load(filename.c_str(), &fileWidth, &fileHeight, &fileNumChannels, 0);
-
-		// If we could not load any data, warn and return null
-		if (data == nullptr) {
-			if (data != nullptr) { delete[] datastore; }
-			LOG_ERROR("STBI Failed to load image from \"{}\"", filename);
+	std::shared_ptr<CubeFaceData> faces = std::make_shared<CubeFaceData>();
+	auto decode = [faces, filenames]() {
+		DecodeCubeFaces(filenames, *faces);
+	};
+	auto upload = [this, faces]() {
+		if (faces->Data.empty()) {
 			return;
 		}
-		// If the texture is not square, warn and abort
-		if (fileWidth != fileHeight) {
-			if (data != nullptr) { delete[] datastore; }
-			LOG_ERROR("Image loaded from \"{}\" was not square", filename);
-			stbi_image_free(data);
-			return;
-		}
-		// If the dataStore is empty, this is the first texture we loaded
-		if (datastore == nullptr) {
-			// Store the size and number of channels
-			_description.Size = fileWidth;
-			numChannels = fileNumChannels;
-
-			// Get the format and pixel format for the number of channels
-			_description.Format = GetInternalFormatForChannels8(numChannels);
-			_description.FormatHint = GetPixelFormatForChannels(numChannels);
-
-			// Determine how many bytes we'll need to store a single face worth of data
-			textureDataSize = ((size_t)_description.Size * _description.Size * GetTexelSize(_description.FormatHint, PixelType::Byte));
-
-			// This is one of those poorly documented things in OpenGL
-			if ((GetTexelSize(_description.FormatHint, PixelType::Byte) * _description.Size) % 4 != 0) {
-				LOG_WARN("The alignment of a horizontal line is not a multiple of 4, this will require a call to glPixelStorei(GL_PACK_ALIGNMENT)");
-			}
 
-			// Allocate the data store for our image data
-			datastore = new uint8_t[textureDataSize * 6];
-		}
-		// If this is NOT the first image, and it does not match previous images, abort
-		else if (fileWidth != _description.Size || fileNumChannels != numChannels) {
-			delete[] datastore;
-			LOG_WARN("Image \"{}\" did not match size or format of texture cube", filename);
-			stbi_image_free(data);
-			return;
+		// Store the size and number of channels
+		_description.Size = faces->Size;
+
+		// Get the format and pixel format for the number of channels
+		_description.Format = GetInternalFormatForChannels8(faces->NumChannels);
+		_description.FormatHint = GetPixelFormatForChannels(faces->NumChannels);
+
+		// This is one of those poorly documented things in OpenGL
+		if ((GetTexelSize(_description.FormatHint, PixelType::Byte) * _description.Size) % 4 != 0) {
+			LOG_WARN("The alignment of a horizontal line is not a multiple of 4, this will require a call to glPixelStorei(GL_PACK_ALIGNMENT)");
 		}
 
-		// Copy the data we loaded into the corresponding location in the data store
-		memcpy(datastore + textureDataSize * ix, data, textureDataSize);
-		stbi_image_free(data);
-	}
+		// Allocate memory and set up initial parameters
+		_SetTextureParams();
 
-	// Allocate memory and set up initial parameters
-	_SetTextureParams();
+		// Set our pixel alignment to a single byte so we don't get banding
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
 
-	// Set our pixel alignment to a single byte so we don't get banding
-	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		// Upload our data to our image (note that the custom enum tools let us convert to base type [GLenum] with the * operator)
+		void* pixels = AssetPipeline::BeginPixelUpload(faces->Data.data(), faces->Data.size());
+		glTextureSubImage3D(_rendererId, 0, 0, 0, 0, _description.Size, _description.Size, 6, *_description.FormatHint, *PixelType::UByte, pixels);
+		AssetPipeline::EndPixelUpload();
+	};
 
-	// Upload our data to our image (note that the custom enum tools let us convert to base type [GLenum] with the * operator)
-	glTextureSubImage3D(_rendererId, 0, 0, 0, 0, _description.Size, _description.Size, 6, *_description.FormatHint, *PixelType::UByte, datastore);
-	delete[] datastore;
+	// Inside a batch the faces get decoded alongside the other files, and uploaded whenever they're ready
+	if (AssetPipeline::IsBatching()) {
+		AssetPipeline::Enqueue(_loadToken, decode, upload);
+	} else {
+		decode();
+		upload();
+	}
 }
 
 void TextureCube::_SetTextureParams(){
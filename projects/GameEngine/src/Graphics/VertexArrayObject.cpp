@@ -2,6 +2,7 @@
 #include "Buffers/IndexBuffer.h"
 #include "Buffers/VertexBuffer.h"
 #include "Logging.h"
+#include "Graphics/GlStateCache.h"
 
 VertexArrayObject::VertexArrayObject() :
 	_indexBuffer(nullptr),
@@ -16,6 +17,7 @@ VertexArrayObject::VertexArrayObject() :
 VertexArrayObject::~VertexArrayObject()
 {
 	if (_handle != 0) {
+		GlStateCache::ForgetVertexArray(_handle);
 		glDeleteVertexArrays(1, &_handle);
 		_handle = 0;
 	}
@@ -24,16 +26,15 @@ VertexArrayObject::~VertexArrayObject()
 void VertexArrayObject::SetIndexBuffer(const IndexBuffer::Sptr& ibo) {
 	// TODO: What if we already have a buffer? should we delete it? who owns the buffer?
 	_indexBuffer = ibo;
-	Bind();
+	// The element buffer is VAO state, so we can attach it without binding anything
 	if (_indexBuffer != nullptr) {
-		_indexBuffer->Bind();
+		glVertexArrayElementBuffer(_handle, _indexBuffer->GetHandle());
 		_elementCount = _indexBuffer->GetElementCount();
 	}
 	else {
-		IndexBuffer::Unbind();
+		glVertexArrayElementBuffer(_handle, 0);
 		_elementCount = _vertexCount;
 	}
-	Unbind();
 }
 
 VertexArrayObject::VertexBufferBinding* VertexArrayObject::AddVertexBuffer(const VertexBuffer::Sptr& buffer, const std::vector<BufferAttribute>& attributes, bool instanced) {
@@ -43,7 +44,8 @@ VertexArrayObject::VertexBufferBinding* VertexArrayObject::AddVertexBuffer(const
 			_elementCount = _vertexCount;
 		}
 	} 
-	else if (buffer->GetElementCount() != _vertexCount) {
+	// Instanced buffers have one element per instance, so they don't need to match
+	else if (!instanced && buffer->GetElementCount() != _vertexCount) {
 		LOG_WARN("Buffer element count does not match vertex count of this VAO!!!");
 	}
 
@@ -54,17 +56,7 @@ VertexArrayObject::VertexBufferBinding* VertexArrayObject::AddVertexBuffer(const
 	_vertexBuffers.push_back(binding);
 
 
-	Bind();
-	buffer->Bind();
-	for (const BufferAttribute& attrib : attributes) {
-		glEnableVertexArrayAttrib(_handle, attrib.Slot);
-		glVertexAttribPointer(attrib.Slot, attrib.Size, (GLenum)attrib.Type, attrib.Normalized, attrib.Stride,
-							  (void*)attrib.Offset);
-
-		// Here is where we select whether the attribute is instanced or not
-		glVertexAttribDivisor(attrib.Slot, instanced ? 1 : 0);
-	}
-	Unbind();
+	_AttachBuffer(binding);
 
 	return binding;
 }
@@ -84,21 +76,23 @@ void VertexArrayObject::ReplaceVertexBuffer(VertexBufferBinding* binding, const
 		// Update the buffer the binding is pointing to
 		binding->Buffer = buffer;
 
-		// Re-bind the buffer and attributes
-		Bind();
-		buffer->Bind();
-		for (const BufferAttribute& attrib : binding->Attributes) {
-			glEnableVertexArrayAttrib(_handle, attrib.Slot);
-			glVertexAttribPointer(attrib.Slot, attrib.Size, (GLenum)attrib.Type, attrib.Normalized, attrib.Stride,
-				(void*)attrib.Offset);
-
-			// Here is where we select whether the attribute is instanced or not
-			glVertexAttribDivisor(attrib.Slot, binding->Instanced ? 1 : 0);
-		}
-		Unbind();
+		// Re-attach the buffer and attributes
+		_AttachBuffer(binding);
 	}
+}
 
+void VertexArrayObject::_AttachBuffer(const VertexBufferBinding* binding) {
+	// Each attribute gets its own buffer binding point (matching its slot), which mirrors what
+	// glVertexAttribPointer does, but lets us set it all up without binding the VAO or buffer
+	for (const BufferAttribute& attrib : binding->Attributes) {
+		glEnableVertexArrayAttrib(_handle, attrib.Slot);
+		glVertexArrayVertexBuffer(_handle, attrib.Slot, binding->Buffer->GetHandle(), attrib.Offset, attrib.Stride);
+		glVertexArrayAttribFormat(_handle, attrib.Slot, attrib.Size, (GLenum)attrib.Type, attrib.Normalized, 0);
+		glVertexArrayAttribBinding(_handle, attrib.Slot, attrib.Slot);
 
+		// Here is where we select whether the attribute is instanced or not
+		glVertexArrayBindingDivisor(_handle, attrib.Slot, binding->Instanced ? 1 : 0);
+	}
 }
 
 void VertexArrayObject::Draw(DrawMode mode) {
@@ -110,7 +104,6 @@ void VertexArrayObject::Draw(DrawMode mode) {
 		uint32_t elements = _elementCount == 0 ? _indexBuffer->GetElementCount() : _elementCount;
 		glDrawElements((GLenum)mode, elements, (GLenum)_indexBuffer->GetElementType(), nullptr);
 	}
-	Unbind();
 }
 
 void VertexArrayObject::DrawInstanced(uint32_t instanceCount, DrawMode mode /*= DrawMode::TriangleList*/)
@@ -124,16 +117,27 @@ void VertexArrayObject::DrawInstanced(uint32_t instanceCount, DrawMode mode /*=
 		uint32_t elements = _elementCount == 0 ? _indexBuffer->GetElementCount() : _elementCount;
 		glDrawElementsInstanced((GLenum)mode, elements, (GLenum)_indexBuffer->GetElementType(), nullptr, instanceCount);
 	}
-	Unbind();
-	
+}
+
+void VertexArrayObject::DrawInstanced(uint32_t instanceCount, uint32_t baseInstance, DrawMode mode /*= DrawMode::TriangleList*/)
+{
+	Bind();
+	if (_indexBuffer == nullptr) {
+		uint32_t elements = _elementCount == 0 ? _vertexBuffers[0]->Buffer->GetElementCount() : _elementCount;
+		glDrawArraysInstancedBaseInstance((GLenum)mode, 0, elements, instanceCount, baseInstance);
+	}
+	else {
+		uint32_t elements = _elementCount == 0 ? _indexBuffer->GetElementCount() : _elementCount;
+		glDrawElementsInstancedBaseInstance((GLenum)mode, elements, (GLenum)_indexBuffer->GetElementType(), nullptr, instanceCount, baseInstance);
+	}
 }
 
 void VertexArrayObject::Bind() {
-	glBindVertexArray(_handle);
+	GlStateCache::BindVertexArray(_handle);
 }
 
 void VertexArrayObject::Unbind() {
-	glBindVertexArray(0);
+	GlStateCache::BindVertexArray(0);
 }
 
 void VertexArrayObject::SetVDecl(const VertexDeclaration& vDecl) {
@@ -163,6 +167,15 @@ VertexArrayObject::VertexBufferBinding* VertexArrayObject::GetBufferBinding(Attr
 	return nullptr;
 }
 
+bool VertexArrayObject::HasVertexBuffer(const VertexBuffer::Sptr& buffer) const {
+	for (const VertexBufferBinding* binding : _vertexBuffers) {
+		if (binding->Buffer == buffer) {
+			return true;
+		}
+	}
+	return false;
+}
+
 VertexArrayObject::Sptr VertexArrayObject::Clone() const
 {
 	VertexArrayObject::Sptr result = Create();
@@ -177,6 +190,7 @@ VertexArrayObject::Sptr VertexArrayObject::Clone() const
 	}
 
 	result->SetVDecl(_vDecl);
+	result->SetBounds(_bounds);
 
 	return result;
 }
@@ -9,6 +9,7 @@
 #include "Graphics/Buffers/IndexBuffer.h"
 #include "Graphics/GlEnums.h"
 #include "Graphics/IGraphicsResource.h"
+#include "Graphics/Bounds.h"
 
 /// <summary>
 /// This structure will represent the parameters passed to the glVertexAttribPointer commands
@@ -120,6 +121,12 @@ public:
 	/// <returns>A const pointer to the binding, or nullptr if none is found</returns>
 	VertexBufferBinding* GetBufferBinding(AttribUsage usage);
 
+	/// <summary>
+	/// Returns true if the given buffer has already been added to this VAO
+	/// </summary>
+	/// <param name="buffer">The buffer to search for</param>
+	bool HasVertexBuffer(const VertexBuffer::Sptr& buffer) const;
+
 	/// <summary>
 	/// Renders this VAO, using the specified draw mode
 	/// </summary>
@@ -133,9 +140,19 @@ public:
 	/// <param name="instanceCount">The number of instances to render</param>
 	/// <param name="mode">The primitive mode for rendering the mesh</param>
 	void DrawInstanced(uint32_t instanceCount, DrawMode mode = DrawMode::TriangleList);
+	/// <summary>
+	/// Renders this VAO with the given instance count, starting at the given instance in any
+	/// instanced vertex buffers. This lets many instanced draws share a single instance buffer
+	/// Internally this will call glDrawArraysInstancedBaseInstance or glDrawElementsInstancedBaseInstance
+	/// </summary>
+	/// <param name="instanceCount">The number of instances to render</param>
+	/// <param name="baseInstance">The index of the first instance to read from instanced buffers</param>
+	/// <param name="mode">The primitive mode for rendering the mesh</param>
+	void DrawInstanced(uint32_t instanceCount, uint32_t baseInstance, DrawMode mode = DrawMode::TriangleList);
 
 	/// <summary>
-	/// Binds this VAO as the source of data for draw operations
+	/// Binds this VAO as the source of data for draw operations. Note that the draw functions
+	/// leave the VAO bound, so that repeated draws of the same mesh don't rebind it
 	/// </summary>
 	void Bind();
 	/// <summary>
@@ -151,6 +168,15 @@ public:
 	void SetVDecl(const VertexDeclaration& vDecl);
 	const VertexDeclaration& GetVDecl();
 
+	/// <summary>
+	/// Sets the model space bounds of the mesh, used for culling
+	/// </summary>
+	void SetBounds(const Bounds& bounds) { _bounds = bounds; }
+	/// <summary>
+	/// Gets the model space bounds of the mesh, will be invalid if they were never calculated
+	/// </summary>
+	const Bounds& GetBounds() const { return _bounds; }
+
 protected:
 	
 	// The index buffer bound to this VAO
@@ -162,12 +188,18 @@ protected:
 	// defined in VertexTypes.cpp
 	VertexDeclaration _vDecl;
 
+	// The model space bounds of the mesh
+	Bounds _bounds;
+
 	uint32_t _vertexCount;
 	uint32_t _elementCount;
 
 	// The underlying OpenGL handle that this class is wrapping around
 	GLuint _handle;
 
+	// Points the binding's attributes at its buffer using DSA, so the VAO never needs to be bound
+	void _AttachBuffer(const VertexBufferBinding* binding);
+
 	// Inherited via IGraphicsResource
 	virtual GlResourceType GetResourceClass() const override;
 };
@@ -0,0 +1,177 @@
+#include "Utils/AssetPipeline.h"
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <mutex>
+
+#include <glad/glad.h>
+
+#include "Logging.h"
+#include "Utils/AsyncLoader.h"
+#include "Utils/JobSystem.h"
+
+namespace {
+	struct DecodedLoad {
+		std::weak_ptr<void>   Owner;
+		std::function<void()> Upload;
+		std::exception_ptr    Error;
+	};
+
+	JobGroup                decodeGroup;
+	std::mutex              readyMutex;
+	std::deque<DecodedLoad> readyLoads;
+
+	// Only touched on the main thread
+	uint32_t           batchDepth = 0;
+	size_t             numPending = 0;
+	std::exception_ptr batchError;
+
+	bool   usePixelBuffers = false;
+	bool   isPixelBufferBound = false;
+	GLuint pixelBuffer = 0;
+}
+
+void AssetPipeline::Cleanup() {
+	if (numPending > 0) {
+		LOG_WARN("Dropping {} asset loads that have not finished", numPending);
+	}
+	{
+		std::lock_guard<std::mutex> lock(readyMutex);
+		readyLoads.clear();
+	}
+	numPending = 0;
+	batchDepth = 0;
+	batchError = nullptr;
+
+	if (pixelBuffer != 0) {
+		glDeleteBuffers(1, &pixelBuffer);
+		pixelBuffer = 0;
+	}
+	isPixelBufferBound = false;
+}
+
+void AssetPipeline::BeginBatch() {
+	batchDepth++;
+}
+
+void AssetPipeline::EndBatch() {
+	LOG_ASSERT(batchDepth > 0, "EndBatch called without a matching BeginBatch!");
+	batchDepth--;
+	if (batchDepth > 0) {
+		return;
+	}
+
+	while (numPending > 0) {
+		if (_UploadNext()) {
+			// Uploads get spread out over frames along with the rest of the load
+			AsyncLoader::YieldIfOverBudget();
+		} else if (!AsyncLoader::YieldFrame()) {
+			// Nothing to hand the frame back to, so help the workers until every decode is done
+			JobSystem::Wait(decodeGroup);
+		}
+	}
+
+	if (batchError) {
+		std::exception_ptr error = batchError;
+		batchError = nullptr;
+		std::rethrow_exception(error);
+	}
+}
+
+bool AssetPipeline::IsBatching() {
+	return batchDepth > 0;
+}
+
+void AssetPipeline::Enqueue(const std::weak_ptr<void>& owner, std::function<void()> decode, std::function<void()> upload) {
+	LOG_ASSERT(batchDepth > 0, "Asset loads can only be queued while a batch is open!");
+	numPending++;
+
+	JobSystem::Run(decodeGroup, [owner, decode = std::move(decode), upload = std::move(upload)]() mutable {
+		DecodedLoad result{ owner, std::move(upload), nullptr };
+		// No point reading the file if whatever wanted it is already gone
+		if (!owner.expired()) {
+			try {
+				decode();
+			} catch (...) {
+				result.Error = std::current_exception();
+			}
+		}
+		decode = nullptr;
+
+		std::lock_guard<std::mutex> lock(readyMutex);
+		readyLoads.push_back(std::move(result));
+	});
+}
+
+size_t AssetPipeline::NumPending() {
+	return numPending;
+}
+
+void AssetPipeline::SetUsePixelBuffers(bool value) {
+	usePixelBuffers = value;
+}
+
+bool AssetPipeline::GetUsePixelBuffers() {
+	return usePixelBuffers;
+}
+
+void* AssetPipeline::BeginPixelUpload(void* data, size_t size) {
+	if (!usePixelBuffers || data == nullptr || size == 0) {
+		return data;
+	}
+
+	if (pixelBuffer == 0) {
+		glCreateBuffers(1, &pixelBuffer);
+	}
+
+	// Orphan the old storage so that we never wait on the driver to finish reading the previous upload
+	glNamedBufferData(pixelBuffer, size, nullptr, GL_STREAM_DRAW);
+	void* mapped = glMapNamedBufferRange(pixelBuffer, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+	if (mapped == nullptr) {
+		LOG_WARN("Failed to map the pixel buffer, uploading directly");
+		return data;
+	}
+	memcpy(mapped, data, size);
+	glUnmapNamedBuffer(pixelBuffer);
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffer);
+	isPixelBufferBound = true;
+
+	// With a buffer bound, the data pointer is an offset into the buffer
+	return nullptr;
+}
+
+void AssetPipeline::EndPixelUpload() {
+	if (isPixelBufferBound) {
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		isPixelBufferBound = false;
+	}
+}
+
+bool AssetPipeline::_UploadNext() {
+	DecodedLoad load;
+	{
+		std::lock_guard<std::mutex> lock(readyMutex);
+		if (readyLoads.empty()) {
+			return false;
+		}
+		load = std::move(readyLoads.front());
+		readyLoads.pop_front();
+	}
+	numPending--;
+
+	if (load.Error) {
+		// Hang on to the first error, the other loads in the batch still get to finish
+		if (!batchError) {
+			batchError = load.Error;
+		}
+		return true;
+	}
+
+	// Keep the owner alive while we upload into it
+	std::shared_ptr<void> owner = load.Owner.lock();
+	if (owner != nullptr) {
+		load.Upload();
+	}
+	return true;
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+/// <summary>
+/// Loads file backed assets (meshes, textures, LUTs, etc...) in two halves. The decode half reads
+/// and parses the file into plain CPU side staging data on the job system, so any number of files
+/// are decoded at once, and the upload half creates the GL storage from that staging data back on
+/// the main thread
+///
+/// Loads are only deferred while a batch is open (see BeginBatch). Loaders check IsBatching, and
+/// if no batch is open they should just decode and upload in place like before. When a batch is
+/// closed from inside an AsyncLoader load, the uploads are spread out over frames using the load's
+/// time budget
+/// </summary>
+class AssetPipeline {
+public:
+	/// <summary>
+	/// Drops any loads that have not been uploaded yet and releases the pixel buffer, should be
+	/// called after the job system has been shut down
+	/// </summary>
+	static void Cleanup();
+
+	/// <summary>
+	/// Opens a batch, loads started until the matching EndBatch will be decoded in parallel. Batches
+	/// can be nested, only the outermost EndBatch waits for the loads
+	/// </summary>
+	static void BeginBatch();
+	/// <summary>
+	/// Closes a batch, and returns once every load queued in it has been decoded and uploaded. Inside
+	/// of an AsyncLoader load, frames keep running while it waits. Exceptions thrown while decoding are
+	/// re-thrown from here once all the other loads are done
+	/// </summary>
+	static void EndBatch();
+	/// <summary>
+	/// Returns true if a batch is open, and loaders should queue their work with Enqueue
+	/// </summary>
+	static bool IsBatching();
+
+	/// <summary>
+	/// Queues a load, should only be called from the main thread while a batch is open
+	/// </summary>
+	/// <param name="owner">The object being loaded into, if it gets destroyed before the load is finished the load is dropped</param>
+	/// <param name="decode">Reads the file into staging data, runs on a worker and must not touch the GL context or the owner</param>
+	/// <param name="upload">Creates the GL storage from the staging data, runs on the main thread</param>
+	static void Enqueue(const std::weak_ptr<void>& owner, std::function<void()> decode, std::function<void()> upload);
+	/// <summary>
+	/// Gets the number of loads that have been queued but not uploaded yet
+	/// </summary>
+	static size_t NumPending();
+
+	/// <summary>
+	/// Sets whether texture uploads should go through a pixel unpack buffer, which lets the driver
+	/// copy the pixels to the GPU without stalling the upload call
+	/// </summary>
+	static void SetUsePixelBuffers(bool value);
+	static bool GetUsePixelBuffers();
+	/// <summary>
+	/// Prepares pixel data for a texture upload. If pixel buffers are enabled, the data is copied into
+	/// the pixel unpack buffer and the buffer is left bound. Pass the result to glTextureSubImage* in
+	/// place of the data, then call EndPixelUpload
+	/// </summary>
+	/// <param name="data">The pixels to upload</param>
+	/// <param name="size">The size of the pixel data, in bytes</param>
+	/// <returns>The pointer to hand to the upload call, either the data itself or an offset into the bound buffer</returns>
+	static void* BeginPixelUpload(void* data, size_t size);
+	/// <summary>
+	/// Unbinds the pixel unpack buffer after an upload started with BeginPixelUpload
+	/// </summary>
+	static void EndPixelUpload();
+
+private:
+	// Uploads the next load that has finished decoding, returns false if none are ready
+	static bool _UploadNext();
+};
@@ -0,0 +1,200 @@
+#include "Utils/AsyncLoader.h"
+#include <chrono>
+#include <exception>
+
+#include "Logging.h"
+#include "Utils/JobSystem.h"
+
+#ifdef _WIN32
+#include <Windows.h>
+#define ASYNC_LOADER_FIBERS 1
+#else
+#define ASYNC_LOADER_FIBERS 0
+#endif
+
+namespace {
+	// Loads get their own stack, scene building code tends to have some very large functions
+	constexpr size_t LOAD_STACK_COMMIT_SIZE  = 64 * 1024;
+	constexpr size_t LOAD_STACK_RESERVE_SIZE = 8 * 1024 * 1024;
+
+	std::function<void()> loadFunction;
+	std::function<void()> completeCallback;
+	std::exception_ptr    loadError;
+
+	bool isLoading = false;
+	bool isLoadDone = false;
+	bool isInLoad = false;
+	std::chrono::steady_clock::time_point sliceEnd;
+
+	#if ASYNC_LOADER_FIBERS
+	void* mainFiber = nullptr;
+	void* loadFiber = nullptr;
+	bool  convertedThread = false;
+
+	void CALLBACK LoadFiberProc(void*) {
+		try {
+			loadFunction();
+		} catch (...) {
+			loadError = std::current_exception();
+		}
+		isLoadDone = true;
+
+		// Returning from a fiber's entry point exits the thread, so just hand control back for good
+		while (true) {
+			SwitchToFiber(mainFiber);
+		}
+	}
+	#endif
+
+	// Hands control from the load back to the frame
+	void SuspendLoad() {
+		#if ASYNC_LOADER_FIBERS
+		SwitchToFiber(mainFiber);
+		#endif
+	}
+}
+
+void AsyncLoader::Cleanup() {
+	#if ASYNC_LOADER_FIBERS
+	if (loadFiber != nullptr) {
+		LOG_WARN("Abandoning an async load that has not finished");
+		DeleteFiber(loadFiber);
+		loadFiber = nullptr;
+	}
+	if (convertedThread) {
+		ConvertFiberToThread();
+		convertedThread = false;
+	}
+	mainFiber = nullptr;
+	#endif
+
+	loadFunction = nullptr;
+	completeCallback = nullptr;
+	loadError = nullptr;
+	isLoading = false;
+	isLoadDone = false;
+}
+
+bool AsyncLoader::Begin(std::function<void()> load, std::function<void()> onComplete) {
+	if (isLoading) {
+		LOG_WARN("An async load is already in progress, ignoring new load");
+		return false;
+	}
+
+	#if ASYNC_LOADER_FIBERS
+	// The main thread needs to be a fiber before it can switch to one
+	if (mainFiber == nullptr) {
+		if (IsThreadAFiber()) {
+			mainFiber = GetCurrentFiber();
+		} else {
+			mainFiber = ConvertThreadToFiber(nullptr);
+			convertedThread = true;
+		}
+		LOG_ASSERT(mainFiber != nullptr, "Failed to convert the main thread to a fiber!");
+	}
+
+	loadFiber = CreateFiberEx(LOAD_STACK_COMMIT_SIZE, LOAD_STACK_RESERVE_SIZE, FIBER_FLAG_FLOAT_SWITCH, LoadFiberProc, nullptr);
+	if (loadFiber == nullptr) {
+		LOG_ERROR("Failed to create a fiber for async loading!");
+		return false;
+	}
+	#endif
+
+	loadFunction = std::move(load);
+	completeCallback = std::move(onComplete);
+	loadError = nullptr;
+	isLoading = true;
+	isLoadDone = false;
+	return true;
+}
+
+bool AsyncLoader::IsLoading() {
+	return isLoading;
+}
+
+void AsyncLoader::Update(float budgetSeconds) {
+	if (!isLoading) {
+		return;
+	}
+
+	sliceEnd = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(budgetSeconds));
+	isInLoad = true;
+	#if ASYNC_LOADER_FIBERS
+	SwitchToFiber(loadFiber);
+	#else
+	try {
+		loadFunction();
+	} catch (...) {
+		loadError = std::current_exception();
+	}
+	isLoadDone = true;
+	#endif
+	isInLoad = false;
+
+	if (isLoadDone) {
+		#if ASYNC_LOADER_FIBERS
+		DeleteFiber(loadFiber);
+		loadFiber = nullptr;
+		#endif
+
+		// Clear our state before calling out, so the callback can start another load
+		std::function<void()> onComplete = std::move(completeCallback);
+		std::exception_ptr error = loadError;
+		loadFunction = nullptr;
+		completeCallback = nullptr;
+		loadError = nullptr;
+		isLoading = false;
+		isLoadDone = false;
+
+		if (error) {
+			std::rethrow_exception(error);
+		}
+		if (onComplete) {
+			onComplete();
+		}
+	}
+}
+
+bool AsyncLoader::IsInLoad() {
+	return isInLoad;
+}
+
+void AsyncLoader::YieldIfOverBudget() {
+	if (isInLoad && std::chrono::steady_clock::now() >= sliceEnd) {
+		SuspendLoad();
+	}
+}
+
+bool AsyncLoader::YieldFrame() {
+	if (!isInLoad || !ASYNC_LOADER_FIBERS) {
+		return false;
+	}
+	SuspendLoad();
+	return true;
+}
+
+void AsyncLoader::RunInBackground(const std::function<void()>& job) {
+	if (!isInLoad || !ASYNC_LOADER_FIBERS) {
+		job();
+		return;
+	}
+
+	std::exception_ptr jobError;
+	JobGroup group;
+	JobSystem::Run(group, [&job, &jobError]() {
+		try {
+			job();
+		} catch (...) {
+			jobError = std::current_exception();
+		}
+	});
+
+	// Let the frames keep going while the workers chew on it
+	while (!group.IsDone()) {
+		SuspendLoad();
+	}
+
+	if (jobError) {
+		std::rethrow_exception(jobError);
+	}
+}
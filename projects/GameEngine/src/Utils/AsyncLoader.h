@@ -0,0 +1,65 @@
+#pragma once
+#include <functional>
+
+/// <summary>
+/// Runs a long load, like building a whole scene, on the main thread but spread out over several
+/// frames, so the application keeps updating and rendering while it runs. The load gets its own
+/// stack and hands control back to the frame whenever it has used up its time budget (see
+/// YieldIfOverBudget), then picks up where it left off on the next frame
+///
+/// Since the load stays on the main thread it can create GL objects and build scenes like any other
+/// code, it just can't leave GL state (bindings, etc...) set up across a yield. Work that doesn't need
+/// the GL context, such as parsing and decoding files, can be moved to the job system with RunInBackground
+///
+/// On platforms without fiber support the load simply runs to completion in a single frame
+/// </summary>
+class AsyncLoader {
+public:
+	/// <summary>
+	/// Abandons any load in progress, should be called after the job system has been shut down
+	/// </summary>
+	static void Cleanup();
+
+	/// <summary>
+	/// Starts a new load, which will first run during the next call to Update
+	/// </summary>
+	/// <param name="load">The function that performs the load</param>
+	/// <param name="onComplete">Optional callback invoked on the main thread once the load has finished</param>
+	/// <returns>True if the load was started, false if another load is still running</returns>
+	static bool Begin(std::function<void()> load, std::function<void()> onComplete = nullptr);
+	/// <summary>
+	/// Returns true if a load has been started and hasn't finished yet
+	/// </summary>
+	static bool IsLoading();
+
+	/// <summary>
+	/// Lets the current load run for up to the given amount of time, should be called once per frame
+	/// from the main loop. Exceptions thrown by the load are re-thrown from here
+	/// </summary>
+	/// <param name="budgetSeconds">How long the load may run for this frame, in seconds</param>
+	static void Update(float budgetSeconds);
+
+	/// <summary>
+	/// Returns true if called from inside a running load
+	/// </summary>
+	static bool IsInLoad();
+	/// <summary>
+	/// If called from inside a load that has used up its budget for this frame, hands control back to
+	/// the frame until the next Update. Does nothing when called from outside of a load, so it can be
+	/// sprinkled into any code that a load may call (creating assets, creating objects, etc...)
+	/// </summary>
+	static void YieldIfOverBudget();
+	/// <summary>
+	/// Hands control back to the frame until the next Update no matter how much of the budget is left,
+	/// for loads that are waiting on work happening somewhere else
+	/// </summary>
+	/// <returns>True if the load was suspended, false if called outside of a load or on platforms without fiber support</returns>
+	static bool YieldFrame();
+	/// <summary>
+	/// Runs a job on the job system, and lets frames keep running until it is done if called from inside
+	/// a load. Outside of a load the job is just invoked directly. Exceptions thrown by the job are re-thrown
+	/// on the calling thread
+	/// </summary>
+	/// <param name="job">The job to run, must not touch the GL context</param>
+	static void RunInBackground(const std::function<void()>& job);
+};
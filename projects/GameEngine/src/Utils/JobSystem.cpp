@@ -0,0 +1,221 @@
+#include "Utils/JobSystem.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+
+#include "Logging.h"
+
+struct JobSystem::WorkerQueue {
+	std::mutex      Mutex;
+	std::deque<Job> Jobs;
+};
+
+namespace {
+	std::vector<std::thread> workers;
+
+	std::mutex              sleepMutex;
+	std::condition_variable sleepCondition;
+	std::atomic<uint32_t>   queuedJobs(0);
+	std::atomic<bool>       isRunning(false);
+
+	// The index of the worker on this thread, or -1 on threads that aren't workers
+	thread_local int threadWorkerIndex = -1;
+}
+
+std::vector<std::unique_ptr<JobSystem::WorkerQueue>> JobSystem::_queues;
+
+void JobSystem::Init(uint32_t numWorkers) {
+	LOG_ASSERT(!isRunning, "Job system has already been initialized!");
+
+	if (numWorkers == 0) {
+		uint32_t hardwareThreads = std::thread::hardware_concurrency();
+		numWorkers = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+	}
+
+	_queues.clear();
+	for (uint32_t ix = 0; ix <= numWorkers; ix++) {
+		_queues.push_back(std::make_unique<WorkerQueue>());
+	}
+
+	isRunning = true;
+	for (uint32_t ix = 0; ix < numWorkers; ix++) {
+		workers.emplace_back(&JobSystem::_WorkerLoop, ix);
+	}
+	LOG_INFO("Started job system with {} workers", numWorkers);
+}
+
+void JobSystem::Cleanup() {
+	if (!isRunning) {
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		isRunning = false;
+	}
+	sleepCondition.notify_all();
+	for (std::thread& worker : workers) {
+		worker.join();
+	}
+	workers.clear();
+	_queues.clear();
+}
+
+void JobSystem::Run(JobGroup& group, std::function<void()> job) {
+	group._pending.fetch_add(1, std::memory_order_relaxed);
+
+	// Without workers there's nothing to hand the job to, so just run it here
+	if (!isRunning) {
+		Job inlineJob{ std::move(job), &group };
+		_Execute(inlineJob);
+		return;
+	}
+
+	// Workers push to their own queue, everyone else shares the last one
+	size_t queueIx = threadWorkerIndex >= 0 ? threadWorkerIndex : _queues.size() - 1;
+	{
+		WorkerQueue& queue = *_queues[queueIx];
+		std::lock_guard<std::mutex> lock(queue.Mutex);
+		queue.Jobs.push_back(Job{ std::move(job), &group });
+	}
+	queuedJobs.fetch_add(1, std::memory_order_release);
+
+	// Lock so that a worker can't miss the wakeup between checking the count and going to sleep
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+	}
+	sleepCondition.notify_one();
+}
+
+void JobSystem::Wait(JobGroup& group) {
+	Job job;
+	while (!group.IsDone()) {
+		if (_TryGetJob(job, &group)) {
+			_Execute(job);
+		} else {
+			std::this_thread::yield();
+		}
+	}
+
+	std::exception_ptr error;
+	{
+		std::lock_guard<std::mutex> lock(group._errorMutex);
+		std::swap(error, group._error);
+	}
+	if (error) {
+		std::rethrow_exception(error);
+	}
+}
+
+void JobSystem::ParallelFor(uint32_t count, uint32_t batchSize, const std::function<void(uint32_t start, uint32_t end)>& body) {
+	if (count == 0) {
+		return;
+	}
+	batchSize = batchSize > 0 ? batchSize : 1;
+
+	// Not worth the overhead of going wide
+	if (count <= batchSize || !isRunning) {
+		body(0, count);
+		return;
+	}
+
+	JobGroup group;
+	for (uint32_t start = 0; start < count; start += batchSize) {
+		uint32_t end = start + batchSize < count ? start + batchSize : count;
+		Run(group, [&body, start, end]() { body(start, end); });
+	}
+	Wait(group);
+}
+
+uint32_t JobSystem::GetNumWorkers() {
+	return static_cast<uint32_t>(workers.size());
+}
+
+bool JobSystem::IsWorkerThread() {
+	return threadWorkerIndex >= 0;
+}
+
+void JobSystem::_WorkerLoop(uint32_t workerIndex) {
+	threadWorkerIndex = static_cast<int>(workerIndex);
+
+	Job job;
+	while (true) {
+		if (_TryGetJob(job)) {
+			_Execute(job);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(sleepMutex);
+		sleepCondition.wait(lock, []() {
+			return !isRunning || queuedJobs.load(std::memory_order_acquire) > 0;
+		});
+		if (!isRunning) {
+			break;
+		}
+	}
+
+	threadWorkerIndex = -1;
+}
+
+bool JobSystem::_TryGetJob(Job& result, const JobGroup* group) {
+	if (queuedJobs.load(std::memory_order_acquire) == 0) {
+		return false;
+	}
+
+	// Takes the first job in the group found when walking from the back (newest) or the front (oldest) of a queue
+	auto takeJob = [&](WorkerQueue& queue, bool fromBack) {
+		std::lock_guard<std::mutex> lock(queue.Mutex);
+		const size_t count = queue.Jobs.size();
+		for (size_t ix = 0; ix < count; ix++) {
+			auto it = fromBack ? queue.Jobs.begin() + (count - 1 - ix) : queue.Jobs.begin() + ix;
+			if (group == nullptr || it->Group == group) {
+				result = std::move(*it);
+				queue.Jobs.erase(it);
+				queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+				return true;
+			}
+		}
+		return false;
+	};
+
+	const size_t numQueues = _queues.size();
+
+	// Newest job from our own queue first, it's the most likely to still be in cache
+	if (threadWorkerIndex >= 0 && takeJob(*_queues[threadWorkerIndex], true)) {
+		return true;
+	}
+
+	// Steal the oldest job from someone else, starting at our neighbour so workers don't all hit the same queue
+	size_t start = threadWorkerIndex >= 0 ? threadWorkerIndex + 1 : 0;
+	for (size_t offset = 0; offset < numQueues; offset++) {
+		size_t queueIx = (start + offset) % numQueues;
+		if (static_cast<int>(queueIx) == threadWorkerIndex) {
+			continue;
+		}
+		if (takeJob(*_queues[queueIx], false)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void JobSystem::_Execute(Job& job) {
+	// The group has to hear that the job finished no matter how it finished, or its waiter spins forever
+	struct PendingGuard {
+		JobGroup* Group;
+		~PendingGuard() { Group->_pending.fetch_sub(1, std::memory_order_acq_rel); }
+	} guard{ job.Group };
+
+	try {
+		job.Function();
+	} catch (...) {
+		// Hand the error to whoever is waiting on the group, it can't be allowed to escape a worker thread
+		std::lock_guard<std::mutex> lock(job.Group->_errorMutex);
+		if (!job.Group->_error) {
+			job.Group->_error = std::current_exception();
+		}
+	}
+	job.Function = nullptr;
+}
@@ -0,0 +1,100 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/// <summary>
+/// Tracks a set of jobs that were started together, so that the code that started them
+/// can wait for all of them to finish (fork/join)
+/// </summary>
+class JobGroup {
+public:
+	JobGroup() : _pending(0) { }
+
+	JobGroup(const JobGroup& other) = delete;
+	JobGroup& operator=(const JobGroup& other) = delete;
+
+	/// <summary>
+	/// Returns true if all jobs in the group have finished
+	/// </summary>
+	bool IsDone() const { return _pending.load(std::memory_order_acquire) == 0; }
+
+private:
+	friend class JobSystem;
+	std::atomic<uint32_t> _pending;
+	// The first exception thrown by a job in the group, re-thrown from JobSystem::Wait
+	std::mutex            _errorMutex;
+	std::exception_ptr    _error;
+};
+
+/// <summary>
+/// A pool of worker threads that run small jobs. Each worker has its own queue that it
+/// pushes to and pops from the back of, and workers that run out of work steal from the
+/// front of the other queues, so that jobs spawned from inside jobs stay on the same
+/// core while idle workers still pick up the slack
+///
+/// Threads that wait on a group help run that group's jobs while they wait, so the main
+/// thread is never just blocked while the workers are busy, and never picks up someone
+/// else's long running job (ex: an asset decode) in the middle of a frame
+/// </summary>
+class JobSystem {
+public:
+	/// <summary>
+	/// Starts the worker threads, should be called once at the start of the application
+	/// </summary>
+	/// <param name="numWorkers">The number of workers to start, or 0 to use one less than the number of hardware threads</param>
+	static void Init(uint32_t numWorkers = 0);
+	/// <summary>
+	/// Stops and joins the worker threads, should be called before closing the application
+	/// </summary>
+	static void Cleanup();
+
+	/// <summary>
+	/// Queues a job to run on the workers, and adds it to the given group (fork)
+	/// </summary>
+	/// <param name="group">The group to add the job to, must outlive the job</param>
+	/// <param name="job">The job to run</param>
+	static void Run(JobGroup& group, std::function<void()> job);
+	/// <summary>
+	/// Blocks until every job in the group has finished, running the group's queued jobs in the
+	/// meantime (join). If any of the jobs threw, the first exception is re-thrown from here
+	/// </summary>
+	static void Wait(JobGroup& group);
+
+	/// <summary>
+	/// Splits the range [0, count) into batches and runs the body on the workers, returning once
+	/// all batches are done. The calling thread runs batches too
+	/// </summary>
+	/// <param name="count">The number of items to process</param>
+	/// <param name="batchSize">The maximum number of items in each batch</param>
+	/// <param name="body">The function to invoke for each batch, with the signature void(start, end)</param>
+	static void ParallelFor(uint32_t count, uint32_t batchSize, const std::function<void(uint32_t start, uint32_t end)>& body);
+
+	/// <summary>
+	/// Gets the number of worker threads, not counting the main thread
+	/// </summary>
+	static uint32_t GetNumWorkers();
+	/// <summary>
+	/// Returns true if called from one of the job system's worker threads
+	/// </summary>
+	static bool IsWorkerThread();
+
+private:
+	struct Job {
+		std::function<void()> Function;
+		JobGroup*             Group = nullptr;
+	};
+	struct WorkerQueue;
+
+	// One queue per worker, plus one at the end for jobs pushed from other threads
+	static std::vector<std::unique_ptr<WorkerQueue>> _queues;
+
+	static void _WorkerLoop(uint32_t workerIndex);
+	// Pops a job from our own queue, or steals one from another queue. If a group is given, only jobs in that group are taken
+	static bool _TryGetJob(Job& result, const JobGroup* group = nullptr);
+	static void _Execute(Job& job);
+};
@@ -0,0 +1,128 @@
+#include "Utils/MemoryMappedFile.h"
+#include <Logging.h>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MemoryMappedFile::MemoryMappedFile() :
+	_data(nullptr),
+	_size(0),
+	#ifdef _WIN32
+	_fileHandle(nullptr),
+	_mappingHandle(nullptr)
+	#else
+	_fileDescriptor(-1)
+	#endif
+{ }
+
+MemoryMappedFile::~MemoryMappedFile() {
+	Close();
+}
+
+#ifdef _WIN32
+
+bool MemoryMappedFile::Open(const std::string& path) {
+	Close();
+
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		LOG_ERROR("Could not open file '{}'", path);
+		return false;
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+		// Windows won't map empty files, and there'd be nothing to read anyways
+		CloseHandle(file);
+		LOG_WARN("File '{}' is empty or its size could not be read", path);
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping == nullptr) {
+		CloseHandle(file);
+		LOG_ERROR("Could not map file '{}'", path);
+		return false;
+	}
+
+	void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (view == nullptr) {
+		CloseHandle(mapping);
+		CloseHandle(file);
+		LOG_ERROR("Could not map file '{}'", path);
+		return false;
+	}
+
+	_fileHandle = file;
+	_mappingHandle = mapping;
+	_data = static_cast<const uint8_t*>(view);
+	_size = static_cast<size_t>(size.QuadPart);
+	return true;
+}
+
+void MemoryMappedFile::Close() {
+	if (_data != nullptr) {
+		UnmapViewOfFile(_data);
+	}
+	if (_mappingHandle != nullptr) {
+		CloseHandle(_mappingHandle);
+	}
+	if (_fileHandle != nullptr) {
+		CloseHandle(_fileHandle);
+	}
+	_data = nullptr;
+	_size = 0;
+	_fileHandle = nullptr;
+	_mappingHandle = nullptr;
+}
+
+#else
+
+bool MemoryMappedFile::Open(const std::string& path) {
+	Close();
+
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		LOG_ERROR("Could not open file '{}'", path);
+		return false;
+	}
+
+	struct stat info;
+	if (fstat(fd, &info) != 0 || info.st_size == 0) {
+		close(fd);
+		LOG_WARN("File '{}' is empty or its size could not be read", path);
+		return false;
+	}
+
+	void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+	if (view == MAP_FAILED) {
+		close(fd);
+		LOG_ERROR("Could not map file '{}'", path);
+		return false;
+	}
+
+	_fileDescriptor = fd;
+	_data = static_cast<const uint8_t*>(view);
+	_size = static_cast<size_t>(info.st_size);
+	return true;
+}
+
+void MemoryMappedFile::Close() {
+	if (_data != nullptr) {
+		munmap(const_cast<uint8_t*>(_data), _size);
+	}
+	if (_fileDescriptor >= 0) {
+		close(_fileDescriptor);
+	}
+	_data = nullptr;
+	_size = 0;
+	_fileDescriptor = -1;
+}
+
+#endif
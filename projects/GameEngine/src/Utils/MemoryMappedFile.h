@@ -0,0 +1,54 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+#include "Utils/Macros.h"
+
+/// <summary>
+/// Maps a file into memory as read-only, so that it can be read directly without copying
+/// it into a buffer first. The OS pages the file in as it gets touched, and the mapping is
+/// released when the object is destroyed
+/// </summary>
+class MemoryMappedFile {
+public:
+	NO_COPY(MemoryMappedFile);
+	NO_MOVE(MemoryMappedFile);
+
+	MemoryMappedFile();
+	~MemoryMappedFile();
+
+	/// <summary>
+	/// Maps the file at the given path, closing any file that was already open
+	/// </summary>
+	/// <param name="path">The path of the file to map</param>
+	/// <returns>True if the file was mapped, false if it could not be opened or is empty</returns>
+	bool Open(const std::string& path);
+	/// <summary>
+	/// Unmaps the file, any pointers returned by Data are invalid after this
+	/// </summary>
+	void Close();
+
+	/// <summary>
+	/// Returns true if a file is currently mapped
+	/// </summary>
+	bool IsOpen() const { return _data != nullptr; }
+	/// <summary>
+	/// Gets a pointer to the start of the mapped file, or nullptr if no file is open
+	/// </summary>
+	const uint8_t* Data() const { return _data; }
+	/// <summary>
+	/// Gets the size of the mapped file in bytes
+	/// </summary>
+	size_t Size() const { return _size; }
+
+private:
+	const uint8_t* _data;
+	size_t         _size;
+
+	#ifdef _WIN32
+	void* _fileHandle;
+	void* _mappingHandle;
+	#else
+	int   _fileDescriptor;
+	#endif
+};
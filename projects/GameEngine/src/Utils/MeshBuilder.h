@@ -138,6 +138,15 @@ public:
 		// Store our vertex type in the VAO's vertex declaration
 		result->SetVDecl(VertType::V_DECL);
 
+		// Calculate the bounds from the position attribute, if the vertex type has one
+		for (const BufferAttribute& attrib : VertType::V_DECL) {
+			if (attrib.Usage == AttribUsage::Position) {
+				const uint8_t* positions = reinterpret_cast<const uint8_t*>(GetVertexDataPtr()) + attrib.Offset;
+				result->SetBounds(Bounds::FromPoints(positions, _vertices.size(), sizeof(VertType)));
+				break;
+			}
+		}
+
 		return result;
 	}
 	
@@ -166,6 +175,7 @@ public:
 	
 protected:
 	friend class MeshFactory;
+	friend class MeshOptimizer;
 	
 	std::vector<VertType> _vertices;
 	std::vector<uint32_t> _indices;
@@ -0,0 +1,236 @@
+#include "Utils/MeshOptimizer.h"
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+namespace {
+	struct CornerHash {
+		size_t operator()(const glm::ivec3& corner) const {
+			return (static_cast<size_t>(corner.x) * 73856093u) ^ (static_cast<size_t>(corner.y) * 19349663u) ^ (static_cast<size_t>(corner.z) * 83492791u);
+		}
+	};
+
+	// Scoring constants from Tom Forsyth's "Linear-Speed Vertex Cache Optimisation"
+	constexpr float CACHE_DECAY_POWER   = 1.5f;
+	constexpr float LAST_TRI_SCORE      = 0.75f;
+	constexpr float VALENCE_BOOST_SCALE = 2.0f;
+	constexpr float VALENCE_BOOST_POWER = 0.5f;
+
+	// Scores a vertex based on where it is in the cache, and how many triangles still need it
+	float ScoreVertex(int cachePosition, uint32_t remainingTris) {
+		// Nothing left to draw with this vertex
+		if (remainingTris == 0) {
+			return -1.0f;
+		}
+
+		float score = 0.0f;
+		if (cachePosition >= 0) {
+			// The last triangle's vertices get a fixed score, so that we don't just draw strips
+			if (cachePosition < 3) {
+				score = LAST_TRI_SCORE;
+			} else {
+				const float scaler = 1.0f / (MeshOptimizer::VERTEX_CACHE_SIZE - 3);
+				score = std::pow(1.0f - (cachePosition - 3) * scaler, CACHE_DECAY_POWER);
+			}
+		}
+
+		// Favour vertices with few triangles left, so we finish them off instead of leaving lone triangles behind
+		score += VALENCE_BOOST_SCALE * std::pow(static_cast<float>(remainingTris), -VALENCE_BOOST_POWER);
+		return score;
+	}
+}
+
+void MeshOptimizer::WeldCorners(const std::vector<glm::ivec3>& corners, std::vector<uint32_t>& indices, std::vector<glm::ivec3>& uniqueCorners) {
+	// Maps a combination of attributes to a vertex that has been added already
+	std::unordered_map<glm::ivec3, uint32_t, CornerHash> vertexMap;
+	vertexMap.reserve(corners.size());
+
+	indices.clear();
+	indices.reserve(corners.size());
+	uniqueCorners.clear();
+
+	for (const glm::ivec3& corner : corners) {
+		auto it = vertexMap.find(corner);
+		if (it != vertexMap.end()) {
+			indices.push_back(it->second);
+		} else {
+			uint32_t index = static_cast<uint32_t>(uniqueCorners.size());
+			uniqueCorners.push_back(corner);
+			vertexMap[corner] = index;
+			indices.push_back(index);
+		}
+	}
+}
+
+void MeshOptimizer::OptimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount) {
+	const size_t triCount = indices.size() / 3;
+	if (triCount == 0 || vertexCount == 0) {
+		return;
+	}
+
+	// Build the list of triangles that use each vertex, the first remainingTris[v] entries
+	// of a vertex's range are the ones that have not been drawn yet
+	std::vector<uint32_t> remainingTris(vertexCount, 0);
+	for (size_t ix = 0; ix < triCount * 3; ix++) {
+		remainingTris[indices[ix]]++;
+	}
+	std::vector<uint32_t> triOffsets(vertexCount + 1, 0);
+	for (size_t ix = 0; ix < vertexCount; ix++) {
+		triOffsets[ix + 1] = triOffsets[ix] + remainingTris[ix];
+	}
+	std::vector<uint32_t> vertexTris(triCount * 3);
+	{
+		std::vector<uint32_t> cursor(triOffsets.begin(), triOffsets.end() - 1);
+		for (size_t ix = 0; ix < triCount * 3; ix++) {
+			vertexTris[cursor[indices[ix]]++] = static_cast<uint32_t>(ix / 3);
+		}
+	}
+
+	std::vector<int> cachePosition(vertexCount, -1);
+	std::vector<float> vertexScores(vertexCount);
+	for (size_t ix = 0; ix < vertexCount; ix++) {
+		vertexScores[ix] = ScoreVertex(-1, remainingTris[ix]);
+	}
+
+	std::vector<float> triScores(triCount);
+	std::vector<bool> isEmitted(triCount, false);
+	int bestTri = -1;
+	float bestScore = -1.0f;
+	for (size_t ix = 0; ix < triCount; ix++) {
+		triScores[ix] = vertexScores[indices[ix * 3]] + vertexScores[indices[ix * 3 + 1]] + vertexScores[indices[ix * 3 + 2]];
+		if (triScores[ix] > bestScore) {
+			bestScore = triScores[ix];
+			bestTri = static_cast<int>(ix);
+		}
+	}
+
+	std::vector<uint32_t> result;
+	result.reserve(triCount * 3);
+	std::vector<uint32_t> cache, newCache;
+	cache.reserve(VERTEX_CACHE_SIZE + 3);
+	newCache.reserve(VERTEX_CACHE_SIZE + 3);
+	size_t nextUnemitted = 0;
+
+	while (result.size() < triCount * 3) {
+		// Nothing in the cache is useful anymore, start again from the first triangle we haven't drawn
+		if (bestTri < 0) {
+			while (isEmitted[nextUnemitted]) {
+				nextUnemitted++;
+			}
+			bestTri = static_cast<int>(nextUnemitted);
+		}
+
+		// Draw the triangle, and take it out of the lists of its vertices
+		const uint32_t* tri = &indices[static_cast<size_t>(bestTri) * 3];
+		isEmitted[bestTri] = true;
+		newCache.clear();
+		for (int corner = 0; corner < 3; corner++) {
+			const uint32_t vertex = tri[corner];
+			result.push_back(vertex);
+			newCache.push_back(vertex);
+
+			uint32_t* begin = &vertexTris[triOffsets[vertex]];
+			uint32_t* end = begin + remainingTris[vertex];
+			uint32_t* it = std::find(begin, end, static_cast<uint32_t>(bestTri));
+			if (it != end) {
+				std::swap(*it, *(end - 1));
+				remainingTris[vertex]--;
+			}
+		}
+
+		// The triangle's vertices move to the front of the cache, everything else gets pushed back
+		for (uint32_t vertex : cache) {
+			if (vertex != tri[0] && vertex != tri[1] && vertex != tri[2]) {
+				newCache.push_back(vertex);
+			}
+		}
+
+		// Re-score everything that moved, including vertices that just fell out of the cache
+		for (size_t ix = 0; ix < newCache.size(); ix++) {
+			const uint32_t vertex = newCache[ix];
+			cachePosition[vertex] = ix < VERTEX_CACHE_SIZE ? static_cast<int>(ix) : -1;
+
+			const float score = ScoreVertex(cachePosition[vertex], remainingTris[vertex]);
+			const float delta = score - vertexScores[vertex];
+			vertexScores[vertex] = score;
+			for (uint32_t triIx = triOffsets[vertex]; triIx < triOffsets[vertex] + remainingTris[vertex]; triIx++) {
+				triScores[vertexTris[triIx]] += delta;
+			}
+		}
+
+		// The next triangle to draw is the best one that uses a vertex in the cache
+		bestTri = -1;
+		bestScore = -1.0f;
+		newCache.resize(std::min<size_t>(newCache.size(), VERTEX_CACHE_SIZE));
+		for (uint32_t vertex : newCache) {
+			for (uint32_t triIx = triOffsets[vertex]; triIx < triOffsets[vertex] + remainingTris[vertex]; triIx++) {
+				const uint32_t candidate = vertexTris[triIx];
+				if (triScores[candidate] > bestScore) {
+					bestScore = triScores[candidate];
+					bestTri = static_cast<int>(candidate);
+				}
+			}
+		}
+		cache.swap(newCache);
+	}
+
+	// Any trailing indices that don't make up a whole triangle are left where they were
+	std::copy(result.begin(), result.end(), indices.begin());
+}
+
+size_t MeshOptimizer::OptimizeVertexFetch(std::vector<uint32_t>& indices, size_t vertexCount, std::vector<uint32_t>& remap) {
+	remap.assign(vertexCount, UINT32_MAX);
+	uint32_t nextVertex = 0;
+	for (uint32_t& index : indices) {
+		if (remap[index] == UINT32_MAX) {
+			remap[index] = nextVertex++;
+		}
+		index = remap[index];
+	}
+	return nextVertex;
+}
+
+MeshOptimizerStats MeshOptimizer::OptimizeIndices(std::vector<uint32_t>& indices, size_t vertexCount, std::vector<uint32_t>& remap) {
+	MeshOptimizerStats result;
+	result.NumIndices = indices.size();
+	result.AcmrBefore = CalculateACMR(indices);
+
+	OptimizeVertexCache(indices, vertexCount);
+	result.NumVertices = OptimizeVertexFetch(indices, vertexCount, remap);
+
+	result.AcmrAfter = CalculateACMR(indices);
+	return result;
+}
+
+float MeshOptimizer::CalculateACMR(const std::vector<uint32_t>& indices, uint32_t cacheSize) {
+	const size_t triCount = indices.size() / 3;
+	if (triCount == 0 || cacheSize == 0) {
+		return 0.0f;
+	}
+
+	// Timestamp of when each vertex was last loaded into the cache, it's still cached if no more than
+	// cacheSize misses have happened since then (including its own)
+	std::unordered_map<uint32_t, size_t> loadedAt;
+	loadedAt.reserve(indices.size());
+	size_t misses = 0;
+	for (size_t ix = 0; ix < triCount * 3; ix++) {
+		auto it = loadedAt.find(indices[ix]);
+		if (it == loadedAt.end() || misses - it->second > cacheSize) {
+			loadedAt[indices[ix]] = misses;
+			misses++;
+		}
+	}
+	return static_cast<float>(misses) / triCount;
+}
+
+bool MeshOptimizer::NarrowIndices(const uint32_t* indices, size_t count, size_t vertexCount, std::vector<uint16_t>& result) {
+	result.clear();
+	if (vertexCount > UINT16_MAX) {
+		return false;
+	}
+	result.resize(count);
+	for (size_t ix = 0; ix < count; ix++) {
+		result[ix] = static_cast<uint16_t>(indices[ix]);
+	}
+	return true;
+}
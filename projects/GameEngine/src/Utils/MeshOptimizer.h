@@ -0,0 +1,125 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <GLM/glm.hpp>
+
+#include "Utils/MeshBuilder.h"
+
+/// <summary>
+/// The results of optimizing a mesh, ACMR is the average number of vertex shader invocations
+/// per triangle (lower is better, 0.5 is the ideal and 3 is no reuse at all)
+/// </summary>
+struct MeshOptimizerStats {
+	size_t NumVertices = 0;
+	size_t NumIndices  = 0;
+	float  AcmrBefore  = 0.0f;
+	float  AcmrAfter   = 0.0f;
+};
+
+/// <summary>
+/// Utilities for preparing indexed meshes for rendering, all of which are CPU only and can be run
+/// at cook time or on a worker thread during a load
+///
+/// The reordering only depends on the index buffer, so meshes with the same topology (ex: the
+/// frames of a morph animation) always end up with matching vertex orders
+/// </summary>
+class MeshOptimizer {
+public:
+	/// <summary>
+	/// The size of the vertex cache we optimize for, any modern GPU has at least this much reuse
+	/// </summary>
+	static constexpr uint32_t VERTEX_CACHE_SIZE = 32;
+	/// <summary>
+	/// The size of the FIFO cache that ACMR is measured with
+	/// </summary>
+	static constexpr uint32_t ACMR_CACHE_SIZE = 16;
+
+	/// <summary>
+	/// Merges triangle corners that use the same attributes into a single vertex
+	/// </summary>
+	/// <param name="corners">The attribute indices of every triangle corner, 3 per triangle</param>
+	/// <param name="indices">Receives an index into uniqueCorners for every corner</param>
+	/// <param name="uniqueCorners">Receives the attribute indices of every unique vertex, in order of first use</param>
+	static void WeldCorners(const std::vector<glm::ivec3>& corners, std::vector<uint32_t>& indices, std::vector<glm::ivec3>& uniqueCorners);
+
+	/// <summary>
+	/// Reorders the triangles in an index buffer so that vertices are re-used while they are still in the
+	/// post-transform cache, using Tom Forsyth's linear-speed vertex cache optimization
+	/// </summary>
+	/// <param name="indices">The triangle list to reorder, in place</param>
+	/// <param name="vertexCount">The number of vertices the indices refer to</param>
+	static void OptimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount);
+	/// <summary>
+	/// Renumbers vertices in the order they are first used by the index buffer, so that vertex fetches
+	/// walk forward through memory. Vertices that are never used are dropped
+	/// </summary>
+	/// <param name="indices">The triangle list to renumber, in place</param>
+	/// <param name="vertexCount">The number of vertices the indices refer to</param>
+	/// <param name="remap">Receives the new index of every old vertex, or UINT32_MAX if it was dropped</param>
+	/// <returns>The number of vertices after the remap</returns>
+	static size_t OptimizeVertexFetch(std::vector<uint32_t>& indices, size_t vertexCount, std::vector<uint32_t>& remap);
+	/// <summary>
+	/// Runs the cache and fetch optimizations on an index buffer, and measures the ACMR before and after
+	/// </summary>
+	/// <param name="indices">The triangle list to optimize, in place</param>
+	/// <param name="vertexCount">The number of vertices the indices refer to</param>
+	/// <param name="remap">Receives the new index of every old vertex, pass to RemapVertices</param>
+	static MeshOptimizerStats OptimizeIndices(std::vector<uint32_t>& indices, size_t vertexCount, std::vector<uint32_t>& remap);
+
+	/// <summary>
+	/// Calculates the average cache miss ratio of a triangle list, by simulating a FIFO vertex cache
+	/// </summary>
+	/// <param name="indices">The triangle list to measure</param>
+	/// <param name="cacheSize">The number of entries in the simulated cache</param>
+	/// <returns>The number of cache misses per triangle</returns>
+	static float CalculateACMR(const std::vector<uint32_t>& indices, uint32_t cacheSize = ACMR_CACHE_SIZE);
+
+	/// <summary>
+	/// Copies the indices into 16 bit indices, if every index will fit
+	/// </summary>
+	/// <param name="indices">The indices to narrow</param>
+	/// <param name="count">The number of indices</param>
+	/// <param name="vertexCount">The number of vertices the indices refer to</param>
+	/// <param name="result">Receives the 16 bit indices</param>
+	/// <returns>True if the indices were narrowed, false if the mesh needs 32 bit indices</returns>
+	static bool NarrowIndices(const uint32_t* indices, size_t count, size_t vertexCount, std::vector<uint16_t>& result);
+
+	/// <summary>
+	/// Applies a remap from OptimizeVertexFetch to a list of vertices (or anything else stored per vertex)
+	/// </summary>
+	template <typename T>
+	static void RemapVertices(std::vector<T>& vertices, const std::vector<uint32_t>& remap, size_t newCount) {
+		std::vector<T> result(newCount);
+		for (size_t ix = 0; ix < vertices.size() && ix < remap.size(); ix++) {
+			if (remap[ix] != UINT32_MAX) {
+				result[remap[ix]] = vertices[ix];
+			}
+		}
+		vertices.swap(result);
+	}
+
+	/// <summary>
+	/// Reorders an indexed mesh's triangles for the vertex cache, and its vertices for fetch locality.
+	/// Meshes without indices are left as is
+	/// </summary>
+	/// <typeparam name="VertType">The type of vertex that the mesh is using</typeparam>
+	/// <param name="mesh">The mesh to optimize, in place</param>
+	template <typename VertType>
+	static MeshOptimizerStats Optimize(MeshBuilder<VertType>& mesh) {
+		if (mesh._indices.empty()) {
+			MeshOptimizerStats result;
+			result.NumVertices = mesh._vertices.size();
+			return result;
+		}
+		std::vector<uint32_t> remap;
+		MeshOptimizerStats result = OptimizeIndices(mesh._indices, mesh._vertices.size(), remap);
+		RemapVertices(mesh._vertices, remap, result.NumVertices);
+		return result;
+	}
+
+protected:
+	MeshOptimizer() = default;
+	~MeshOptimizer() = default;
+};
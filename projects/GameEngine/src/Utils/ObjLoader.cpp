@@ -7,8 +7,22 @@
 #include <GLFW/glfw3.h>
 #include <filesystem>
 
+#include "Utils/AssetPipeline.h"
+#include "Utils/AsyncLoader.h"
 #include "Utils/StringUtils.h"
 
+namespace {
+	// The contents of an OBJ file, before they have been uploaded
+	struct ObjFileData {
+		ObjMeshData                      Obj;
+		std::vector<VertexPosNormTexCol> Vertices;
+		std::vector<uint32_t>            Indices;
+		// Filled in instead of Indices when every vertex can be addressed with 16 bits
+		std::vector<uint16_t>            ShortIndices;
+		MeshOptimizerStats               Stats;
+	};
+}
+
 VertexArrayObject::Sptr ObjLoader::LoadFromFile(const std::string& filename)
 {
 	if (!std::filesystem::exists(filename)) {
@@ -16,121 +30,74 @@ VertexArrayObject::Sptr ObjLoader::LoadFromFile(const std::string& filename)
 		return nullptr;
 	}
 
-	// Open our file in binary mode
-	std::ifstream file;
-	file.open(filename, std::ios::binary);
-
-	// If our file fails to open, we will throw an error
-	if (!file) {
-		throw std::runtime_error("Failed to open file");
-	}
-
-	std::string line;
-	
-	// TODO: Load data from file
-	std::vector<glm::vec3> positions;
-	std::vector<glm::vec3> normals;
-	std::vector<glm::vec2> uvs;
-	std::vector<glm::ivec3> vertices;
-
-	glm::vec3 vecData;
-	glm::ivec3 vertexIndices;
-
 	float startTime = glfwGetTime();
 
-	// Read and process the entire file
-	while (file.peek() != EOF) {
-		// Read in the first part of the line (ex: f, v, vn, etc...)
-		std::string command;
-		file >> command;
-
-		// We will ignore the rest of the line for comment lines
-		if (command == "#") {
-			std::getline(file, line);
+	// Reading and parsing the file doesn't need the GL context, so it can happen on a worker
+	// if we're part of a background load
+	std::shared_ptr<ObjFileData> data = std::make_shared<ObjFileData>();
+	auto decode = [data, filename]() {
+		// If our file fails to open, we will throw an error
+		if (!ObjParser::ParseFile(filename, data->Obj)) {
+			throw std::runtime_error("Failed to open file");
 		}
 
-		// The v command defines a vertex's position
-		else if (command == "v") {
-			// Read in and store a position
-			file >> vecData.x >> vecData.y >> vecData.z;
-			positions.push_back(vecData);
-		}
-		// TODO: handle normals and textures
-		else if (command == "vn") {
-			// Read in and store a position
-			file >> vecData.x >> vecData.y >> vecData.z;
-			normals.push_back(vecData);
-		} 
-		else if (command == "vt") {
-			// Read in and store a position
-			file >> vecData.x >> vecData.y;
-			uvs.push_back(vecData);
+		// Merge corners that share the same attributes, and reorder them for the vertex cache
+		std::vector<glm::ivec3> corners;
+		MeshOptimizer::WeldCorners(data->Obj.Corners, data->Indices, corners);
+		std::vector<uint32_t> remap;
+		data->Stats = MeshOptimizer::OptimizeIndices(data->Indices, corners.size(), remap);
+		MeshOptimizer::RemapVertices(corners, remap, data->Stats.NumVertices);
+
+		_BuildVertices(data->Obj, corners, data->Vertices);
+		if (MeshOptimizer::NarrowIndices(data->Indices.data(), data->Indices.size(), data->Vertices.size(), data->ShortIndices)) {
+			data->Indices.clear();
 		}
+	};
 
-		// The f command defines a polygon in the mesh
-		// NOTE: make sure you triangulate in blender, otherwise it will
-		// output quads instead of triangles
-		else if (command == "f") {
-			// Read the rest of the line from the file
-			std::getline(file, line);
-			// Trim whitespace from either end of the line
-			StringTools::Trim(line);
-			// Create a string stream so we can use streaming operators on it
-			std::stringstream stream = std::stringstream(line);
-
-			// We'll support only triangles
-			for (int ix = 0; ix < 3; ix++) {
-				// Read in the 3 attributes (position, UV, normal)
-				char separator;
-				stream >> vertexIndices.x >> separator >> vertexIndices.y >> separator >> vertexIndices.z;
-
-				// The OBJ format can have negative values, which are a reference from the last added attributes
-				if (vertexIndices.x < 0) { vertexIndices.x = positions.size() + 1 + vertexIndices.x; }
-				if (vertexIndices.y < 0) { vertexIndices.y = uvs.size()       + 1 + vertexIndices.y; }
-				if (vertexIndices.z < 0) { vertexIndices.z = normals.size()   + 1 + vertexIndices.z; }
-
-				// OBJ format uses 1-based indices
-				vertexIndices -= glm::ivec3(1);
-
-				// add the vertex indices to the list
-				// NOTE: This will create duplicate vertices!
-				// A smarter solution would create a map of what attribute
-				// combos have already been added
-				vertices.push_back(vertexIndices);
-			}
+	VertexArrayObject::Sptr result = VertexArrayObject::Create();
+	auto upload = [vao = result.get(), data, filename, startTime]() {
+		// Create a vertex buffer and load all our vertex data
+		VertexBuffer::Sptr vertexBuffer = VertexBuffer::Create();
+		vertexBuffer->LoadData(data->Vertices.data(), data->Vertices.size());
+
+		// Create an index buffer with the smallest index type that fits
+		IndexBuffer::Sptr indexBuffer = nullptr;
+		if (!data->ShortIndices.empty()) {
+			indexBuffer = IndexBuffer::Create();
+			indexBuffer->LoadData(data->ShortIndices.data(), static_cast<uint32_t>(data->ShortIndices.size()));
+		} else if (!data->Indices.empty()) {
+			indexBuffer = IndexBuffer::Create();
+			indexBuffer->LoadData(data->Indices.data(), static_cast<uint32_t>(data->Indices.size()));
 		}
-	}
 
-	// TODO: Generate mesh from the data we loaded
-	std::vector<VertexPosNormTexCol> vertexData;
+		// Add the vertices and indices to the VAO
+		vao->AddVertexBuffer(vertexBuffer, VertexPosNormTexCol::V_DECL);
+		vao->SetIndexBuffer(indexBuffer);
 
-	for (int ix = 0; ix < vertices.size(); ix++) {
-		glm::ivec3 attribs = vertices[ix];
+		vao->SetVDecl(VertexPosNormTexCol::V_DECL);
+		vao->SetBounds(Bounds::FromPoints(data->Obj.Positions.data(), data->Obj.Positions.size()));
 
-		// Extract attributes from lists (except color)
-		glm::vec3 position = positions[attribs.x];
-		glm::vec2 uv       = uvs[attribs.y];
-		glm::vec3 normal   = normals[attribs.z];
-		glm::vec4 color    = glm::vec4(1.0f);
+		// Calculate and trace out how long it took us to load
+		float endTime = glfwGetTime();
+		LOG_TRACE("Loaded OBJ file \"{}\" in {} seconds ({} vertices, {} indices, ACMR {:.3f} -> {:.3f})", filename, endTime - startTime, data->Vertices.size(), data->Stats.NumIndices, data->Stats.AcmrBefore, data->Stats.AcmrAfter);
+	};
 
-		// Add the vertex to the mesh
-		vertexData.push_back(VertexPosNormTexCol(position, normal, uv, color));
+	// Inside a batch the VAO is handed back empty, and gets filled in once the file has been parsed
+	if (AssetPipeline::IsBatching()) {
+		AssetPipeline::Enqueue(result, decode, upload);
+	} else {
+		AsyncLoader::RunInBackground(decode);
+		upload();
 	}
 
-	// Create a vertex buffer and load all our vertex data
-	VertexBuffer::Sptr vertexBuffer = VertexBuffer::Create();
-	vertexBuffer->LoadData(vertexData.data(), vertexData.size());
-
-	// Create the VAO, and add the vertices
-	VertexArrayObject::Sptr result = VertexArrayObject::Create();
-	result->AddVertexBuffer(vertexBuffer, VertexPosNormTexCol::V_DECL);
-
-	result->SetVDecl(VertexPosNormTexCol::V_DECL);
-	
-	// Calculate and trace out how long it took us to load
-	float endTime = glfwGetTime();
-	LOG_TRACE("Loaded OBJ file \"{}\" in {} seconds ({} vertices, {} indices)", filename, endTime - startTime, vertexData.size(), 0);
-
 	return result;
 	//return VertexArrayObject::Create();
 }
+
+void ObjLoader::_BuildVertices(const ObjMeshData& obj, const std::vector<glm::ivec3>& corners, std::vector<VertexPosNormTexCol>& vertexData)
+{
+	vertexData.reserve(vertexData.size() + corners.size());
+	for (const glm::ivec3& corner : corners) {
+		vertexData.push_back(VertexPosNormTexCol(obj.GetPosition(corner), obj.GetNormal(corner), obj.GetUV(corner), glm::vec4(1.0f)));
+	}
+}
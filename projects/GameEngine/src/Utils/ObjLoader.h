@@ -2,6 +2,8 @@
 
 #include "MeshBuilder.h"
 #include "MeshFactory.h"
+#include "MeshOptimizer.h"
+#include "ObjParser.h"
 
 class ObjLoader
 {
@@ -9,6 +11,15 @@ public:
 	static VertexArrayObject::Sptr LoadFromFile(const std::string& filename);
 
 protected:
+	/// <summary>
+	/// Creates a vertex for every unique corner of a parsed OBJ file, does not touch the GL context
+	/// so it can be run on any thread
+	/// </summary>
+	/// <param name="obj">The parsed contents of the OBJ file</param>
+	/// <param name="corners">The attribute indices of each vertex to create</param>
+	/// <param name="vertexData">The list to append the vertices to</param>
+	static void _BuildVertices(const ObjMeshData& obj, const std::vector<glm::ivec3>& corners, std::vector<VertexPosNormTexCol>& vertexData);
+
 	ObjLoader() = default;
 	~ObjLoader() = default;
 };
\ No newline at end of file
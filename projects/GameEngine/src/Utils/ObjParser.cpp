@@ -0,0 +1,213 @@
+#include "Utils/ObjParser.h"
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#include "Utils/MemoryMappedFile.h"
+
+namespace {
+	inline bool IsBlank(char c) {
+		return c == ' ' || c == '\t' || c == '\r';
+	}
+
+	inline const char* SkipBlanks(const char* it, const char* end) {
+		while (it < end && IsBlank(*it)) {
+			it++;
+		}
+		return it;
+	}
+
+	// Parses the next float on the line, leaving the value untouched if there isn't one
+	inline const char* ParseFloat(const char* it, const char* end, float& value) {
+		it = SkipBlanks(it, end);
+		// from_chars doesn't accept a leading plus sign
+		if (it < end && *it == '+') {
+			it++;
+		}
+		std::from_chars_result parsed = std::from_chars(it, end, value);
+		return parsed.ec == std::errc() ? parsed.ptr : it;
+	}
+
+	// Parses an index and converts it to be 0 based, negative indices count back from the end of the list so far
+	inline const char* ParseIndex(const char* it, const char* end, size_t count, int& index) {
+		int value = 0;
+		std::from_chars_result parsed = std::from_chars(it, end, value);
+		if (parsed.ec != std::errc()) {
+			index = -1;
+			return it;
+		}
+		index = value > 0 ? value - 1 : (value < 0 ? static_cast<int>(count) + value : -1);
+		return parsed.ptr;
+	}
+}
+
+void ObjMeshData::Clear() {
+	Positions.clear();
+	UVs.clear();
+	Normals.clear();
+	Corners.clear();
+}
+
+bool ObjParser::ParseFile(const std::string& filename, ObjMeshData& result) {
+	std::error_code error;
+	uintmax_t size = std::filesystem::file_size(filename, error);
+	if (error) {
+		return false;
+	}
+
+	if (size < STREAMING_THRESHOLD) {
+		MemoryMappedFile file;
+		if (file.Open(filename)) {
+			Parse(reinterpret_cast<const char*>(file.Data()), file.Size(), result);
+			return true;
+		}
+	}
+
+	// Huge files, or ones we couldn't map (ex: empty files), get read in chunks instead
+	std::ifstream stream(filename, std::ios::binary);
+	if (!stream) {
+		return false;
+	}
+	return ParseStream(stream, result);
+}
+
+void ObjParser::Parse(const char* data, size_t size, ObjMeshData& result) {
+	result.Clear();
+
+	std::vector<glm::ivec3> faceCorners;
+	const char* end = data + size;
+	const char* rest = _ParseLines(data, end, result, faceCorners);
+
+	// The last line may not have a newline at the end
+	if (rest < end) {
+		_ParseLine(rest, end, result, faceCorners);
+	}
+}
+
+bool ObjParser::ParseStream(std::istream& stream, ObjMeshData& result, size_t chunkSize) {
+	result.Clear();
+
+	std::vector<glm::ivec3> faceCorners;
+	std::vector<char> buffer(chunkSize > 0 ? chunkSize : DEFAULT_CHUNK_SIZE);
+	// The number of bytes at the start of the buffer that belong to a line that didn't fit in the last chunk
+	size_t carried = 0;
+
+	while (true) {
+		// A single line longer than the whole buffer, make room for the rest of it
+		if (carried == buffer.size()) {
+			buffer.resize(buffer.size() * 2);
+		}
+
+		stream.read(buffer.data() + carried, buffer.size() - carried);
+		size_t numRead = static_cast<size_t>(stream.gcount());
+		if (numRead == 0) {
+			// Whatever is left is the last line in the file
+			if (carried > 0) {
+				_ParseLine(buffer.data(), buffer.data() + carried, result, faceCorners);
+			}
+			break;
+		}
+
+		const char* end = buffer.data() + carried + numRead;
+		const char* rest = _ParseLines(buffer.data(), end, result, faceCorners);
+
+		// Move the partial line to the front, the next chunk will finish it
+		carried = static_cast<size_t>(end - rest);
+		memmove(buffer.data(), rest, carried);
+	}
+
+	return !stream.bad();
+}
+
+const char* ObjParser::_ParseLines(const char* begin, const char* end, ObjMeshData& result, std::vector<glm::ivec3>& faceCorners) {
+	const char* it = begin;
+	while (it < end) {
+		const char* lineEnd = static_cast<const char*>(memchr(it, '\n', static_cast<size_t>(end - it)));
+		if (lineEnd == nullptr) {
+			break;
+		}
+		_ParseLine(it, lineEnd, result, faceCorners);
+		it = lineEnd + 1;
+	}
+	return it;
+}
+
+void ObjParser::_ParseLine(const char* begin, const char* end, ObjMeshData& result, std::vector<glm::ivec3>& faceCorners) {
+	const char* it = SkipBlanks(begin, end);
+	if (it == end || *it == '#') {
+		return;
+	}
+
+	// Find the end of the command (ex: f, v, vn, etc...)
+	const char* command = it;
+	while (it < end && !IsBlank(*it)) {
+		it++;
+	}
+	const size_t commandLength = static_cast<size_t>(it - command);
+
+	// The v command defines a vertex's position, anything after the first 3 values (w, vertex colors) is ignored
+	if (commandLength == 1 && command[0] == 'v') {
+		glm::vec3 position = glm::vec3(0.0f);
+		it = ParseFloat(it, end, position.x);
+		it = ParseFloat(it, end, position.y);
+		ParseFloat(it, end, position.z);
+		result.Positions.push_back(position);
+	}
+	else if (commandLength == 2 && command[0] == 'v' && command[1] == 't') {
+		glm::vec2 uv = glm::vec2(0.0f);
+		it = ParseFloat(it, end, uv.x);
+		ParseFloat(it, end, uv.y);
+		result.UVs.push_back(uv);
+	}
+	else if (commandLength == 2 && command[0] == 'v' && command[1] == 'n') {
+		glm::vec3 normal = glm::vec3(0.0f);
+		it = ParseFloat(it, end, normal.x);
+		it = ParseFloat(it, end, normal.y);
+		ParseFloat(it, end, normal.z);
+		result.Normals.push_back(normal);
+	}
+
+	// The f command defines a polygon in the mesh, each corner is v, v/vt, v//vn or v/vt/vn
+	else if (commandLength == 1 && command[0] == 'f') {
+		faceCorners.clear();
+		while (true) {
+			it = SkipBlanks(it, end);
+			if (it >= end) {
+				break;
+			}
+
+			glm::ivec3 corner = glm::ivec3(-1);
+			const char* next = ParseIndex(it, end, result.Positions.size(), corner.x);
+			// Not an index, ignore the rest of the line
+			if (next == it) {
+				break;
+			}
+			it = next;
+
+			if (it < end && *it == '/') {
+				it++;
+				if (it < end && *it != '/') {
+					it = ParseIndex(it, end, result.UVs.size(), corner.y);
+				}
+				if (it < end && *it == '/') {
+					it++;
+					it = ParseIndex(it, end, result.Normals.size(), corner.z);
+				}
+			}
+
+			// Skip anything else in this corner that we didn't understand
+			while (it < end && !IsBlank(*it)) {
+				it++;
+			}
+			faceCorners.push_back(corner);
+		}
+
+		// Triangulate as a fan around the first corner, which covers the convex polygons that exporters write out
+		for (size_t ix = 2; ix < faceCorners.size(); ix++) {
+			result.Corners.push_back(faceCorners[0]);
+			result.Corners.push_back(faceCorners[ix - 1]);
+			result.Corners.push_back(faceCorners[ix]);
+		}
+	}
+}
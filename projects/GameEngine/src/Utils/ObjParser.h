@@ -0,0 +1,97 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+
+#include <GLM/glm.hpp>
+
+/// <summary>
+/// The raw contents of an OBJ file, as read by ObjParser. Faces are triangulated, and every
+/// corner of every triangle is stored as a set of indices into the attribute lists
+/// </summary>
+struct ObjMeshData {
+	std::vector<glm::vec3>  Positions;
+	std::vector<glm::vec2>  UVs;
+	std::vector<glm::vec3>  Normals;
+	/// <summary>
+	/// Three entries per triangle, holding the 0 based position, UV and normal index of each
+	/// corner. Attributes that the face did not specify are -1
+	/// </summary>
+	std::vector<glm::ivec3> Corners;
+
+	void Clear();
+
+	/// <summary>
+	/// Gets the position of a corner, or zero if it is missing or out of range
+	/// </summary>
+	glm::vec3 GetPosition(const glm::ivec3& corner) const {
+		return corner.x >= 0 && static_cast<size_t>(corner.x) < Positions.size() ? Positions[corner.x] : glm::vec3(0.0f);
+	}
+	/// <summary>
+	/// Gets the UV of a corner, or zero if it is missing or out of range
+	/// </summary>
+	glm::vec2 GetUV(const glm::ivec3& corner) const {
+		return corner.y >= 0 && static_cast<size_t>(corner.y) < UVs.size() ? UVs[corner.y] : glm::vec2(0.0f);
+	}
+	/// <summary>
+	/// Gets the normal of a corner, or the fallback if it is missing or out of range
+	/// </summary>
+	glm::vec3 GetNormal(const glm::ivec3& corner, const glm::vec3& fallback = glm::vec3(0.0f, 0.0f, 1.0f)) const {
+		return corner.z >= 0 && static_cast<size_t>(corner.z) < Normals.size() ? Normals[corner.z] : fallback;
+	}
+};
+
+/// <summary>
+/// Parses OBJ files without going through iostreams. The file is mapped (or read in large chunks when
+/// streaming), lines are found with memchr and numbers are parsed in place with std::from_chars, so no
+/// strings or streams get created per line
+///
+/// Supports v, vt, vn and f commands, with faces of any size (quads and n-gons are triangulated as a fan)
+/// and negative (relative) indices. Everything else (o, g, s, usemtl, comments, etc...) is skipped
+/// </summary>
+class ObjParser {
+public:
+	/// <summary>
+	/// Files larger than this are streamed rather than mapped, so we don't need to keep the whole file resident
+	/// </summary>
+	static constexpr size_t STREAMING_THRESHOLD = 256 * 1024 * 1024;
+	/// <summary>
+	/// The number of bytes that are read at a time when streaming
+	/// </summary>
+	static constexpr size_t DEFAULT_CHUNK_SIZE = 1024 * 1024;
+
+	/// <summary>
+	/// Parses the OBJ file at the given path, mapping it if possible and streaming it otherwise
+	/// </summary>
+	/// <param name="filename">The path of the file to parse</param>
+	/// <param name="result">The data to fill in, any existing contents are cleared</param>
+	/// <returns>True if the file could be opened, false if not</returns>
+	static bool ParseFile(const std::string& filename, ObjMeshData& result);
+	/// <summary>
+	/// Parses OBJ data that is already in memory
+	/// </summary>
+	/// <param name="data">The text of the OBJ file</param>
+	/// <param name="size">The size of the text, in bytes</param>
+	/// <param name="result">The data to fill in, any existing contents are cleared</param>
+	static void Parse(const char* data, size_t size, ObjMeshData& result);
+	/// <summary>
+	/// Parses an OBJ file from a stream, reading it a chunk at a time. Only a single chunk of the file's text is
+	/// held in memory at once, for files that are too large to comfortably map
+	/// </summary>
+	/// <param name="stream">The stream to read from, should be opened in binary mode</param>
+	/// <param name="result">The data to fill in, any existing contents are cleared</param>
+	/// <param name="chunkSize">The number of bytes to read at a time</param>
+	/// <returns>True if the stream was read without errors</returns>
+	static bool ParseStream(std::istream& stream, ObjMeshData& result, size_t chunkSize = DEFAULT_CHUNK_SIZE);
+
+protected:
+	ObjParser() = default;
+	~ObjParser() = default;
+
+	// Parses a single line, end points to the character after the last one on the line
+	static void _ParseLine(const char* begin, const char* end, ObjMeshData& result, std::vector<glm::ivec3>& faceCorners);
+	// Parses every complete line in the range, returns a pointer to the start of any partial line at the end
+	static const char* _ParseLines(const char* begin, const char* end, ObjMeshData& result, std::vector<glm::ivec3>& faceCorners);
+};
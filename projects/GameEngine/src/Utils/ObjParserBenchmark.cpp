@@ -0,0 +1,137 @@
+#include "Utils/ObjParserBenchmark.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <sstream>
+#include <vector>
+
+#include "Logging.h"
+#include "Utils/ObjParser.h"
+#include "Utils/StringUtils.h"
+
+namespace {
+	// The parser ObjLoader used to use, reading with stream operators and a stringstream per face
+	void LegacyParse(std::istream& file, ObjMeshData& result) {
+		result.Clear();
+
+		std::string line;
+		glm::vec3 vecData;
+		glm::ivec3 vertexIndices;
+
+		while (file.peek() != EOF) {
+			std::string command;
+			file >> command;
+
+			if (command == "#") {
+				std::getline(file, line);
+			}
+			else if (command == "v") {
+				file >> vecData.x >> vecData.y >> vecData.z;
+				result.Positions.push_back(vecData);
+			}
+			else if (command == "vn") {
+				file >> vecData.x >> vecData.y >> vecData.z;
+				result.Normals.push_back(vecData);
+			}
+			else if (command == "vt") {
+				file >> vecData.x >> vecData.y;
+				result.UVs.push_back(vecData);
+			}
+			else if (command == "f") {
+				std::getline(file, line);
+				StringTools::Trim(line);
+				std::stringstream stream = std::stringstream(line);
+
+				for (int ix = 0; ix < 3; ix++) {
+					char separator;
+					stream >> vertexIndices.x >> separator >> vertexIndices.y >> separator >> vertexIndices.z;
+
+					if (vertexIndices.x < 0) { vertexIndices.x = static_cast<int>(result.Positions.size()) + 1 + vertexIndices.x; }
+					if (vertexIndices.y < 0) { vertexIndices.y = static_cast<int>(result.UVs.size())       + 1 + vertexIndices.y; }
+					if (vertexIndices.z < 0) { vertexIndices.z = static_cast<int>(result.Normals.size())   + 1 + vertexIndices.z; }
+
+					vertexIndices -= glm::ivec3(1);
+					result.Corners.push_back(vertexIndices);
+				}
+			}
+		}
+	}
+
+	// Runs the parse the given number of times, and returns the fastest time in milliseconds
+	double TimeParse(int iterations, const std::function<void()>& parse) {
+		double best = std::numeric_limits<double>::max();
+		for (int ix = 0; ix < iterations; ix++) {
+			auto start = std::chrono::steady_clock::now();
+			parse();
+			std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+			best = std::min(best, elapsed.count());
+		}
+		return best;
+	}
+
+	double Throughput(uintmax_t bytes, double milliseconds) {
+		return milliseconds > 0.0 ? (bytes / (1024.0 * 1024.0)) / (milliseconds / 1000.0) : 0.0;
+	}
+}
+
+void ObjParserBenchmark::Run(const std::string& directory, int iterations) {
+	iterations = std::max(iterations, 1);
+
+	std::vector<std::filesystem::path> files;
+	std::error_code error;
+	for (auto it = std::filesystem::recursive_directory_iterator(directory, error); !error && it != std::filesystem::recursive_directory_iterator(); it.increment(error)) {
+		if (it->is_regular_file() && it->path().extension() == ".obj") {
+			files.push_back(it->path());
+		}
+	}
+	std::sort(files.begin(), files.end());
+
+	if (files.empty()) {
+		LOG_WARN("No OBJ files found in \"{}\" to benchmark", directory);
+		return;
+	}
+
+	LOG_INFO("Benchmarking OBJ parsing on {} files, best of {} runs", files.size(), iterations);
+
+	ObjMeshData data;
+	uintmax_t totalBytes = 0;
+	double totalLegacy = 0.0, totalMapped = 0.0, totalStreamed = 0.0;
+
+	for (const std::filesystem::path& path : files) {
+		const std::string filename = path.string();
+		const uintmax_t bytes = std::filesystem::file_size(path, error);
+		if (error) {
+			continue;
+		}
+
+		double legacy = TimeParse(iterations, [&]() {
+			std::ifstream file(filename);
+			LegacyParse(file, data);
+		});
+		double mapped = TimeParse(iterations, [&]() {
+			ObjParser::ParseFile(filename, data);
+		});
+		double streamed = TimeParse(iterations, [&]() {
+			std::ifstream file(filename, std::ios::binary);
+			ObjParser::ParseStream(file, data);
+		});
+
+		LOG_INFO("  {}: {:.2f} KB, {} triangles", filename, bytes / 1024.0, data.Corners.size() / 3);
+		LOG_INFO("    legacy   {:8.3f} ms ({:7.1f} MB/s)", legacy, Throughput(bytes, legacy));
+		LOG_INFO("    mapped   {:8.3f} ms ({:7.1f} MB/s) {:5.1f}x", mapped, Throughput(bytes, mapped), legacy / mapped);
+		LOG_INFO("    streamed {:8.3f} ms ({:7.1f} MB/s) {:5.1f}x", streamed, Throughput(bytes, streamed), legacy / streamed);
+
+		totalBytes += bytes;
+		totalLegacy += legacy;
+		totalMapped += mapped;
+		totalStreamed += streamed;
+	}
+
+	LOG_INFO("OBJ parsing totals for {:.2f} MB:", totalBytes / (1024.0 * 1024.0));
+	LOG_INFO("  legacy   {:8.3f} ms ({:7.1f} MB/s)", totalLegacy, Throughput(totalBytes, totalLegacy));
+	LOG_INFO("  mapped   {:8.3f} ms ({:7.1f} MB/s) {:5.1f}x", totalMapped, Throughput(totalBytes, totalMapped), totalLegacy / totalMapped);
+	LOG_INFO("  streamed {:8.3f} ms ({:7.1f} MB/s) {:5.1f}x", totalStreamed, Throughput(totalBytes, totalStreamed), totalLegacy / totalStreamed);
+}
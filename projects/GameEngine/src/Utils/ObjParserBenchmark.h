@@ -0,0 +1,22 @@
+#pragma once
+#include <string>
+
+/// <summary>
+/// Times the OBJ parsers against each other on the meshes in a directory, and logs the results.
+/// The legacy parser is the iostream based one that ObjLoader used before ObjParser existed,
+/// kept here only so that we have something to compare against
+/// </summary>
+class ObjParserBenchmark {
+public:
+	/// <summary>
+	/// Parses every OBJ file under the given directory with each parser, and logs the time
+	/// taken, throughput, and speedup over the legacy parser for each file and in total
+	/// </summary>
+	/// <param name="directory">The directory to search for OBJ files, recursively</param>
+	/// <param name="iterations">The number of times to parse each file with each parser, the fastest run is kept</param>
+	static void Run(const std::string& directory = ".", int iterations = 3);
+
+protected:
+	ObjParserBenchmark() = default;
+	~ObjParserBenchmark() = default;
+};
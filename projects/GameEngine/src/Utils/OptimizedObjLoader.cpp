@@ -2,13 +2,21 @@
 
 #include "ObjLoader.h"
 
+#include <cstring>
 #include <string>
 #include <sstream>
 #include <fstream>
 #include <iostream>
 #include <filesystem>
+#include <mutex>
+#include <unordered_map>
 
 #include "Utils/StringUtils.h"
+#include "Utils/AssetPipeline.h"
+#include "Utils/AsyncLoader.h"
+#include "Utils/MemoryMappedFile.h"
+#include "Utils/MeshOptimizer.h"
+#include "Utils/ObjParser.h"
 #include "GLFW/glfw3.h"
 #include "Logging.h"
 
@@ -17,37 +25,146 @@ const std::string binaryExtension = ".bin";
 
 namespace fs = std::filesystem;
 
+struct OptimizedObjLoader::MappedMesh {
+	MemoryMappedFile    File;
+	const BinaryHeader* Header = nullptr;
+};
+
+namespace {
+	// Only one thread should check or re-build a given binary file at a time
+	std::mutex cookLocksMutex;
+	std::unordered_map<std::string, std::shared_ptr<std::mutex>> cookLocks;
+
+	std::shared_ptr<std::mutex> GetCookLock(const std::string& binFile) {
+		std::string key = fs::path(binFile).lexically_normal().generic_string();
+		std::lock_guard<std::mutex> lock(cookLocksMutex);
+		std::shared_ptr<std::mutex>& result = cookLocks[key];
+		if (result == nullptr) {
+			result = std::make_shared<std::mutex>();
+		}
+		return result;
+	}
+
+	// 64 bit FNV-1a hash of a file's contents, or 0 if it could not be read
+	uint64_t HashFile(const std::string& filename) {
+		MemoryMappedFile file;
+		if (!file.Open(filename)) {
+			return 0;
+		}
+		uint64_t hash = 0xcbf29ce484222325ull;
+		const uint8_t* data = file.Data();
+		for (size_t ix = 0; ix < file.Size(); ix++) {
+			hash ^= data[ix];
+			hash *= 0x100000001b3ull;
+		}
+		return hash;
+	}
+
+	int64_t GetModifiedTime(const std::string& filename) {
+		std::error_code error;
+		return static_cast<int64_t>(fs::last_write_time(filename, error).time_since_epoch().count());
+	}
+
+	uint32_t AlignOffset(size_t offset, uint32_t alignment) {
+		return static_cast<uint32_t>((offset + alignment - 1) / alignment * alignment);
+	}
+}
+
 VertexArrayObject::Sptr OptimizedObjLoader::LoadFromFile(const std::string& filename) {
 	// Get the file extension and lowercase it
 	fs::path filePath = std::filesystem::path(filename);
 	std::string extension = filePath.extension().string();
 	StringTools::ToLower(extension);
 
-	// Load regular 'ol OBJ files
+	std::string objFile;
+	std::string binFile;
+	// Load regular 'ol OBJ files, via their binary file
 	if (extension == ".obj") {
-		// Get the binary path
-		fs::path binPath = filePath.replace_extension(binaryExtension);
-		// If the file does not exist, convert the OBJ file to a binary file
-		if (!fs::exists(binPath)) {
-			ConvertToBinary(filename, binPath.string());
-		}
-		// Load the corresponding binary file
-		return _LoadFromBinFile(binPath.string());
+		objFile = filename;
+		binFile = filePath.replace_extension(binaryExtension).string();
 	} 
 	// Load our fancy binary files
 	else if (extension == ".bin") {
-		return _LoadFromBinFile(filename);
+		binFile = filename;
 	}
 	// We've never met this extension in our life
 	else {
 		LOG_WARN("Cannot load model from \"{}\"", filename);
 		return nullptr;
 	}
+
+	// A missing mesh shouldn't take the rest of the load down with it
+	std::error_code error;
+	if ((objFile.empty() || !fs::exists(objFile, error)) && !fs::exists(binFile, error)) {
+		LOG_WARN("Failed to find mesh file: \"{}\"", filename);
+		return nullptr;
+	}
+
+	float startTime = static_cast<float>(glfwGetTime());
+
+	// Converting and mapping the file doesn't need the GL context, so it can happen on a worker
+	std::shared_ptr<MappedMesh> mesh = std::make_shared<MappedMesh>();
+	auto decode = [mesh, objFile, binFile]() {
+		try {
+			if (!objFile.empty()) {
+				_CookObjFile(objFile, binFile);
+			}
+			if (!_MapBinFile(binFile, *mesh) && !objFile.empty() && fs::exists(objFile)) {
+				// Whatever is on disk is unusable, build it again from the source
+				LOG_WARN("Re-building binary mesh \"{}\" from \"{}\"", binFile, objFile);
+				mesh->File.Close();
+				std::lock_guard<std::mutex> lock(*GetCookLock(binFile));
+				ConvertToBinary(objFile, binFile);
+				_MapBinFile(binFile, *mesh);
+			}
+		} catch (const std::exception& e) {
+			LOG_ERROR("Failed to load mesh \"{}\": {}", objFile.empty() ? binFile : objFile, e.what());
+			mesh->File.Close();
+			mesh->Header = nullptr;
+		}
+		if (mesh->Header != nullptr) {
+			// Touch every page of the file now, so that the upload reads from memory instead of waiting on the disk
+			volatile uint8_t sink = 0;
+			for (size_t offset = 0; offset < mesh->File.Size(); offset += 4096) {
+				sink += mesh->File.Data()[offset];
+			}
+		}
+	};
+
+	VertexArrayObject::Sptr result = VertexArrayObject::Create();
+	auto upload = [vao = result.get(), mesh, binFile, startTime]() {
+		_UploadMesh(*mesh, *vao);
+
+		// Calculate and trace out how long it took us to load
+		float endTime = static_cast<float>(glfwGetTime());
+		LOG_TRACE("Loaded OBJ file \"{}\" in {} seconds ({} vertices, {} indices)", binFile, endTime - startTime, mesh->Header->NumVertices, mesh->Header->NumIndices);
+
+		// We're done with the file, the driver has its own copy now
+		mesh->File.Close();
+		mesh->Header = nullptr;
+	};
+
+	// Inside a batch the VAO is handed back empty, and gets filled in once the file is ready
+	if (AssetPipeline::IsBatching()) {
+		AssetPipeline::Enqueue(result, decode, [mesh, upload]() {
+			if (mesh->Header != nullptr) {
+				upload();
+			}
+		});
+	} else {
+		AsyncLoader::RunInBackground(decode);
+		if (mesh->Header == nullptr) {
+			return nullptr;
+		}
+		upload();
+	}
+
+	return result;
 }
 
 void OptimizedObjLoader::ConvertToBinary(const std::string& inFile, const std::string& outFile) {
 	// Load in the input file
-	MeshBuilder<VertexPosNormTexColTangents>* mesh = _LoadFromObjFile(inFile);
+	std::unique_ptr<MeshBuilder<VertexPosNormTexColTangents>> mesh(_LoadFromObjFile(inFile));
 
 	float startTime = static_cast<float>(glfwGetTime());
 
@@ -62,164 +179,52 @@ void OptimizedObjLoader::ConvertToBinary(const std::string& inFile, const std::s
 		outFileName = path.string();
 	}
 
-	// Save the mesh to the file
-	SaveBinaryFile(*mesh, outFileName);
+	// Save the mesh to the file, remembering what it was built from
+	SaveBinaryFile(*mesh, outFileName, inFile);
 
 	float endTime = static_cast<float>(glfwGetTime());
 	LOG_TRACE("Converted OBJ file to binary \"{}\" in {} seconds ({} vertices, {} indices)", inFile, endTime - startTime, mesh->GetVertexCount(), mesh->GetIndexCount());
-
-	// We no longer need the mesh data, free it
-	delete mesh;
 }
 
 MeshBuilder<VertexPosNormTexColTangents>* OptimizedObjLoader::_LoadFromObjFile(const std::string& filename) {
-	// Open our file in binary mode
-	std::ifstream file;
-	file.open(filename, std::ios::binary);
+	float startTime = static_cast<float>(glfwGetTime());
 
 	// If our file fails to open, we will throw an error
-	if (!file) {
+	ObjMeshData obj;
+	if (!ObjParser::ParseFile(filename, obj)) {
 		throw std::runtime_error("Failed to open file");
 	}
 
 	// Could also take this in as a parameter
 	glm::vec4 color = glm::vec4(1.0f);
 
-	// Our attributes
-	std::vector<glm::vec3>  positions;
-	std::vector<glm::vec3>  normals;
-	std::vector<glm::vec2>  uvs;
+	// Merge corners that share the same attributes into a single vertex
+	std::vector<uint32_t> indices;
 	std::vector<glm::ivec3> vertices;
-	std::vector<uint32_t>   indices;
+	MeshOptimizer::WeldCorners(obj.Corners, indices, vertices);
 
-	// Maps a key generated from obj indices to a vertex index that
-	// has been added to the mesh already
-	std::unordered_map<uint64_t, uint32_t> vertexMap;
+	// Reorder for the vertex cache and fetches, the corners get moved along with the indices
+	std::vector<uint32_t> remap;
+	MeshOptimizerStats stats = MeshOptimizer::OptimizeIndices(indices, vertices.size(), remap);
+	MeshOptimizer::RemapVertices(vertices, remap, stats.NumVertices);
+	LOG_INFO("Optimized \"{}\": {} corners welded to {} vertices, ACMR {:.3f} -> {:.3f}", filename, obj.Corners.size(), stats.NumVertices, stats.AcmrBefore, stats.AcmrAfter);
 
 	// We'll use the mesh builder since it supports easily adding
 	// vertices and indices
 	MeshBuilder<VertexPosNormTexColTangents>* mesh = new MeshBuilder<VertexPosNormTexColTangents>();
-
-	// Storage for temporary data
-	std::string line;
-	glm::vec3 vecData;
-	glm::ivec3 vertexIndices;
-
-	float startTime = static_cast<float>(glfwGetTime());
-
-	// Read and process the entire file
-	while (file.peek() != EOF) {
-		// Read in the first part of the line (ex: f, v, vn, etc...)
-		std::string command;
-		file >> command;
-
-		// We will ignore the rest of the line for comment lines
-		if (command == "#") {
-			std::getline(file, line);
-		}
-
-		// The v command defines a vertex's position
-		else if (command == "v") {
-			// Read in and store a position
-			file >> vecData.x >> vecData.y >> vecData.z;
-			positions.push_back(vecData);
-		}
-		// TODO: handle normals and textures
-		else if (command == "vn") {
-			// Read in and store a position
-			file >> vecData.x >> vecData.y >> vecData.z;
-			normals.push_back(vecData);
-		} else if (command == "vt") {
-			// Read in and store a position
-			file >> vecData.x >> vecData.y;
-			uvs.push_back(vecData);
-		}
-
-		// The f command defines a polygon in the mesh
-		// NOTE: make sure you triangulate in blender, otherwise it will
-		// output quads instead of triangles
-		else if (command == "f") {
-			// Read the rest of the line from the file
-			std::getline(file, line);
-			// Trim whitespace from either end of the line
-			StringTools::Trim(line);
-			// Create a string stream so we can use streaming operators on it
-			std::stringstream stream = std::stringstream(line);
-
-			uint32_t edges[4];
-			int ix = 0;
-			// Iterate over up to 4 sets of attributes
-			for (; ix < 4; ix++) {
-				if (stream.peek() != EOF) {
-					// Load in the faces, split up by slashes
-					char tempChar;
-					vertexIndices = glm::ivec3(0);
-					stream >> vertexIndices.x >> tempChar >> vertexIndices.y >> tempChar >> vertexIndices.z;
-					// The OBJ format can have negative values, which are a reference from the last added attributes
-					if (vertexIndices.x < 0) { vertexIndices.x = positions.size() + 1 + vertexIndices.x; }
-					if (vertexIndices.y < 0) { vertexIndices.y = uvs.size()       + 1 + vertexIndices.y; }
-					if (vertexIndices.z < 0) { vertexIndices.z = normals.size()   + 1 + vertexIndices.z; }
-
-					// We can construct a key using a bitmask of the attribute indices
-					// This let's us quickly look up a combination of attributes to see if it's already been added
-					// Note that this limits us to 2,097,150 unique attributes for positions, normals and textures
-					const uint64_t mask = 0b0'000000000000000000000'000000000000000000000'111111111111111111111;
-					uint64_t key = ((vertexIndices.x & mask) << 42) | ((vertexIndices.y & mask) << 21) | (vertexIndices.z & mask);
-
-					// Find the index associated with the combination of attributes
-					auto it = vertexMap.find(key);
-
-					// If it exists, we push the index to our indices
-					if (it != vertexMap.end()) {
-						edges[ix] = it->second;
-					} else {
-						vertices.push_back(vertexIndices - glm::ivec3(1));
-						uint32_t index = static_cast<uint32_t>(vertices.size()) - 1;
-
-						// Cache the index based on our key
-						vertexMap[key] = index;
-						// Add index to mesh, and add to edges list for if we are using quads
-						edges[ix] = index;
-					}
-				}
-				// We've reached the end of the line, break out of the loop
-				else { break; }
-			}
-
-			// Handling for triangle faces
-			if (ix == 3) {
-				indices.push_back(edges[0]);
-				indices.push_back(edges[1]);
-				indices.push_back(edges[2]);
-			}
-			// Handling for quad faces
-			else if (ix == 4) {
-				indices.push_back(edges[0]);
-				indices.push_back(edges[1]);
-				indices.push_back(edges[2]);
-
-				indices.push_back(edges[0]);
-				indices.push_back(edges[2]);
-				indices.push_back(edges[3]);
-			}
-		}
-	}
-
 	mesh->ReserveVertexSpace(vertices.size());
-	for (const auto& vertexIndices : vertices) {
-		// Construct a new vertex using the indices for the vertex
+	mesh->ReserveIndexSpace(indices.size());
+
+	for (const glm::ivec3& corner : vertices) {
 		VertexPosNormTexColTangents vertex;
-		vertex.Position = positions[vertexIndices.x];
-		vertex.UV       = vertexIndices.y != 0 ? uvs[vertexIndices.y] : glm::vec2(0.0f);
-		vertex.Normal   = vertexIndices.z != 0 ? normals[vertexIndices.z] : glm::vec3(0.0f, 0.0f, 1.0f);
+		vertex.Position = obj.GetPosition(corner);
+		vertex.UV       = obj.GetUV(corner);
+		vertex.Normal   = obj.GetNormal(corner);
 		vertex.Color    = color;
-
-		// Add to the mesh, get index of the added vertex
 		mesh->AddVertex(vertex);
 	}
-	mesh->ReserveIndexSpace(indices.size());
-	for (uint32_t ix : indices) {
-		mesh->AddIndex(ix);
+	for (uint32_t index : indices) {
+		mesh->AddIndex(index);
 	}
 
 	// Calculate our tangents
@@ -233,96 +238,209 @@ MeshBuilder<VertexPosNormTexColTangents>* OptimizedObjLoader::_LoadFromObjFile(c
 	return mesh;
 }
 
-VertexArrayObject::Sptr OptimizedObjLoader::_LoadFromBinFile(const std::string& filename) {
+void OptimizedObjLoader::_StampSource(const std::string& sourceFile, BinaryHeader& header) {
+	std::error_code error;
+	header.SourceSize = static_cast<uint64_t>(fs::file_size(sourceFile, error));
+	header.SourceTime = GetModifiedTime(sourceFile);
+	header.SourceHash = HashFile(sourceFile);
+}
 
-	// Open the output file
-	std::ifstream file(filename, std::ios::binary);
-	// If our file fails to open, we will throw an error
-	if (!file) { throw std::runtime_error("Failed to open file"); }
+void OptimizedObjLoader::_WriteBinaryFile(const std::string& outFilename, BinaryHeader& header, const std::vector<BufferAttribute>& vDecl, const void* indices, const void* vertices) {
+	// Write to a temporary file and swap it in at the end, so an interrupted write never leaves a
+	// file with a valid header and missing data behind
+	const std::string tempFilename = outFilename + ".tmp";
+	std::ofstream file(tempFilename, std::ios::binary | std::ios::trunc);
+	if (!file) {
+		throw std::runtime_error("Failed to open output file");
+	}
 
-	float startTime = static_cast<float>(glfwGetTime());
+	// Store the bounds, so loading never needs to read the vertices back
+	for (const BufferAttribute& attrib : vDecl) {
+		if (attrib.Usage == AttribUsage::Position) {
+			Bounds bounds = Bounds::FromPoints(reinterpret_cast<const uint8_t*>(vertices) + attrib.Offset, header.NumVertices, header.VertexStride);
+			memcpy(header.BoundsMin, &bounds.Min, sizeof(header.BoundsMin));
+			memcpy(header.BoundsMax, &bounds.Max, sizeof(header.BoundsMax));
+			header.BoundsRadius = bounds.Radius;
+			break;
+		}
+	}
 
-	// Get the file size so we can avoid reading past the end
-	file.seekg(0, std::ios::end);
-	size_t size = file.tellg();
-	file.seekg(0, std::ios::beg);
+	// Lay out the sections after the header, each starting on an aligned boundary
+	header.Attributes.Offset = AlignOffset(sizeof(BinaryHeader), BINARY_ALIGNMENT);
+	header.Attributes.Size   = header.NumAttributes * sizeof(BufferAttribute);
+	header.Indices.Offset    = AlignOffset((size_t)header.Attributes.Offset + header.Attributes.Size, BINARY_ALIGNMENT);
+	header.Indices.Size      = header.NumIndices * static_cast<uint32_t>(GetIndexTypeSize(header.IndicesType));
+	header.Vertices.Offset   = AlignOffset((size_t)header.Indices.Offset + header.Indices.Size, BINARY_ALIGNMENT);
+	header.Vertices.Size     = header.NumVertices * header.VertexStride;
+
+	// Pads the file out to where the section starts, then writes it
+	const char padding[BINARY_ALIGNMENT] = { 0 };
+	auto writeSection = [&](const BinarySection& section, const void* data) {
+		size_t position = static_cast<size_t>(file.tellp());
+		file.write(padding, section.Offset - position);
+		if (section.Size > 0) {
+			file.write(reinterpret_cast<const char*>(data), section.Size);
+		}
+	};
+
+	// Write header bytes to the stream
+	file.write(reinterpret_cast<const char*>(&header), sizeof(BinaryHeader));
+	// Write which attributes we have to the stream
+	writeSection(header.Attributes, vDecl.data());
+	// Write any index data to the file
+	writeSection(header.Indices, indices);
+	// Write vertex data to file
+	writeSection(header.Vertices, vertices);
+
+	file.close();
+	std::error_code error;
+	if (!file) {
+		fs::remove(tempFilename, error);
+		throw std::runtime_error("Failed to write output file");
+	}
+	fs::rename(tempFilename, outFilename, error);
+	if (error) {
+		fs::remove(tempFilename, error);
+		throw std::runtime_error("Failed to replace output file");
+	}
+}
 
-	// Read the header from the file
-	BinaryHeader header = BinaryHeader();
-	if (size >= sizeof(BinaryHeader)) {
-		file.read(reinterpret_cast<char*>(&header), sizeof(BinaryHeader));
-	} else {
-		LOG_ERROR("Not enough data in the file!");
-		return nullptr;
+void OptimizedObjLoader::_CookObjFile(const std::string& objFile, const std::string& binFile) {
+	std::lock_guard<std::mutex> lock(*GetCookLock(binFile));
+	if (!_IsBinaryCurrent(objFile, binFile)) {
+		ConvertToBinary(objFile, binFile);
 	}
+}
 
-	// TODO: validate header
+bool OptimizedObjLoader::_IsBinaryCurrent(const std::string& objFile, const std::string& binFile) {
+	std::error_code error;
+	if (!fs::exists(binFile, error)) {
+		return false;
+	}
 
-	// Handle our version
-	if (header.Version == 0x01) {
-		// Determine how many bytes we need in the file
-		size_t requiredBytes =
-			sizeof(BinaryHeader) +
-			(header.NumAttributes * sizeof(BufferAttribute)) +
-			(header.VertexStride * (size_t)header.NumVertices) +
-			(header.NumIndices * GetIndexTypeSize(header.IndicesType));
+	// We only need the header to decide, no need to map the whole thing
+	std::ifstream file(binFile, std::ios::binary);
+	BinaryHeader header;
+	if (!file.read(reinterpret_cast<char*>(&header), sizeof(BinaryHeader))) {
+		return false;
+	}
+	file.close();
 
-		// Make sure there's enough data in the file
-		if (size < requiredBytes) {
-			LOG_ERROR("Not enough data in the file!");
-			return nullptr;
-		}
+	if (memcmp(header.HeaderBytes, HEADER_BYTES, sizeof(HEADER_BYTES)) != 0 || header.Version != BINARY_VERSION) {
+		LOG_INFO("Binary mesh \"{}\" is from an older version, re-building it", binFile);
+		return false;
+	}
 
-		// Read all attributes from the file, this is basically our VDECL
-		std::vector<BufferAttribute> vertexDeclaration;
-		vertexDeclaration.resize(header.NumAttributes);
-		for (int ix = 0; ix < header.NumAttributes; ix++) {
-			file.read(reinterpret_cast<char*>(&vertexDeclaration[ix]), sizeof(BufferAttribute));
-		}
+	// The vertices are the last section, if the file doesn't reach the end of them it was cut off
+	uintmax_t binarySize = fs::file_size(binFile, error);
+	if (error || static_cast<uintmax_t>(header.Vertices.Offset) + header.Vertices.Size > binarySize) {
+		LOG_WARN("Binary mesh \"{}\" is truncated, re-building it", binFile);
+		return false;
+	}
 
-		// These will have the buffer pointers
-		IndexBuffer::Sptr indices = nullptr;
-		VertexBuffer::Sptr vertices = nullptr;
-
-		// If we have index data, load it
-		if (header.NumIndices > 0) {
-			// Create index buffer
-			indices = IndexBuffer::Create(BufferUsage::StaticDraw);
-
-			// Create memory to store indices, then read from the file
-			void* dataStore = malloc(header.NumIndices * GetIndexTypeSize(header.IndicesType));
-			file.read(reinterpret_cast<char*>(dataStore), header.NumIndices * GetIndexTypeSize(header.IndicesType));
-			
-			// Load data into OpenGL and free the CPU memory we allocated
-			indices->LoadData(dataStore, GetIndexTypeSize(header.IndicesType), header.NumIndices, header.IndicesType);
-			free(dataStore);
-		}
+	// Without the source there's nothing to re-build from, so the binary file is as current as it gets
+	if (!fs::exists(objFile, error)) {
+		return true;
+	}
 
-		// Create a new VBO
-		vertices = VertexBuffer::Create(BufferUsage::StaticDraw);
+	uint64_t sourceSize = static_cast<uint64_t>(fs::file_size(objFile, error));
+	if (header.SourceSize != sourceSize) {
+		return false;
+	}
+	int64_t sourceTime = GetModifiedTime(objFile);
+	if (header.SourceTime == sourceTime) {
+		return true;
+	}
 
-		// Create memory to store vertices and load from file
-		void* vertexStore = malloc(header.NumVertices * (size_t)header.VertexStride);
-		file.read(reinterpret_cast<char*>(vertexStore), header.NumVertices * (size_t)header.VertexStride);
+	// The OBJ was touched but may not have actually changed (ex: a fresh checkout), so compare the contents
+	if (header.SourceHash != HashFile(objFile)) {
+		return false;
+	}
 
-		// Load data into OpenGL and free the CPU copy
-		vertices->LoadData(vertexStore, header.VertexStride, header.NumVertices);
-		free(vertexStore);
+	// Still the same mesh, update the time so we don't need to hash it again next time
+	header.SourceTime = sourceTime;
+	std::fstream stamp(binFile, std::ios::binary | std::ios::in | std::ios::out);
+	if (stamp) {
+		stamp.write(reinterpret_cast<const char*>(&header), sizeof(BinaryHeader));
+	}
+	return true;
+}
 
-		// Create the VAO and attach our index and vertex buffers
-		VertexArrayObject::Sptr result = VertexArrayObject::Create();
-		result->SetIndexBuffer(indices);
-		result->AddVertexBuffer(vertices, vertexDeclaration);
+bool OptimizedObjLoader::_MapBinFile(const std::string& filename, MappedMesh& result) {
+	result.Header = nullptr;
+	if (!result.File.Open(filename)) {
+		LOG_ERROR("Failed to open binary mesh \"{}\"", filename);
+		return false;
+	}
 
-		// Copy in the vertex declaration we loaded
-		result->SetVDecl(vertexDeclaration);
+	// Don't keep a rejected file open, we'd hold a lock on it and it could never be re-built
+	auto reject = [&result]() {
+		result.File.Close();
+		return false;
+	};
 
-		// Calculate and trace out how long it took us to load
-		float endTime = static_cast<float>(glfwGetTime());
-		LOG_TRACE("Loaded OBJ file \"{}\" in {} seconds ({} vertices, {} indices)", filename, endTime - startTime, header.NumVertices, header.NumIndices);
+	const size_t size = result.File.Size();
+	if (size < sizeof(BinaryHeader)) {
+		LOG_ERROR("Not enough data in the file!");
+		return reject();
+	}
 
-		return result;
+	const BinaryHeader& header = *reinterpret_cast<const BinaryHeader*>(result.File.Data());
+	if (memcmp(header.HeaderBytes, HEADER_BYTES, sizeof(HEADER_BYTES)) != 0) {
+		LOG_ERROR("\"{}\" is not a binary mesh", filename);
+		return reject();
+	}
+	if (header.Version != BINARY_VERSION) {
+		LOG_WARN("Binary mesh \"{}\" is version {}, expected version {}", filename, header.Version, BINARY_VERSION);
+		return reject();
+	}
+
+	// Make sure every section is where the loader expects it, and actually fits in the file
+	auto isSectionValid = [size](const BinarySection& section, size_t expectedSize) {
+		return section.Offset % BINARY_ALIGNMENT == 0 && section.Size == expectedSize &&
+			static_cast<size_t>(section.Offset) + section.Size <= size;
+	};
+	if (!isSectionValid(header.Attributes, (size_t)header.NumAttributes * sizeof(BufferAttribute)) ||
+		!isSectionValid(header.Indices, (size_t)header.NumIndices * GetIndexTypeSize(header.IndicesType)) ||
+		!isSectionValid(header.Vertices, (size_t)header.NumVertices * header.VertexStride)) {
+		LOG_ERROR("Binary mesh \"{}\" is truncated or corrupt", filename);
+		return reject();
 	}
 
-	return nullptr;
+	result.Header = &header;
+	return true;
+}
+
+void OptimizedObjLoader::_UploadMesh(const MappedMesh& mesh, VertexArrayObject& result) {
+	const BinaryHeader& header = *mesh.Header;
+	const uint8_t* data = mesh.File.Data();
+
+	// Read all attributes from the file, this is basically our VDECL
+	const BufferAttribute* attributes = reinterpret_cast<const BufferAttribute*>(data + header.Attributes.Offset);
+	VertexArrayObject::VertexDeclaration vertexDeclaration(attributes, attributes + header.NumAttributes);
+
+	// The index and vertex data go straight from the mapped file into immutable storage, no copies on our end
+	IndexBuffer::Sptr indices = nullptr;
+	if (header.NumIndices > 0) {
+		indices = IndexBuffer::Create(BufferUsage::StaticDraw);
+		indices->LoadImmutableData(data + header.Indices.Offset, static_cast<uint32_t>(GetIndexTypeSize(header.IndicesType)), header.NumIndices, header.IndicesType);
+	}
+
+	VertexBuffer::Sptr vertices = VertexBuffer::Create(BufferUsage::StaticDraw);
+	vertices->LoadImmutableData(data + header.Vertices.Offset, header.VertexStride, header.NumVertices);
+
+	// The bounds were calculated when the file was built
+	Bounds bounds;
+	memcpy(&bounds.Min, header.BoundsMin, sizeof(header.BoundsMin));
+	memcpy(&bounds.Max, header.BoundsMax, sizeof(header.BoundsMax));
+	bounds.Center = (bounds.Min + bounds.Max) * 0.5f;
+	bounds.Radius = header.BoundsRadius;
+
+	// Attach our index and vertex buffers
+	result.SetIndexBuffer(indices);
+	result.AddVertexBuffer(vertices, vertexDeclaration);
+
+	// Copy in the vertex declaration we loaded
+	result.SetVDecl(vertexDeclaration);
+	result.SetBounds(bounds);
 }
@@ -12,16 +12,26 @@
 #include "Graphics/VertexTypes.h"
 
 #include "Utils/MeshBuilder.h"
+#include "Utils/MeshOptimizer.h"
 
 /// <summary>
 /// An optimized OBJ loader that can convert an OBJ file to a binary representation
 /// that we can load significantly faster
+///
+/// The binary file is a header followed by sections, each starting on a BINARY_ALIGNMENT boundary
+/// so that they can be handed to OpenGL straight from a memory mapped file:
+///   Attributes - NumAttributes BufferAttribute records (the VDECL)
+///   Indices    - NumIndices indices of type IndicesType, 16 bit whenever the vertex count allows it
+///   Vertices   - NumVertices vertices, VertexStride bytes each
 /// </summary>
 class OptimizedObjLoader {
 public:
 	/// <summary>
 	/// Loads a VAO from an OBJ file. On the first time this is called for an OBJ file, will convert the OBJ file 
-	/// to a binary file and load that instead. On subsequent runs, the binary file will be loaded instead
+	/// to a binary file and load that instead. On subsequent runs, the binary file will be loaded instead, and it
+	/// is re-built automatically whenever the OBJ file changes
+	///
+	/// While an AssetPipeline batch is open, the VAO is returned empty and gets filled in once the batch uploads it
 	/// </summary>
 	/// <param name="filename">The path to the .obj or .bin file to load</param>
 	/// <returns>A VAO loaded from disk</returns>
@@ -39,64 +49,110 @@ public:
 	/// <typeparam name="VertexType"></typeparam>
 	/// <param name="mesh"></param>
 	/// <param name="outFilename"></param>
+	/// <param name="sourceFile">The file the mesh was built from, if any, the binary file is considered stale once it changes</param>
 	template <typename VertexType>
-	static void SaveBinaryFile(MeshBuilder<VertexType>& mesh, const std::string& outFilename);
+	static void SaveBinaryFile(MeshBuilder<VertexType>& mesh, const std::string& outFilename, const std::string& sourceFile = "");
 
 protected:
+	// The version code, files with a different version are rejected and re-built from their OBJ file
+	static constexpr uint16_t BINARY_VERSION = 3;
+	static constexpr uint32_t BINARY_ALIGNMENT = 16;
+
+	// A range of bytes within the file
+	struct BinarySection {
+		uint32_t Offset = 0;
+		uint32_t Size   = 0;
+	};
+
 	// Will be put at the start of the binary file, contains info about the contents of the file
 	struct BinaryHeader {
 		// A check value so we can ensure that we're loading in the right file type
 		char      HeaderBytes[4] ={ 'B', 'O', 'B', 'J' };
 		// The version code, we can use this to create different loaders if our format changes
-		uint16_t  Version = 0;
+		uint16_t  Version = BINARY_VERSION;
+		// The size of a single vertex structure
+		uint16_t  VertexStride = 0;
 		// The number of indices in the mesh
 		uint32_t  NumIndices = 0;
 		// The type of index to load
 		IndexType IndicesType = IndexType::Unknown;
 		// The number of vertices in the mesh
 		uint32_t  NumVertices = 0;
-		// The size of a single vertex structure
-		uint16_t  VertexStride = 0;
 		// The number of vertex attributes (basically how many VDECL entries there are)
-		uint8_t   NumAttributes = 0;
+		uint32_t  NumAttributes = 0;
+
+		// The size, modified time and FNV-1a hash of the file this was built from, used to detect stale files
+		uint64_t  SourceSize = 0;
+		int64_t   SourceTime = 0;
+		uint64_t  SourceHash = 0;
+
+		// The model space bounds of the vertices, so we don't need to read them back to calculate it
+		float     BoundsMin[3] ={ 0.0f, 0.0f, 0.0f };
+		float     BoundsMax[3] ={ 0.0f, 0.0f, 0.0f };
+		float     BoundsRadius = -1.0f;
+
+		BinarySection Attributes;
+		BinarySection Indices;
+		BinarySection Vertices;
 	};
 
+	// A binary file that has been mapped and validated, but not uploaded yet
+	struct MappedMesh;
+
 	OptimizedObjLoader() = default;
 	~OptimizedObjLoader() = default;
 
 	static MeshBuilder<VertexPosNormTexColTangents>* _LoadFromObjFile(const std::string& filename);
-	static VertexArrayObject::Sptr _LoadFromBinFile(const std::string& filename);
+
+	/// <summary>
+	/// Fills in the source fields of the header from the file at the given path
+	/// </summary>
+	static void _StampSource(const std::string& sourceFile, BinaryHeader& header);
+	/// <summary>
+	/// Writes a binary file, filling in the bounds and section layout of the header
+	/// </summary>
+	static void _WriteBinaryFile(const std::string& outFilename, BinaryHeader& header, const std::vector<BufferAttribute>& vDecl, const void* indices, const void* vertices);
+
+	/// <summary>
+	/// Makes sure the binary file for an OBJ file exists and is up to date, re-building it if needed. Does not
+	/// touch the GL context, so it can be run on any thread
+	/// </summary>
+	static void _CookObjFile(const std::string& objFile, const std::string& binFile);
+	/// <summary>
+	/// Returns true if the binary file exists, has the current version, and was built from the OBJ file as it is now
+	/// </summary>
+	static bool _IsBinaryCurrent(const std::string& objFile, const std::string& binFile);
+	/// <summary>
+	/// Maps and validates a binary file, does not touch the GL context so it can be run on any thread
+	/// </summary>
+	static bool _MapBinFile(const std::string& filename, MappedMesh& result);
+	/// <summary>
+	/// Creates the buffers for a mapped binary file and attaches them to the VAO
+	/// </summary>
+	static void _UploadMesh(const MappedMesh& mesh, VertexArrayObject& result);
 };
 
 template <typename VertexType>
-void OptimizedObjLoader::SaveBinaryFile(MeshBuilder<VertexType>& mesh, const std::string& outFilename) {
-	// Open the output file
-	std::ofstream file(outFilename, std::ios::binary);
-	if (!file) {
-		throw std::runtime_error("Failed to open output file");
-	}
-
+void OptimizedObjLoader::SaveBinaryFile(MeshBuilder<VertexType>& mesh, const std::string& outFilename, const std::string& sourceFile) {
 	// Create the fixed size header for our output file
 	BinaryHeader header  = BinaryHeader();
-	header.Version       = 0x01; // This is version 1! Update this and implement different readers if changes to format are made
 	header.NumIndices    = mesh.GetIndexCount();
 	header.IndicesType   = IndexType::UInt;
 	header.NumVertices   = mesh.GetVertexCount();
 	header.VertexStride  = sizeof(VertexType);
-	header.NumAttributes = VertexType::V_DECL.size();
-
-	// Write header bytes to the stream
-	file.write(reinterpret_cast<const char*>(&header), sizeof(BinaryHeader));
+	header.NumAttributes = static_cast<uint32_t>(VertexType::V_DECL.size());
 
-	// Write which attributes we have to the stream
-	for (int ix = 0; ix < VertexType::V_DECL.size(); ix++) {
-		file.write(reinterpret_cast<const char*>(&VertexType::V_DECL[ix]), sizeof(BufferAttribute));
+	if (!sourceFile.empty()) {
+		_StampSource(sourceFile, header);
 	}
-	// Write any index data to the file
-	if (mesh.GetIndexCount() > 0) {
-		file.write(reinterpret_cast<const char*>(mesh.GetIndexDataPtr()), mesh.GetIndexCount() * sizeof(uint32_t));
+
+	// Use 16 bit indices whenever they can address every vertex, halving the size of the index buffer
+	std::vector<uint16_t> shortIndices;
+	const void* indices = mesh.GetIndexDataPtr();
+	if (MeshOptimizer::NarrowIndices(mesh.GetIndexDataPtr(), mesh.GetIndexCount(), mesh.GetVertexCount(), shortIndices)) {
+		header.IndicesType = IndexType::UShort;
+		indices = shortIndices.data();
 	}
 
-	// Write vertex data to file
-	file.write(reinterpret_cast<const char*>(mesh.GetVertexDataPtr()), mesh.GetVertexCount() * sizeof(VertexType));
+	_WriteBinaryFile(outFilename, header, VertexType::V_DECL, indices, mesh.GetVertexDataPtr());
 }
@@ -1,5 +1,8 @@
 #include "Utils/ResourceManager/ResourceManager.h"
 
+#include <algorithm>
+#include <filesystem>
+
 #include "Utils/ObjLoader.h"
 #include "Utils/FileHelpers.h"
 #include "Utils/StringUtils.h"
@@ -8,6 +11,7 @@ std::map<std::type_index, std::map<Guid, IResource::Sptr>> ResourceManager::_res
 std::map<std::string, std::function<Guid(const nlohmann::json&)>> ResourceManager::_typeLoaders;
 
 nlohmann::ordered_json ResourceManager::_manifest;
+std::map<std::type_index, std::unordered_map<std::string, std::weak_ptr<IResource>>> ResourceManager::_assetCache;
 
 void ResourceManager::Init() {
 	// TODO: initialize the resource manager once it's a bit more complex
@@ -56,5 +60,58 @@ void ResourceManager::Cleanup() {
 	for (auto& [type, map] : _resources) {
 		map.clear();
 	}
+	_assetCache.clear();
+}
+
+bool ResourceManager::_AppendCacheKey(std::string& key, const char* path) {
+	return path != nullptr && _AppendCacheKey(key, std::string(path));
+}
+
+bool ResourceManager::_AppendCacheKey(std::string& key, const std::string& path) {
+	key += "|" + _NormalizePath(path);
+	return true;
+}
+
+bool ResourceManager::_AppendCacheKey(std::string& key, const Texture2DDescription& description) {
+	// Descriptions without a file are filled in by whoever created them, so they can't be shared
+	if (description.Filename.empty()) {
+		return false;
+	}
+
+	_AppendCacheKey(key, description.Filename);
+	key += "|" + std::to_string(*description.Format) +
+		"|" + std::to_string(*description.HorizontalWrap) +
+		"|" + std::to_string(*description.VerticalWrap) +
+		"|" + std::to_string(*description.MinificationFilter) +
+		"|" + std::to_string(*description.MagnificationFilter) +
+		"|" + std::to_string(description.MaxAnisotropic) +
+		"|" + std::to_string(description.GenerateMipMaps) +
+		"|" + std::to_string(description.MultisampleCount) +
+		"|" + std::to_string(*description.FormatHint);
+	return true;
+}
+
+bool ResourceManager::_AppendCacheKey(std::string& key, const std::unordered_map<ShaderPartType, std::string>& filePaths) {
+	// Unordered maps don't have a stable order, so sort the parts by stage first
+	std::vector<std::pair<int, std::string>> parts;
+	parts.reserve(filePaths.size());
+	for (const auto& [type, path] : filePaths) {
+		parts.emplace_back(static_cast<int>(*type), _NormalizePath(path));
+	}
+	std::sort(parts.begin(), parts.end());
+
+	for (const auto& [type, path] : parts) {
+		key += "|" + std::to_string(type) + ":" + path;
+	}
+	return true;
+}
+
+std::string ResourceManager::_NormalizePath(const std::string& path) {
+	std::string result = std::filesystem::path(path).lexically_normal().generic_string();
+	#ifdef _WIN32
+	// Paths on windows aren't case sensitive
+	std::transform(result.begin(), result.end(), result.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+	#endif
+	return result;
 }
 
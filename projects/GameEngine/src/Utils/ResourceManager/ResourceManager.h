@@ -9,6 +9,7 @@
 #include "Graphics/ShaderProgram.h"
 #include "Gameplay/Material.h"
 
+#include "Utils/AsyncLoader.h"
 #include "Utils/GUID.hpp"
 #include "Utils/ResourceManager/IResource.h"
 #include "Utils/StringUtils.h"
@@ -27,6 +28,11 @@ public:
 
 	/// <summary>
 	/// Creates a new asset, and forwards the arguments to it's constructor
+	/// 
+	/// Assets that are loaded from files (meshes, textures, shaders, fonts) are shared, if an asset of
+	/// the same type was already created from the same file with the same load parameters, that asset is
+	/// returned instead of loading the file again. Since the asset is shared, changes made to it will be
+	/// seen by everything using it, use CreateUniqueAsset to get a copy that can be changed on its own
 	/// </summary>
 	/// <typeparam name="T">The type of asset to create</typeparam>
 	/// <typeparam name="...TArgs">The types for the arguments to forward to the constructor</typeparam>
@@ -34,6 +40,35 @@ public:
 	/// <returns>The GUID of the newly created asset</returns>
 	template <typename T, typename ... TArgs, typename = std::enable_if<is_valid_resource<T>()>::type>
 	static std::shared_ptr<T> CreateAsset(TArgs&&... args) {
+		std::string key = _GetCacheKey(args...);
+		if (key.empty()) {
+			return CreateUniqueAsset<T>(std::forward<TArgs>(args)...);
+		}
+
+		// The cache only holds weak references, so it never keeps an asset alive by itself
+		std::weak_ptr<IResource>& cached = _assetCache[std::type_index(typeid(T))][key];
+		std::shared_ptr<T> result = std::dynamic_pointer_cast<T>(cached.lock());
+		if (result == nullptr) {
+			result = CreateUniqueAsset<T>(std::forward<TArgs>(args)...);
+			cached = result;
+		}
+		return result;
+	}
+
+	/// <summary>
+	/// Creates a new asset, and forwards the arguments to it's constructor. Unlike CreateAsset, this will
+	/// always create a new copy of the asset, even if the same file has already been loaded. Use this for
+	/// assets that will be modified after loading, like meshes that are morph animated
+	/// </summary>
+	/// <typeparam name="T">The type of asset to create</typeparam>
+	/// <typeparam name="...TArgs">The types for the arguments to forward to the constructor</typeparam>
+	/// <param name="...args">The arguments to forward to the constructor</param>
+	/// <returns>The newly created asset</returns>
+	template <typename T, typename ... TArgs, typename = std::enable_if<is_valid_resource<T>()>::type>
+	static std::shared_ptr<T> CreateUniqueAsset(TArgs&&... args) {
+		// Loading assets is slow, give the frame a chance to run if we're part of a background load
+		AsyncLoader::YieldIfOverBudget();
+
 		// Create and store the asset
 		std::shared_ptr<T> asset = std::make_shared<T>(std::forward<TArgs>(args)...);
 		_resources[std::type_index(typeid(T))][asset->IResource::GetGUID()] = asset;
@@ -169,4 +204,43 @@ protected:
 	/// This allows us to register dependencies before the dependent resource
 	/// </summary>
 	static nlohmann::ordered_json _manifest;
+
+	/// <summary>
+	/// Maps the type of an asset and the key for the file and parameters it was loaded with to
+	/// the asset, see CreateAsset
+	/// </summary>
+	static std::map<std::type_index, std::unordered_map<std::string, std::weak_ptr<IResource>>> _assetCache;
+
+	/// <summary>
+	/// Builds the cache key for the arguments an asset is being created with, or returns an empty string
+	/// if any of the arguments can't be part of a key (in which case the asset is never shared)
+	/// </summary>
+	template <typename ... TArgs>
+	static std::string _GetCacheKey(const TArgs&... args) {
+		std::string result;
+		bool isCacheable = (_AppendCacheKey(result, args) && ...);
+		return isCacheable ? result : std::string();
+	}
+
+	// Anything we don't know how to describe means the asset can't be shared (materials, framebuffers, etc...)
+	template <typename T>
+	static bool _AppendCacheKey(std::string& key, const T& value) {
+		if constexpr (std::is_arithmetic<T>::value) {
+			key += "|" + std::to_string(value);
+			return true;
+		} else {
+			return false;
+		}
+	}
+	template <size_t N>
+	static bool _AppendCacheKey(std::string& key, const char(&path)[N]) {
+		return _AppendCacheKey(key, std::string(path));
+	}
+	static bool _AppendCacheKey(std::string& key, const char* path);
+	static bool _AppendCacheKey(std::string& key, const std::string& path);
+	static bool _AppendCacheKey(std::string& key, const Texture2DDescription& description);
+	static bool _AppendCacheKey(std::string& key, const std::unordered_map<ShaderPartType, std::string>& filePaths);
+
+	// Normalizes a file path, so that different ways of spelling the same path produce the same key
+	static std::string _NormalizePath(const std::string& path);
 };
\ No newline at end of file